@@ -0,0 +1,26 @@
+TEMPLATE = app
+TARGET = qubuntuone-benchmark
+INSTALLS += target
+
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../../src
+
+QT -= gui
+
+# The parsers and the OAuth signer are compiled in directly so that
+# internal classes can be measured without being exported from the library.
+HEADERS += \
+    $$files(src/*.h) \
+    ../../src/json.h \
+    ../../src/oauth.h
+
+SOURCES += \
+    $$files(src/*.cpp) \
+    ../../src/json.cpp \
+    ../../src/oauth.cpp
+
+unix {
+    target.path = /opt/qubuntuone/bin
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "allocationcounter.h"
+#include <new>
+#include <stdlib.h>
+
+#if __cplusplus >= 201103L
+#define NEW_THROWS
+#define DELETE_THROWS noexcept
+#else
+#define NEW_THROWS throw(std::bad_alloc)
+#define DELETE_THROWS throw()
+#endif
+
+// The benchmark is single-threaded, so a plain counter is sufficient.
+static qint64 allocations = 0;
+
+qint64 allocationCount() {
+    return allocations;
+}
+
+#ifdef __GLIBC__
+// QString, QByteArray and the Qt containers allocate their data with malloc
+// and realloc rather than operator new, so the C allocator is counted too.
+// operator new is implemented with malloc, and is counted there.
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void *p, size_t size);
+
+void* malloc(size_t size) __THROW {
+    allocations++;
+
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) __THROW {
+    allocations++;
+
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void *p, size_t size) __THROW {
+    allocations++;
+
+    return __libc_realloc(p, size);
+}
+
+}
+
+bool allocationCountIncludesMalloc() {
+    return true;
+}
+#else
+bool allocationCountIncludesMalloc() {
+    return false;
+}
+#endif
+
+void* operator new(size_t size) NEW_THROWS {
+#ifndef __GLIBC__
+    allocations++;
+#endif
+
+    void *p = malloc(size ? size : 1);
+
+    if (!p) {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+void* operator new[](size_t size) NEW_THROWS {
+    return operator new(size);
+}
+
+void operator delete(void *p) DELETE_THROWS {
+    free(p);
+}
+
+void operator delete[](void *p) DELETE_THROWS {
+    free(p);
+}
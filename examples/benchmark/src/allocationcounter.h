@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+/**
+ * Returns the number of heap allocations made by the process so far.
+ *
+ * With glibc, calls to malloc(), calloc() and realloc() are counted, which
+ * includes the data of Qt's strings and containers. Elsewhere, only calls
+ * to operator new are counted.
+ */
+qint64 allocationCount();
+
+/**
+ * Returns true if allocationCount() includes calls to malloc(), calloc() and realloc().
+ */
+bool allocationCountIncludesMalloc();
+
+#endif // ALLOCATIONCOUNTER_H
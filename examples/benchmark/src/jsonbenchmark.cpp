@@ -0,0 +1,456 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "jsonbenchmark.h"
+#include "allocationcounter.h"
+#include "json.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+
+using namespace QtJson;
+
+static const int CHUNK_SIZE = 16384;
+
+/**
+ * Rebuilds the document reported by JsonStreamParser as a QVariant tree,
+ * so that the output can be compared with the other parsers.
+ */
+class TreeBuilder : public JsonHandler
+{
+
+public:
+    void startObject() {
+        Container container;
+        container.isObject = true;
+        m_stack.append(container);
+    }
+
+    void endObject() {
+        this->close();
+    }
+
+    void startArray() {
+        Container container;
+        container.isObject = false;
+        m_stack.append(container);
+    }
+
+    void endArray() {
+        this->close();
+    }
+
+    void key(const QString &key) {
+        m_stack.last().key = key;
+    }
+
+    void value(const QVariant &value) {
+        if (m_stack.isEmpty()) {
+            m_result = value;
+        }
+        else if (m_stack.last().isObject) {
+            m_stack.last().map.insert(m_stack.last().key, value);
+        }
+        else {
+            m_stack.last().list.append(value);
+        }
+    }
+
+    QVariant result() const {
+        return m_result;
+    }
+
+private:
+    struct Container {
+        bool isObject;
+        QString key;
+        QVariantMap map;
+        QVariantList list;
+    };
+
+    void close() {
+        Container container = m_stack.takeLast();
+        this->value(container.isObject ? QVariant(container.map) : QVariant(container.list));
+    }
+
+    QList<Container> m_stack;
+
+    QVariant m_result;
+};
+
+/**
+ * Counts the items of a list response, as the list classes do.
+ */
+class ItemCounter : public JsonArrayReader
+{
+
+public:
+    explicit ItemCounter(const QStringList &path) :
+        JsonArrayReader(path),
+        m_count(0)
+    {
+    }
+
+    int count() const {
+        return m_count;
+    }
+
+protected:
+    void readItem(const QVariant &item) {
+        Q_UNUSED(item)
+        m_count++;
+    }
+
+private:
+    int m_count;
+};
+
+static QVariant parseStream(const QByteArray &json, int chunkSize, bool &ok) {
+    TreeBuilder builder;
+    JsonStreamParser parser(&builder);
+
+    for (int i = 0; i < json.size(); i += chunkSize) {
+        if (!parser.feed(json.mid(i, chunkSize))) {
+            break;
+        }
+    }
+
+    ok = parser.finish();
+
+    return ok ? builder.result() : QVariant();
+}
+
+static QVariant parseDocument(const QByteArray &json, bool &ok) {
+    return JsonDocument::fromJson(json, ok).toVariant();
+}
+
+JsonBenchmark::JsonBenchmark(QTextStream &out) :
+    m_out(out)
+{
+}
+
+/**
+ * Generates a response of GET /api/file_storage/v1/volumes.
+ */
+QByteArray JsonBenchmark::volumeListing() {
+    JsonWriter writer;
+    writer.beginArray();
+
+    for (int i = 0; i < 12; i++) {
+        QString path = i == 0 ? QString("~/Ubuntu One") : QString("~/Shared/Folder %1").arg(i);
+
+        writer.beginObject()
+              .key("resource_path").value("/volumes/" + path)
+              .key("type").value(i == 0 ? "root" : "udf")
+              .key("path").value(path)
+              .key("generation").value(1000 + i)
+              .key("node_path").value("/" + path)
+              .key("content_path").value("/content/" + path)
+              .key("when_created").value("2014-01-01T10:00:00Z")
+              .endObject();
+    }
+
+    return writer.endArray().data();
+}
+
+static void writeNode(JsonWriter &writer, const QString &parent, int i) {
+    QString name = QString::fromUtf8("File %1 \xc3\xa9t\xc3\xa9.txt").arg(i);
+
+    writer.beginObject()
+          .key("resource_path").value("/~/Ubuntu One" + parent + "/" + name)
+          .key("kind").value(i % 10 == 0 ? "directory" : "file")
+          .key("path").value(parent + "/" + name)
+          .key("is_public").value(i % 7 == 0)
+          .key("public_url").value(QVariant())
+          .key("content_path").value("/content/~/Ubuntu One" + parent + "/" + name)
+          .key("volume_path").value("/volumes/~/Ubuntu One")
+          .key("parent_path").value("/~/Ubuntu One" + parent)
+          .key("node_path").value(parent + "/" + name)
+          .key("key").value(QString("MTQ0Mjg%1").arg(i, 8, 16, QChar('0')))
+          .key("when_created").value("2014-01-01T10:00:00Z")
+          .key("when_changed").value("2014-02-03T11:22:33Z")
+          .key("generation").value(20000 + i)
+          .key("generation_created").value(10000 + i)
+          .key("hash").value(QString("sha1:%1").arg(i * 7919, 40, 16, QChar('0')))
+          .key("size").value(qlonglong(i) * 104729)
+          .key("has_children").value(i % 10 == 0)
+          .endObject();
+}
+
+/**
+ * Generates a response of GET /api/file_storage/v1/~/path?include_children=true.
+ */
+QByteArray JsonBenchmark::directoryListing(int children) {
+    JsonWriter writer(children * 700);
+    writer.beginObject()
+          .key("resource_path").value("/~/Ubuntu One/Documents")
+          .key("kind").value("directory")
+          .key("path").value("/Documents")
+          .key("generation").value(30000)
+          .key("has_children").value(children > 0)
+          .key("children").beginArray();
+
+    for (int i = 0; i < children; i++) {
+        writeNode(writer, "/Documents", i);
+    }
+
+    return writer.endArray().endObject().data();
+}
+
+/**
+ * Generates a response of GET /api/music/v2/songs/.
+ */
+QByteArray JsonBenchmark::songCatalogue(int songs) {
+    JsonWriter writer(songs * 600);
+    writer.beginObject().key("response").beginObject().key("songs").beginArray();
+
+    for (int i = 0; i < songs; i++) {
+        QString id = QString("S%1").arg(i, 10, 36, QChar('0'));
+        QString artist = QString("Artist %1").arg(i / 120);
+        QString album = QString("Album %1").arg(i / 12);
+
+        writer.beginObject()
+              .key("id").value(id)
+              .key("title").value(QString::fromUtf8("Song %1 \xe2\x99\xab").arg(i))
+              .key("artist").value(artist)
+              .key("artist_id").value(QString("A%1").arg(i / 120))
+              .key("album").value(album)
+              .key("album_artist").value(artist)
+              .key("album_id").value(QString("B%1").arg(i / 12))
+              .key("genre").value("Rock")
+              .key("path").value(QString("/Music/%1/%2/%3.mp3").arg(artist).arg(album).arg(i))
+              .key("suffix").value("mp3")
+              .key("content_type").value("audio/mpeg")
+              .key("song_url").value("https://one.ubuntu.com/api/music/v2/songs/" + id + "/")
+              .key("song_art_url").value("https://one.ubuntu.com/api/music/v2/songs/" + id + "/art/")
+              .key("song_stream_url").value("https://streaming.one.ubuntu.com/" + id + "/")
+              .key("year").value(1990 + i % 25)
+              .key("track").value(i % 12 + 1)
+              .key("disc_number").value(1)
+              .key("bit_rate").value(320)
+              .key("duration").value(180 + i % 120)
+              .key("size").value(qlonglong(7200000 + i))
+              .endObject();
+    }
+
+    return writer.endArray().endObject().endObject().data();
+}
+
+/**
+ * Generates a response of GET /api/account/.
+ */
+QByteArray JsonBenchmark::accountInfo() {
+    QStringList features;
+    features << "antivirus" << "music-streaming" << "photo-upload" << "file-sharing";
+
+    JsonWriter writer;
+    writer.beginObject()
+          .key("id").value(123456)
+          .key("username").value("user")
+          .key("nickname").value("User")
+          .key("first_name").value("First")
+          .key("last_name").value(QString::fromUtf8("L\xc3\xa4st"))
+          .key("email").value("user@example.com")
+          .key("openid").value("https://login.ubuntu.com/+id/abcdefg")
+          .key("total_storage").value(qlonglong(5368709120LL))
+          .key("current_plan").value("Basic")
+          .key("detailed_plans").beginArray();
+
+    for (int i = 0; i < 3; i++) {
+        writer.beginObject()
+              .key("name").value(QString("Plan %1").arg(i))
+              .key("description").value("Extra storage \"plus\"")
+              .key("is_base_plan").value(i == 0)
+              .endObject();
+    }
+
+    writer.endArray()
+          .key("features").value(features)
+          .key("subscription").beginObject()
+              .key("renewal_date").value("2015-01-01")
+              .key("price").value(QVariant(29.99))
+          .endObject();
+
+    return writer.endObject().data();
+}
+
+void JsonBenchmark::run() {
+    this->benchmark("volume listing", volumeListing());
+    this->benchmark("account info", accountInfo());
+    this->benchmark("directory, 10k children", directoryListing(10000));
+    this->benchmark("song catalogue, 50k songs", songCatalogue(50000));
+}
+
+void JsonBenchmark::benchmark(const QString &name, const QByteArray &json) {
+    m_out << name << " (" << json.size() << " bytes)" << endl;
+
+    const char *parsers[] = { "Json::parse", "JsonStreamParser", "JsonArrayReader", "JsonDocument", "JsonDocument + toVariant" };
+    const QStringList path = json.startsWith("{\"response\"") ? QStringList() << "response" << "songs"
+                                                              : QStringList("children");
+
+    for (int p = 0; p < 5; p++) {
+        int iterations = 0;
+        qint64 allocations = 0;
+        QElapsedTimer timer;
+        timer.start();
+
+        // Repeat for at least half a second, counting the allocations of the first run only
+        while ((iterations == 0) || (timer.elapsed() < 500)) {
+            const qint64 before = allocationCount();
+            bool ok = true;
+
+            switch (p) {
+            case 0:
+                Json::parse(json, ok);
+                break;
+            case 1:
+                parseStream(json, CHUNK_SIZE, ok);
+                break;
+            case 2:
+            {
+                ItemCounter counter(path);
+                JsonStreamParser parser(&counter);
+
+                for (int i = 0; i < json.size(); i += CHUNK_SIZE) {
+                    parser.feed(json.mid(i, CHUNK_SIZE));
+                }
+
+                ok = parser.finish();
+                break;
+            }
+            case 3:
+                JsonDocument::fromJson(json, ok);
+                break;
+            default:
+                parseDocument(json, ok);
+                break;
+            }
+
+            if (iterations == 0) {
+                allocations = allocationCount() - before;
+            }
+
+            iterations++;
+        }
+
+        const double seconds = timer.nsecsElapsed() / 1e9;
+        const double mbps = double(json.size()) * iterations / seconds / (1024 * 1024);
+
+        m_out << "    " << QString(parsers[p]).leftJustified(26)
+              << QString::number(mbps, 'f', 1).rightJustified(8) << " MB/s"
+              << QString::number(allocations).rightJustified(10) << (allocationCountIncludesMalloc() ? " allocations" : " new calls") << endl;
+    }
+
+    m_out << endl;
+}
+
+int JsonBenchmark::verify(const QStringList &paths) {
+    QList<QByteArray> corpus;
+    corpus << "{}" << "[]" << "0" << "-0.5e+3" << "\"\"" << "null" << "true" << " [ 1 , 2 ] "
+           << "{\"a\": [1, {\"b\": null}], \"c\": \"\\u00e9\\ud83d\\ude00\\n\\\"\"}"
+           << "{\"k\": 1, \"k\": 2}" << "[18446744073709551615, -9223372036854775808, 1.5]"
+           << "{\"children\": [{\"kind\": \"file\"}, 3, [4]]}"
+           // Invalid documents
+           << "" << "[" << "{\"a\" 1}" << "[1,]" << "{\"a\":1}}" << "[01]" << "[1.]" << "[\"\\x\"]"
+           << "[\"\\u12\"]" << "tru" << "nul" << "{,}" << "[\"a\" \"b\"]";
+    corpus << volumeListing() << accountInfo() << directoryListing(20) << songCatalogue(20);
+
+    foreach (const QString &path, paths) {
+        QFile file(path);
+
+        if (file.open(QIODevice::ReadOnly)) {
+            corpus << file.readAll();
+        }
+        else {
+            m_out << "Cannot read " << path << endl;
+        }
+    }
+
+    int failures = 0;
+
+    for (int i = 0; i < corpus.size(); i++) {
+        failures += this->check(QString("corpus %1").arg(i), corpus.at(i));
+    }
+
+    // Corrupt each document in a few ways and check that the parsers still agree
+    static const char replacements[] = "{}[]\",:\\0123456789.-+eEtfnul \t\n\x01\xc3\xff";
+    qsrand(1);
+
+    for (int i = 0; i < corpus.size(); i++) {
+        const QByteArray &document = corpus.at(i);
+
+        for (int j = 0; (j < 50) && (!document.isEmpty()); j++) {
+            QByteArray mutated = document;
+            const int position = qrand() % mutated.size();
+
+            switch (j % 4) {
+            case 0:
+                mutated.truncate(position);
+                break;
+            case 1:
+                mutated[position] = replacements[qrand() % (sizeof(replacements) - 1)];
+                break;
+            case 2:
+                mutated.insert(position, replacements[qrand() % (sizeof(replacements) - 1)]);
+                break;
+            default:
+                mutated.remove(position, 1);
+                break;
+            }
+
+            failures += this->check(QString("corpus %1, mutation %2").arg(i).arg(j), mutated);
+        }
+    }
+
+    m_out << corpus.size() << " documents checked, " << failures << " failures" << endl;
+
+    return failures;
+}
+
+int JsonBenchmark::check(const QString &name, const QByteArray &json) {
+    bool lenientOk = false;
+    bool streamOk = false;
+    bool documentOk = false;
+    const QVariant lenient = Json::parse(json, lenientOk);
+    const QVariant stream = parseStream(json, 7, streamOk);
+    const QVariant document = parseDocument(json, documentOk);
+
+    // The strict parsers must agree with each other, and must only accept documents
+    // that Json::parse also accepts, with identical results
+    QString error;
+
+    if (streamOk != documentOk) {
+        error = QString("JsonStreamParser %1 but JsonDocument %2").arg(streamOk ? "accepts" : "rejects")
+                                                                   .arg(documentOk ? "accepts" : "rejects");
+    }
+    else if ((streamOk) && (!lenientOk)) {
+        error = "Json::parse rejects a valid document";
+    }
+    else if ((streamOk) && ((stream != lenient) || (document != lenient))) {
+        error = "The parsers disagree on the result";
+    }
+
+    if (error.isEmpty()) {
+        return 0;
+    }
+
+    m_out << name << ": " << error << endl
+          << "    " << json.left(200) << endl;
+
+    return 1;
+}
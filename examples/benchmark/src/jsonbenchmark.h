@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef JSONBENCHMARK_H
+#define JSONBENCHMARK_H
+
+#include <QByteArray>
+#include <QStringList>
+
+class QTextStream;
+
+/**
+ * \class JsonBenchmark
+ * \brief Measures and cross-checks the JSON parsers.
+ *
+ * JsonBenchmark parses generated payloads shaped like Ubuntu One
+ * responses with each parser implementation and reports throughput and
+ * heap allocations per document. It also runs a corpus of documents,
+ * plus randomly corrupted copies of them, through every implementation
+ * and reports any disagreement.
+ */
+class JsonBenchmark
+{
+
+public:
+    explicit JsonBenchmark(QTextStream &out);
+
+    /**
+     * Runs the throughput benchmarks.
+     */
+    void run();
+
+    /**
+     * Runs the correctness checks over the built-in corpus and the
+     * JSON files in \a paths.
+     *
+     * \return int The number of failures.
+     */
+    int verify(const QStringList &paths = QStringList());
+
+    static QByteArray volumeListing();
+    static QByteArray directoryListing(int children);
+    static QByteArray songCatalogue(int songs);
+    static QByteArray accountInfo();
+
+private:
+    void benchmark(const QString &name, const QByteArray &json);
+
+    int check(const QString &name, const QByteArray &json);
+
+    QTextStream &m_out;
+};
+
+#endif // JSONBENCHMARK_H
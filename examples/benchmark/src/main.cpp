@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "jsonbenchmark.h"
+#include "oauthbenchmark.h"
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+#include <stdio.h>
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName("QUbuntuOne");
+    app.setApplicationName("Benchmark");
+
+    QStringList args = app.arguments();
+    args.removeFirst();
+
+    QTextStream out(stdout);
+    JsonBenchmark json(out);
+    OAuthBenchmark oauth(out);
+
+    if ((!args.isEmpty()) && (args.first() == "--verify")) {
+        args.removeFirst();
+        const int failures = json.verify(args) + oauth.verify();
+        return failures > 0 ? 1 : 0;
+    }
+
+    json.run();
+    oauth.run();
+
+    return 0;
+}
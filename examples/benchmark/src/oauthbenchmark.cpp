@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "oauthbenchmark.h"
+#include "allocationcounter.h"
+#include "oauth.h"
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+
+using namespace QtOAuth;
+
+static const char CONSUMER_KEY[] = "ubuntuone-consumer";
+static const char CONSUMER_SECRET[] = "c0nsumer/secret+";
+static const char TOKEN_KEY[] = "tok3n-key";
+static const char TOKEN_SECRET[] = "t0ken&secret=";
+static const char NONCE[] = "1234567890123456789";
+static const char TIMESTAMP[] = "1400000000";
+
+/**
+ * A request as the library signs it.
+ */
+struct Request {
+    const char *method;
+    const char *url;
+    const char *params[4];
+    const char *expected;
+};
+
+// The expected headers were computed with an independent implementation
+// of the signing scheme, using the credentials, nonce and timestamp above
+static const Request REQUESTS[] = {
+    { "GET", "https://one.ubuntu.com/api/file_storage/v1/~/Ubuntu%20One/Documents",
+      { "include_children", "true", 0, 0 },
+      "OAuth oauth_consumer_key=\"ubuntuone-consumer\", oauth_nonce=\"1234567890123456789\", "
+      "oauth_signature=\"dDaZn7BNAqMbdH5IMWhrX0X1ums%3D\", oauth_signature_method=\"HMAC-SHA1\", "
+      "oauth_timestamp=\"1400000000\", oauth_token=\"tok3n-key\", oauth_version=\"1.0\"" },
+    { "GET", "https://one.ubuntu.com/api/music/v2/songs/",
+      { "offset", "100", "limit", "50" },
+      "OAuth oauth_consumer_key=\"ubuntuone-consumer\", oauth_nonce=\"1234567890123456789\", "
+      "oauth_signature=\"6x%2BIABFWRmr%2BDsVM0PrY2WD2KcI%3D\", oauth_signature_method=\"HMAC-SHA1\", "
+      "oauth_timestamp=\"1400000000\", oauth_token=\"tok3n-key\", oauth_version=\"1.0\"" },
+    { "PUT", "https://one.ubuntu.com/api/file_storage/v1/~/Ubuntu One/caf\xc3\xa9.txt",
+      { 0, 0, 0, 0 },
+      "OAuth oauth_consumer_key=\"ubuntuone-consumer\", oauth_nonce=\"1234567890123456789\", "
+      "oauth_signature=\"OzFtdD8FnAP77Uuaeau354d%2BGEw%3D\", oauth_signature_method=\"HMAC-SHA1\", "
+      "oauth_timestamp=\"1400000000\", oauth_token=\"tok3n-key\", oauth_version=\"1.0\"" },
+    { "DELETE", "https://one.ubuntu.com/api/file_storage/v1/volumes/~/Shared",
+      { 0, 0, 0, 0 },
+      "OAuth oauth_consumer_key=\"ubuntuone-consumer\", oauth_nonce=\"1234567890123456789\", "
+      "oauth_signature=\"latjPaUOoyVjmduY%2FrMxoihzeWQ%3D\", oauth_signature_method=\"HMAC-SHA1\", "
+      "oauth_timestamp=\"1400000000\", oauth_token=\"tok3n-key\", oauth_version=\"1.0\"" },
+    { "GET", "https://one.ubuntu.com/api/music/v2/artists/A%2FB/",
+      { "artist_id", "A/B c", 0, 0 },
+      "OAuth oauth_consumer_key=\"ubuntuone-consumer\", oauth_nonce=\"1234567890123456789\", "
+      "oauth_signature=\"sZdNJtfDVmY%2FagBe37q%2BMcMIp04%3D\", oauth_signature_method=\"HMAC-SHA1\", "
+      "oauth_timestamp=\"1400000000\", oauth_token=\"tok3n-key\", oauth_version=\"1.0\"" }
+};
+
+static const int REQUEST_COUNT = sizeof(REQUESTS) / sizeof(REQUESTS[0]);
+
+/**
+ * An HMAC-SHA1 test case from RFC 2202.
+ */
+struct HmacVector {
+    QByteArray key;
+    QByteArray message;
+    const char *digest;
+};
+
+static QMap<QString, QString> requestParams(const Request &request) {
+    QMap<QString, QString> params;
+
+    for (int i = 0; (i < 4) && (request.params[i]); i += 2) {
+        params.insert(request.params[i], request.params[i + 1]);
+    }
+
+    return params;
+}
+
+OAuthBenchmark::OAuthBenchmark(QTextStream &out) :
+    m_out(out)
+{
+}
+
+/**
+ * The HMAC-SHA1 signature of message, computed as the library did before
+ * the signer kept the padded key states.
+ */
+QByteArray OAuthBenchmark::referenceSignature(const QByteArray &key, const QByteArray &message) {
+    const int blockSize = 64;
+    QByteArray blockKey = key.length() > blockSize ? QCryptographicHash::hash(key, QCryptographicHash::Sha1) : key;
+    QByteArray innerPadding(blockSize, char(0x36));
+    QByteArray outerPadding(blockSize, char(0x5c));
+
+    for (int i = 0; i < blockKey.length(); i++) {
+        innerPadding[i] = innerPadding[i] ^ blockKey.at(i);
+        outerPadding[i] = outerPadding[i] ^ blockKey.at(i);
+    }
+
+    QByteArray inner = QCryptographicHash::hash(innerPadding + message, QCryptographicHash::Sha1);
+
+    return QCryptographicHash::hash(outerPadding + inner, QCryptographicHash::Sha1).toBase64();
+}
+
+/**
+ * The Authorization header of a request, built as the library did before
+ * the header builder, with the benchmark credentials.
+ */
+QByteArray OAuthBenchmark::referenceHeader(const QString &method, const QString &url, QMap<QString, QString> params,
+                                           const QString &nonce, const QString &timeStamp) {
+    QString baseString;
+    baseString.append(method.toUpper() + "&" + url.toUtf8().toPercentEncoding() + "&");
+
+    params.insert("oauth_consumer_key", CONSUMER_KEY);
+    params.insert("oauth_consumer_secret", CONSUMER_SECRET);
+    params.insert("oauth_token", TOKEN_KEY);
+    params.insert("oauth_token_secret", TOKEN_SECRET);
+    params.insert("oauth_nonce", nonce);
+    params.insert("oauth_timestamp", timeStamp);
+    params.insert("oauth_signature_method", "HMAC-SHA1");
+    params.insert("oauth_version", "1.0");
+
+    QMapIterator<QString, QString> iterator(params);
+    iterator.next();
+    baseString.append(QString(iterator.key() + "=" + iterator.value().toUtf8().toPercentEncoding()).toUtf8().toPercentEncoding());
+
+    while (iterator.hasNext()) {
+        iterator.next();
+        QString key(iterator.key());
+
+        if ((key != "oauth_consumer_secret") && (key != "oauth_token_secret")) {
+            baseString.append(QString("&" + key + "=" + iterator.value()).toUtf8().toPercentEncoding());
+        }
+    }
+
+    QByteArray key(QByteArray(CONSUMER_SECRET).toPercentEncoding() + "&" + QByteArray(TOKEN_SECRET).toPercentEncoding());
+    QByteArray signature(referenceSignature(key, baseString.toUtf8()));
+    QByteArray header("OAuth ");
+
+    params.insert("oauth_signature", QString(signature));
+    params.remove("oauth_consumer_secret");
+    params.remove("oauth_token_secret");
+
+    foreach (QString key, params.keys()) {
+        if (!key.startsWith("oauth_")) {
+            params.remove(key);
+        }
+    }
+
+    QMapIterator<QString, QString> headerIterator(params);
+
+    while (headerIterator.hasNext()) {
+        headerIterator.next();
+        header.append(headerIterator.key().toUtf8() + "=\"" + headerIterator.value().toUtf8().toPercentEncoding() + "\"");
+
+        if (headerIterator.hasNext()) {
+            header.append(", ");
+        }
+    }
+
+    return header;
+}
+
+void OAuthBenchmark::run() {
+    m_out << "OAuth signing (" << REQUEST_COUNT << " requests: GET, PUT and DELETE, with and without query parameters)" << endl;
+
+    QList<QMap<QString, QString> > params;
+    QStringList urls;
+
+    for (int i = 0; i < REQUEST_COUNT; i++) {
+        params << requestParams(REQUESTS[i]);
+        urls << QString::fromUtf8(REQUESTS[i].url);
+    }
+
+    const char *signers[] = { "previous implementation", "OAuth::createOAuthHeader", "HeaderBuilder::build", "HeaderBuilder::buildBatch" };
+    HeaderBuilder builder;
+    builder.setCredentials(CONSUMER_KEY, CONSUMER_SECRET, TOKEN_KEY, TOKEN_SECRET);
+
+    for (int s = 0; s < 4; s++) {
+        qint64 signatures = 0;
+        qint64 allocations = 0;
+        int iterations = 0;
+        QElapsedTimer timer;
+        timer.start();
+
+        // Repeat for at least half a second, counting the allocations of the first run only
+        while ((iterations == 0) || (timer.elapsed() < 500)) {
+            const qint64 before = allocationCount();
+
+            for (int i = 0; i < REQUEST_COUNT; i++) {
+                const Request &request = REQUESTS[i];
+
+                switch (s) {
+                case 0:
+                    referenceHeader(request.method, urls.at(i), params.at(i), NONCE, TIMESTAMP);
+                    break;
+                case 1:
+                    OAuth::createOAuthHeader(request.method, urls.at(i), params.at(i),
+                                             CONSUMER_KEY, CONSUMER_SECRET, TOKEN_KEY, TOKEN_SECRET);
+                    break;
+                case 2:
+                    builder.build(request.method, urls.at(i), params.at(i));
+                    break;
+                default:
+                    // Sign the same request for many files at once
+                    builder.buildBatch(request.method, QStringList() << urls.at(i) << urls.at(i) << urls.at(i) << urls.at(i), params.at(i));
+                    signatures += 3;
+                    break;
+                }
+
+                signatures++;
+            }
+
+            if (iterations == 0) {
+                allocations = allocationCount() - before;
+            }
+
+            iterations++;
+        }
+
+        const double seconds = timer.nsecsElapsed() / 1e9;
+        const double perSecond = signatures / seconds;
+        const double perSignature = double(allocations) / (s == 3 ? REQUEST_COUNT * 4 : REQUEST_COUNT);
+
+        m_out << "    " << QString(signers[s]).leftJustified(26)
+              << QString::number(perSecond, 'f', 0).rightJustified(10) << " signatures/s"
+              << QString::number(perSignature, 'f', 1).rightJustified(8) << (allocationCountIncludesMalloc() ? " allocations each" : " new calls each") << endl;
+    }
+
+    m_out << endl;
+}
+
+int OAuthBenchmark::verify() {
+    int failures = 0;
+
+    // RFC 2202, section 3
+    const HmacVector vectors[] = {
+        { QByteArray(20, '\x0b'), "Hi There", "thcxhlUFcmTii8C2+zeMjvFGvgA=" },
+        { "Jefe", "what do ya want for nothing?", "7/zfauXrL6LSdBbV8YTfnCWafHk=" },
+        { QByteArray(20, '\xaa'), QByteArray(50, '\xdd'), "El1zQrmsEc2Ro5r0iqF7T2PxddM=" },
+        { QByteArray::fromHex("0102030405060708090a0b0c0d0e0f10111213141516171819"), QByteArray(50, '\xcd'), "TJAH9AJiUMa8hBT5v1DIbC1yNdo=" },
+        { QByteArray(20, '\x0c'), "Test With Truncation", "TBoDQktV4H/n8nvh1Yu5MkqaWgQ=" },
+        { QByteArray(80, '\xaa'), "Test Using Larger Than Block-Size Key - Hash Key First", "qkrl4VJy0A6VcFY3zoo7Ve1AIRI=" },
+        { QByteArray(80, '\xaa'), "Test Using Larger Than Block-Size Key and Larger Than One Block-Size Data", "6OmdD0UjfXhta7qnllx4CLv/GpE=" }
+    };
+    const int vectorCount = sizeof(vectors) / sizeof(vectors[0]);
+
+    for (int i = 0; i < vectorCount; i++) {
+        failures += this->check(QString("RFC 2202 case %1").arg(i + 1), Signer(vectors[i].key).sign(vectors[i].message), vectors[i].digest);
+        failures += this->check(QString("RFC 2202 case %1, reference").arg(i + 1), referenceSignature(vectors[i].key, vectors[i].message), vectors[i].digest);
+    }
+
+    // Every key and message length around the SHA-1 block and padding boundaries
+    qsrand(1);
+
+    for (int keyLength = 0; keyLength <= 130; keyLength += 13) {
+        QByteArray key;
+
+        for (int i = 0; i < keyLength; i++) {
+            key.append(char(qrand()));
+        }
+
+        Signer signer(key);
+
+        for (int length = 0; length <= 200; length++) {
+            QByteArray message;
+
+            for (int i = 0; i < length; i++) {
+                message.append(char(qrand()));
+            }
+
+            failures += this->check(QString("key length %1, message length %2").arg(keyLength).arg(length),
+                                    signer.sign(message), referenceSignature(key, message));
+        }
+    }
+
+    // Known headers, built with fixed nonces and timestamps
+    HeaderBuilder builder;
+    builder.setCredentials(CONSUMER_KEY, CONSUMER_SECRET, TOKEN_KEY, TOKEN_SECRET);
+
+    for (int i = 0; i < REQUEST_COUNT; i++) {
+        const Request &request = REQUESTS[i];
+        const QString url = QString::fromUtf8(request.url);
+        const QMap<QString, QString> params = requestParams(request);
+        const QString name = QString("%1 %2").arg(request.method).arg(url);
+
+        failures += this->check(name, builder.build(request.method, url, params, NONCE, TIMESTAMP), request.expected);
+        failures += this->check(name + ", reference", referenceHeader(request.method, url, params, NONCE, TIMESTAMP), request.expected);
+    }
+
+    m_out << "OAuth: " << vectorCount << " HMAC vectors, " << REQUEST_COUNT << " headers checked, " << failures << " failures" << endl;
+
+    return failures;
+}
+
+int OAuthBenchmark::check(const QString &name, const QByteArray &result, const QByteArray &expected) {
+    if (result == expected) {
+        return 0;
+    }
+
+    m_out << name << ": expected" << endl
+          << "    " << expected << endl
+          << "but got" << endl
+          << "    " << result << endl;
+
+    return 1;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef OAUTHBENCHMARK_H
+#define OAUTHBENCHMARK_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+
+class QTextStream;
+
+/**
+ * \class OAuthBenchmark
+ * \brief Measures and verifies OAuth request signing.
+ *
+ * OAuthBenchmark signs a mix of Ubuntu One requests with the previous
+ * signing code and with each current signing path, and reports
+ * signatures per second and heap allocations per signature. It also
+ * checks the HMAC-SHA1 signer and the header builder against known-answer
+ * vectors and against a reference implementation built on
+ * QCryptographicHash.
+ */
+class OAuthBenchmark
+{
+
+public:
+    explicit OAuthBenchmark(QTextStream &out);
+
+    /**
+     * Runs the signing benchmarks.
+     */
+    void run();
+
+    /**
+     * Runs the known-answer and cross-checks.
+     *
+     * \return int The number of failures.
+     */
+    int verify();
+
+    static QByteArray referenceSignature(const QByteArray &key, const QByteArray &message);
+    static QByteArray referenceHeader(const QString &method, const QString &url, QMap<QString, QString> params,
+                                      const QString &nonce, const QString &timeStamp);
+
+private:
+    int check(const QString &name, const QByteArray &result, const QByteArray &expected);
+
+    QTextStream &m_out;
+};
+
+#endif // OAUTHBENCHMARK_H
@@ -2,5 +2,6 @@ TEMPLATE = subdirs
 SUBDIRS += \
     account \
     authentication \
+    benchmark \
     files \
     music
@@ -22,8 +22,7 @@
 #include "account.h"
 #include "storagequota.h"
 #include "useraccount.h"
-#include "authentication.h"
-#include "networkaccessmanager.h"
+#include "requestbuilder.h"
 #include "urls.h"
 
 namespace QtUbuntuOne {
@@ -38,27 +37,21 @@ Account::~Account() {}
 /**
  * getAccount
  */
-UserAccount* Account::getAccount() {
-    QUrl url(BASE_URL_ACCOUNT);
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", BASE_URL_ACCOUNT, QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+UserAccount* Account::getAccount(Session *session) {
+    RequestBuilder builder(QUrl(BASE_URL_ACCOUNT), RequestBuilder::SignPath, session);
+    builder.setCacheable(true);
 
-    return new UserAccount(NetworkAccessManager::instance()->get(request));
+    return new UserAccount(builder.get());
 }
 
 /**
  * getStorageQuota
  */
-StorageQuota* Account::getStorageQuota() {
-    QUrl url(BASE_URL_QUOTA);
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", BASE_URL_QUOTA, QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+StorageQuota* Account::getStorageQuota(Session *session) {
+    RequestBuilder builder(QUrl(BASE_URL_QUOTA), RequestBuilder::SignPath, session);
+    builder.setCacheable(true);
 
-    return new StorageQuota(NetworkAccessManager::instance()->get(request));
+    return new StorageQuota(builder.get());
 }
 
 }
@@ -27,6 +27,7 @@
 
 namespace QtUbuntuOne {
 
+class Session;
 class StorageQuota;
 class UserAccount;
 
@@ -47,16 +48,20 @@ public:
     /**
      * Requests account information of the currently authenticated user and returns instance of UserAccount.
      *
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     *
      * \return UserAccount* A UserAccount containing the result of the request.
      */
-    Q_INVOKABLE static UserAccount* getAccount();
+    Q_INVOKABLE static UserAccount* getAccount(Session *session = 0);
 
     /**
      * Requests the storage quota of the currently authenticated user and returns an instance of StorageQuota.
      *
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     *
      * \return StorageQuota* A StorageQuota containing the result of the request.
      */
-    Q_INVOKABLE static StorageQuota* getStorageQuota();
+    Q_INVOKABLE static StorageQuota* getStorageQuota(Session *session = 0);
 };
 
 }
@@ -20,6 +20,31 @@
 
 namespace QtUbuntuOne {
 
+static const char * const ALBUM_KEYS[] = {
+    "id",
+    "title",
+    "artist",
+    "artist_id",
+    "album_url",
+    "album_art_url",
+    "year",
+    "parsed_date"
+};
+
+enum AlbumKeys {
+    IdKey = 0,
+    TitleKey,
+    ArtistKey,
+    ArtistIdKey,
+    AlbumUrlKey,
+    AlbumArtUrlKey,
+    YearKey,
+    ParsedDateKey,
+    AlbumKeyCount
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(QtJson::JsonKeyTable, albumKeyTable, (ALBUM_KEYS, AlbumKeyCount))
+
 AlbumPrivate::AlbumPrivate(Album *parent) :
     q_ptr(parent),
     m_year(1970)
@@ -60,17 +85,60 @@ void AlbumPrivate::loadAlbum(Album *otherAlbum) {
 }
 
 void AlbumPrivate::loadAlbum(const QVariantMap &album) {
+    this->beginLoad();
+
+    for (QVariantMap::const_iterator iterator = album.constBegin(); iterator != album.constEnd(); ++iterator) {
+        this->loadProperty(iterator.key(), iterator.value());
+    }
+
+    this->endLoad();
+}
+
+void AlbumPrivate::beginLoad() {
+    this->setId(QString());
+    this->setTitle(QString());
+    this->setArtist(QString());
+    this->setArtistId(QString());
+    this->setUrl(QUrl());
+    this->setArtworkUrl(QUrl());
+    this->setYear(0);
+    this->setDate(QDateTime::fromTime_t(0));
+}
+
+void AlbumPrivate::loadProperty(const QString &key, const QVariant &value) {
+    switch (albumKeyTable()->indexOf(key)) {
+    case IdKey:
+        this->setId(value.toString());
+        break;
+    case TitleKey:
+        this->setTitle(value.toString());
+        break;
+    case ArtistKey:
+        this->setArtist(value.toString());
+        break;
+    case ArtistIdKey:
+        this->setArtistId(value.toString());
+        break;
+    case AlbumUrlKey:
+        this->setUrl(value.toUrl());
+        break;
+    case AlbumArtUrlKey:
+        this->setArtworkUrl(value.toUrl());
+        break;
+    case YearKey:
+        this->setYear(value.toInt());
+        break;
+    case ParsedDateKey:
+        this->setDate(QDateTime::fromTime_t(value.toLongLong()));
+        break;
+    default:
+        break;
+    }
+}
+
+void AlbumPrivate::endLoad() {
     Q_Q(Album);
 
-    this->setId(album.value("id").toString());
-    this->setTitle(album.value("title").toString());
-    this->setArtist(album.value("artist").toString());
-    this->setArtistId(album.value("artist_id").toString());
-    this->setUrl(album.value("album_url").toUrl());
-    this->setArtworkUrl(album.value("album_art_url").toUrl());
-    this->setYear(album.value("year").toInt());
-    this->setDate(QDateTime::fromTime_t(album.value("parsed_date").toLongLong()));
-
     emit q->ready(q);
 }
 
@@ -33,6 +33,10 @@ public:
     void loadAlbum(Album *otherAlbum);
     void loadAlbum(const QVariantMap &album);
 
+    void beginLoad();
+    void loadProperty(const QString &key, const QVariant &value);
+    void endLoad();
+
     QString id() const;
 
     QString title() const;
@@ -152,6 +152,7 @@ private:
 
     Q_DECLARE_PRIVATE(AlbumList)
 
+    Q_PRIVATE_SLOT(d_func(), void _q_onReplyReadyRead())
     Q_PRIVATE_SLOT(d_func(), void _q_onReplyFinished())
 };
 
@@ -17,18 +17,21 @@
 
 #include "albumlist_p.h"
 #include "album_p.h"
-#include "json.h"
 
 namespace QtUbuntuOne {
 
 AlbumListPrivate::AlbumListPrivate(QNetworkReply *reply, AlbumList *parent) :
+    QtJson::JsonArrayReader(QStringList() << "response" << "albums"),
     q_ptr(parent),
     m_reply(reply),
+    m_parser(this),
+    m_currentAlbum(0),
     m_error(AlbumList::NoError)
 {
     Q_Q(AlbumList);
 
     if (m_reply) {
+        q->connect(m_reply, SIGNAL(readyRead()), q, SLOT(_q_onReplyReadyRead()));
         q->connect(m_reply, SIGNAL(finished()), q, SLOT(_q_onReplyFinished()));
     }
 }
@@ -38,6 +41,11 @@ AlbumListPrivate::~AlbumListPrivate() {
         delete m_reply;
         m_reply = 0;
     }
+
+    if (m_currentAlbum) {
+        delete m_currentAlbum;
+        m_currentAlbum = 0;
+    }
 }
 
 int AlbumListPrivate::count() const {
@@ -64,16 +72,25 @@ void AlbumListPrivate::setErrorString(const QString &errorstring) {
     m_errorString = errorstring;
 }
 
-void AlbumListPrivate::loadAlbums(const QVariantList &albums) {
-    Q_Q(AlbumList);
+void AlbumListPrivate::readItem(const QVariant &item) {
+    Album *a = new Album;
+    a->d_func()->loadAlbum(item.toMap());
+    m_albums.append(a);
+}
 
-    foreach (QVariant album, albums) {
-        Album *a = new Album;
-        a->d_func()->loadAlbum(album.toMap());
-        m_albums.append(a);
-    }
+void AlbumListPrivate::beginItem() {
+    m_currentAlbum = new Album;
+    m_currentAlbum->d_func()->beginLoad();
+}
+
+void AlbumListPrivate::readItemValue(const QString &key, const QVariant &value) {
+    m_currentAlbum->d_func()->loadProperty(key, value);
+}
 
-    emit q->ready(q);
+void AlbumListPrivate::endItem() {
+    m_currentAlbum->d_func()->endLoad();
+    m_albums.append(m_currentAlbum);
+    m_currentAlbum = 0;
 }
 
 void AlbumListPrivate::cancel() {
@@ -82,6 +99,17 @@ void AlbumListPrivate::cancel() {
     }
 }
 
+void AlbumListPrivate::_q_onReplyReadyRead() {
+    if ((m_reply) && (!m_parser.hasError())) {
+        int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+        // Parse successful responses as they arrive
+        if ((status >= 200) && (status < 300)) {
+            m_parser.feed(m_reply->readAll());
+        }
+    }
+}
+
 void AlbumListPrivate::_q_onReplyFinished() {
     Q_Q(AlbumList);
 
@@ -99,23 +127,15 @@ void AlbumListPrivate::_q_onReplyFinished() {
             return;
         }
 
-        QString response(m_reply->readAll());
-        QVariant result = QtJson::Json::parse(response);
+        m_parser.feed(m_reply->readAll());
 
-        switch (result.type()) {
-        case QVariant::Map:
-            this->loadAlbums(result.toMap().value("response").toMap().value("albums").toList());
-            break;
-        case QVariant::List:
-            this->loadAlbums(result.toList());
-            break;
-        default:
+        if ((!m_parser.finish()) || (!this->isValid())) {
             this->setError(AlbumList::ParserError);
             this->setErrorString(QObject::tr("Cannot parse server response"));
-            emit q->ready(q);
-            break;
         }
 
+        emit q->ready(q);
+
         m_reply->deleteLater();
         m_reply = 0;
     }
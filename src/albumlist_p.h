@@ -19,10 +19,11 @@
 #define ALBUMLIST_P_H
 
 #include "albumlist.h"
+#include "json.h"
 
 namespace QtUbuntuOne {
 
-class AlbumListPrivate
+class AlbumListPrivate : public QtJson::JsonArrayReader
 {
 
 public:
@@ -42,15 +43,22 @@ private:
     void setError(AlbumList::Error error);
     void setErrorString(const QString &errorstring);
 
-    void loadAlbums(const QVariantList &albums);
+    void readItem(const QVariant &item);
+    void beginItem();
+    void readItemValue(const QString &key, const QVariant &value);
+    void endItem();
 
+    void _q_onReplyReadyRead();
     void _q_onReplyFinished();
 
     AlbumList *q_ptr;
 
     QNetworkReply *m_reply;
 
+    QtJson::JsonStreamParser m_parser;
+
     QList<Album*> m_albums;
+    Album *m_currentAlbum;
 
     AlbumList::Error m_error;
     QString m_errorString;
@@ -20,6 +20,27 @@
 
 namespace QtUbuntuOne {
 
+static const char * const ARTIST_KEYS[] = {
+    "id",
+    "artist",
+    "artist_url",
+    "artist_art_url",
+    "song_count",
+    "album_ids"
+};
+
+enum ArtistKeys {
+    IdKey = 0,
+    ArtistKey,
+    ArtistUrlKey,
+    ArtistArtUrlKey,
+    SongCountKey,
+    AlbumIdsKey,
+    ArtistKeyCount
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(QtJson::JsonKeyTable, artistKeyTable, (ARTIST_KEYS, ArtistKeyCount))
+
 ArtistPrivate::ArtistPrivate(Artist *parent) :
     q_ptr(parent),
     m_songCount(0),
@@ -59,14 +80,52 @@ void ArtistPrivate::loadArtist(Artist *otherArtist) {
 }
 
 void ArtistPrivate::loadArtist(const QVariantMap &artist) {
+    this->beginLoad();
+
+    for (QVariantMap::const_iterator iterator = artist.constBegin(); iterator != artist.constEnd(); ++iterator) {
+        this->loadProperty(iterator.key(), iterator.value());
+    }
+
+    this->endLoad();
+}
+
+void ArtistPrivate::beginLoad() {
+    this->setId(QString());
+    this->setName(QString());
+    this->setUrl(QUrl());
+    this->setArtworkUrl(QUrl());
+    this->setSongCount(0);
+    this->setAlbumIds(QStringList());
+}
+
+void ArtistPrivate::loadProperty(const QString &key, const QVariant &value) {
+    switch (artistKeyTable()->indexOf(key)) {
+    case IdKey:
+        this->setId(value.toString());
+        break;
+    case ArtistKey:
+        this->setName(value.toString());
+        break;
+    case ArtistUrlKey:
+        this->setUrl(value.toUrl());
+        break;
+    case ArtistArtUrlKey:
+        this->setArtworkUrl(value.toUrl());
+        break;
+    case SongCountKey:
+        this->setSongCount(value.toInt());
+        break;
+    case AlbumIdsKey:
+        this->setAlbumIds(value.toStringList());
+        break;
+    default:
+        break;
+    }
+}
+
+void ArtistPrivate::endLoad() {
     Q_Q(Artist);
 
-    this->setId(artist.value("id").toString());
-    this->setName(artist.value("artist").toString());
-    this->setUrl(artist.value("artist_url").toUrl());
-    this->setArtworkUrl(artist.value("artist_art_url").toUrl());
-    this->setSongCount(artist.value("song_count").toInt());
-    this->setAlbumIds(artist.value("album_ids").toStringList());
     this->setAlbumCount(this->albumIds().size());
 
     emit q->ready(q);
@@ -34,6 +34,10 @@ public:
     void loadArtist(Artist *otherArtist);
     void loadArtist(const QVariantMap &artist);
 
+    void beginLoad();
+    void loadProperty(const QString &key, const QVariant &value);
+    void endLoad();
+
     QString id() const;
 
     QString name() const;
@@ -17,18 +17,21 @@
 
 #include "artistlist_p.h"
 #include "artist_p.h"
-#include "json.h"
 
 namespace QtUbuntuOne {
 
 ArtistListPrivate::ArtistListPrivate(QNetworkReply *reply, ArtistList *parent) :
+    QtJson::JsonArrayReader(QStringList() << "response" << "artists"),
     q_ptr(parent),
     m_reply(reply),
+    m_parser(this),
+    m_currentArtist(0),
     m_error(ArtistList::NoError)
 {
     Q_Q(ArtistList);
 
     if (m_reply) {
+        q->connect(m_reply, SIGNAL(readyRead()), q, SLOT(_q_onReplyReadyRead()));
         q->connect(m_reply, SIGNAL(finished()), q, SLOT(_q_onReplyFinished()));
     }
 }
@@ -38,6 +41,11 @@ ArtistListPrivate::~ArtistListPrivate() {
         delete m_reply;
         m_reply = 0;
     }
+
+    if (m_currentArtist) {
+        delete m_currentArtist;
+        m_currentArtist = 0;
+    }
 }
 
 int ArtistListPrivate::count() const {
@@ -64,16 +72,25 @@ void ArtistListPrivate::setErrorString(const QString &errorstring) {
     m_errorString = errorstring;
 }
 
-void ArtistListPrivate::loadArtists(const QVariantList &artists) {
-    Q_Q(ArtistList);
+void ArtistListPrivate::readItem(const QVariant &item) {
+    Artist *a = new Artist;
+    a->d_func()->loadArtist(item.toMap());
+    m_artists.append(a);
+}
 
-    foreach (QVariant artist, artists) {
-        Artist *a = new Artist;
-        a->d_func()->loadArtist(artist.toMap());
-        m_artists.append(a);
-    }
+void ArtistListPrivate::beginItem() {
+    m_currentArtist = new Artist;
+    m_currentArtist->d_func()->beginLoad();
+}
+
+void ArtistListPrivate::readItemValue(const QString &key, const QVariant &value) {
+    m_currentArtist->d_func()->loadProperty(key, value);
+}
 
-    emit q->ready(q);
+void ArtistListPrivate::endItem() {
+    m_currentArtist->d_func()->endLoad();
+    m_artists.append(m_currentArtist);
+    m_currentArtist = 0;
 }
 
 void ArtistListPrivate::cancel() {
@@ -82,6 +99,17 @@ void ArtistListPrivate::cancel() {
     }
 }
 
+void ArtistListPrivate::_q_onReplyReadyRead() {
+    if ((m_reply) && (!m_parser.hasError())) {
+        int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+        // Parse successful responses as they arrive
+        if ((status >= 200) && (status < 300)) {
+            m_parser.feed(m_reply->readAll());
+        }
+    }
+}
+
 void ArtistListPrivate::_q_onReplyFinished() {
     Q_Q(ArtistList);
 
@@ -99,23 +127,15 @@ void ArtistListPrivate::_q_onReplyFinished() {
             return;
         }
 
-        QString response(m_reply->readAll());
-        QVariant result = QtJson::Json::parse(response);
+        m_parser.feed(m_reply->readAll());
 
-        switch (result.type()) {
-        case QVariant::Map:
-            this->loadArtists(result.toMap().value("response").toMap().value("artists").toList());
-            break;
-        case QVariant::List:
-            this->loadArtists(result.toList());
-            break;
-        default:
+        if ((!m_parser.finish()) || (!this->isValid())) {
             this->setError(ArtistList::ParserError);
             this->setErrorString(QObject::tr("Cannot parse server response"));
-            emit q->ready(q);
-            break;
         }
 
+        emit q->ready(q);
+
         m_reply->deleteLater();
         m_reply = 0;
     }
@@ -19,10 +19,11 @@
 #define ARTISTLIST_P_H
 
 #include "artistlist.h"
+#include "json.h"
 
 namespace QtUbuntuOne {
 
-class ArtistListPrivate
+class ArtistListPrivate : public QtJson::JsonArrayReader
 {
 
 public:
@@ -42,15 +43,22 @@ private:
     void setError(ArtistList::Error error);
     void setErrorString(const QString &errorstring);
 
-    void loadArtists(const QVariantList &artists);
+    void readItem(const QVariant &item);
+    void beginItem();
+    void readItemValue(const QString &key, const QVariant &value);
+    void endItem();
 
+    void _q_onReplyReadyRead();
     void _q_onReplyFinished();
 
     ArtistList *q_ptr;
 
     QNetworkReply *m_reply;
 
+    QtJson::JsonStreamParser m_parser;
+
     QList<Artist*> m_artists;
+    Artist *m_currentArtist;
 
     ArtistList::Error m_error;
     QString m_errorString;
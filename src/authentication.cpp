@@ -20,11 +20,11 @@
  */
 
 #include "authentication.h"
-#include "authentication_p.h"
+#include "session.h"
 #include "token.h"
 #include "urls.h"
-#include "oauth.h"
-#include "networkaccessmanager.h"
+#include "requestbuilder.h"
+#include "json.h"
 
 namespace QtUbuntuOne {
 
@@ -39,56 +39,56 @@ Authentication::~Authentication() {}
  * consumerKey
  */
 QString Authentication::consumerKey() {
-    return AuthenticationPrivate::consumerKey();
+    return Session::defaultSession()->consumerKey();
 }
 
 /**
  * setConsumerKey
  */
 void Authentication::setConsumerKey(const QString &key) {
-    AuthenticationPrivate::setConsumerKey(key);
+    Session::defaultSession()->setConsumerKey(key);
 }
 
 /**
  * consumerSecret
  */
 QString Authentication::consumerSecret() {
-    return AuthenticationPrivate::consumerSecret();
+    return Session::defaultSession()->consumerSecret();
 }
 
 /**
  * setConsumerSecret
  */
 void Authentication::setConsumerSecret(const QString &secret) {
-    AuthenticationPrivate::setConsumerSecret(secret);
+    Session::defaultSession()->setConsumerSecret(secret);
 }
 
 /**
  * tokenKey
  */
 QString Authentication::tokenKey() {
-    return AuthenticationPrivate::tokenKey();
+    return Session::defaultSession()->tokenKey();
 }
 
 /**
  * setTokenKey
  */
 void Authentication::setTokenKey(const QString &key) {
-    AuthenticationPrivate::setTokenKey(key);
+    Session::defaultSession()->setTokenKey(key);
 }
 
 /**
  * tokenSecret
  */
 QString Authentication::tokenSecret() {
-    return AuthenticationPrivate::tokenSecret();
+    return Session::defaultSession()->tokenSecret();
 }
 
 /**
  * setTokenSecret
  */
 void Authentication::setTokenSecret(const QString &secret) {
-    AuthenticationPrivate::setTokenSecret(secret);
+    Session::defaultSession()->setTokenSecret(secret);
 }
 
 /**
@@ -99,46 +99,35 @@ void Authentication::setCredentials(const QString &consumerKey,
                                     const QString &tokenKey,
                                     const QString &tokenSecret) {
 
-    Authentication::setConsumerKey(consumerKey);
-    Authentication::setConsumerSecret(consumerSecret);
-    Authentication::setTokenKey(tokenKey);
-    Authentication::setTokenSecret(tokenSecret);
+    Session::defaultSession()->setCredentials(consumerKey, consumerSecret, tokenKey, tokenSecret);
 }
 
 /**
  * setCredentials
  */
 void Authentication::clearCredentials() {
-    Authentication::setConsumerKey(QString());
-    Authentication::setConsumerSecret(QString());
-    Authentication::setTokenKey(QString());
-    Authentication::setTokenSecret(QString());
+    Session::defaultSession()->clearCredentials();
 }
 
 /**
  * getOAuthHeader
  */
 QByteArray Authentication::getOAuthHeader(const QString &method, const QString &url, QMap<QString, QString> params) {
-    params.insert("oauth_consumer_key", Authentication::consumerKey());
-    params.insert("oauth_consumer_secret", Authentication::consumerSecret());
-    params.insert("oauth_token", Authentication::tokenKey());
-    params.insert("oauth_token_secret", Authentication::tokenSecret());
-
-    return QtOAuth::OAuth::createOAuthHeader(method, url, params);
+    return Session::defaultSession()->getOAuthHeader(method, url, params);
 }
 
 /**
  * authenticate
  */
 Token* Authentication::authenticate(const QString &email, const QString &password, const QString &applicationName) {
-    QString json = QString("{ \"email\": \"%1\", \"password\": \"%2\", \"token_name\": \"Ubuntu One @ localhost [%3]\" }").arg(email).arg(password).arg(applicationName);
-    QUrl url(AUTH_URL);
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
-
-    return new Token(NetworkAccessManager::instance()->post(request, json.toUtf8()));
+    QByteArray json = QtJson::JsonWriter().beginObject()
+                      .key("email").value(email)
+                      .key("password").value(password)
+                      .key("token_name").value("Ubuntu One @ localhost [" + applicationName + "]")
+                      .endObject().data();
+    RequestBuilder builder(QUrl(AUTH_URL), RequestBuilder::Unsigned);
+
+    return new Token(builder.postJson(json));
 }
 
 /**
@@ -149,14 +138,15 @@ Token* Authentication::authenticate(const QString &email, const QString &passwor
         return Authentication::authenticate(email, password, applicationName);
     }
 
-    QString json = QString("{ \"email\": \"%1\", \"password\": \"%2\", \"otp\": \"%3\", \"token_name\": \"Ubuntu One @ localhost [%4]\" }").arg(email).arg(password).arg(oneTimePassword).arg(applicationName);
-    QUrl url(AUTH_URL);
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+    QByteArray json = QtJson::JsonWriter().beginObject()
+                      .key("email").value(email)
+                      .key("password").value(password)
+                      .key("otp").value(oneTimePassword)
+                      .key("token_name").value("Ubuntu One @ localhost [" + applicationName + "]")
+                      .endObject().data();
+    RequestBuilder builder(QUrl(AUTH_URL), RequestBuilder::Unsigned);
 
-    return new Token(NetworkAccessManager::instance()->post(request, json.toUtf8()));
+    return new Token(builder.postJson(json));
 }
 
 }
@@ -35,6 +35,7 @@ class Token;
  * \brief Handles Ubuntu One authentication.
  *
  * Authentication handles all Ubuntu One authentication operations and OAuth signing.
+ * The credentials accessed using Authentication are those of the default Session.
  */
 class QUBUNTUONESHARED_EXPORT Authentication : public QObject
 {
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * \file directorywalker.cpp
+ */
+
+#include "directorywalker.h"
+#include "directorywalker_p.h"
+
+namespace QtUbuntuOne {
+
+DirectoryWalker::DirectoryWalker(QObject *parent) :
+    QObject(parent),
+    d_ptr(new DirectoryWalkerPrivate(this))
+{
+}
+
+DirectoryWalker::DirectoryWalker(const QString &rootPath, QObject *parent) :
+    QObject(parent),
+    d_ptr(new DirectoryWalkerPrivate(rootPath, this))
+{
+}
+
+DirectoryWalker::DirectoryWalker(DirectoryWalkerPrivate &d, QObject *parent) :
+    QObject(parent),
+    d_ptr(&d)
+{
+}
+
+DirectoryWalker::~DirectoryWalker() {}
+
+/**
+ * rootPath
+ */
+QString DirectoryWalker::rootPath() const {
+    Q_D(const DirectoryWalker);
+
+    return d->rootPath();
+}
+
+/**
+ * setRootPath
+ */
+void DirectoryWalker::setRootPath(const QString &path) {
+    Q_D(DirectoryWalker);
+
+    d->setRootPath(path);
+}
+
+/**
+ * maximumDepth
+ */
+int DirectoryWalker::maximumDepth() const {
+    Q_D(const DirectoryWalker);
+
+    return d->maximumDepth();
+}
+
+/**
+ * setMaximumDepth
+ */
+void DirectoryWalker::setMaximumDepth(int depth) {
+    Q_D(DirectoryWalker);
+
+    d->setMaximumDepth(depth);
+}
+
+/**
+ * maximumConcurrentRequests
+ */
+int DirectoryWalker::maximumConcurrentRequests() const {
+    Q_D(const DirectoryWalker);
+
+    return d->maximumConcurrentRequests();
+}
+
+/**
+ * setMaximumConcurrentRequests
+ */
+void DirectoryWalker::setMaximumConcurrentRequests(int maximum) {
+    Q_D(DirectoryWalker);
+
+    d->setMaximumConcurrentRequests(maximum);
+}
+
+/**
+ * nodeFilter
+ */
+DirectoryWalker::NodeFilter DirectoryWalker::nodeFilter() const {
+    Q_D(const DirectoryWalker);
+
+    return d->nodeFilter();
+}
+
+/**
+ * setNodeFilter
+ */
+void DirectoryWalker::setNodeFilter(NodeFilter filter) {
+    Q_D(DirectoryWalker);
+
+    d->setNodeFilter(filter);
+}
+
+/**
+ * nameFilters
+ */
+QStringList DirectoryWalker::nameFilters() const {
+    Q_D(const DirectoryWalker);
+
+    return d->nameFilters();
+}
+
+/**
+ * setNameFilters
+ */
+void DirectoryWalker::setNameFilters(const QStringList &filters) {
+    Q_D(DirectoryWalker);
+
+    d->setNameFilters(filters);
+}
+
+/**
+ * session
+ */
+Session* DirectoryWalker::session() const {
+    Q_D(const DirectoryWalker);
+
+    return d->session();
+}
+
+/**
+ * setSession
+ */
+void DirectoryWalker::setSession(Session *session) {
+    Q_D(DirectoryWalker);
+
+    d->setSession(session);
+}
+
+/**
+ * directoryCount
+ */
+int DirectoryWalker::directoryCount() const {
+    Q_D(const DirectoryWalker);
+
+    return d->directoryCount();
+}
+
+/**
+ * directoriesListed
+ */
+int DirectoryWalker::directoriesListed() const {
+    Q_D(const DirectoryWalker);
+
+    return d->directoriesListed();
+}
+
+/**
+ * nodeCount
+ */
+int DirectoryWalker::nodeCount() const {
+    Q_D(const DirectoryWalker);
+
+    return d->nodeCount();
+}
+
+/**
+ * progress
+ */
+int DirectoryWalker::progress() const {
+    Q_D(const DirectoryWalker);
+
+    return d->progress();
+}
+
+/**
+ * status
+ */
+DirectoryWalker::Status DirectoryWalker::status() const {
+    Q_D(const DirectoryWalker);
+
+    return d->status();
+}
+
+/**
+ * errorString
+ */
+QString DirectoryWalker::errorString() const {
+    Q_D(const DirectoryWalker);
+
+    return d->errorString();
+}
+
+/**
+ * start
+ */
+void DirectoryWalker::start() {
+    Q_D(DirectoryWalker);
+
+    d->start();
+}
+
+/**
+ * cancel
+ */
+void DirectoryWalker::cancel() {
+    Q_D(DirectoryWalker);
+
+    d->cancel();
+}
+
+#include "moc_directorywalker.cpp"
+
+}
@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * \file directorywalker.h
+ */
+
+#ifndef DIRECTORYWALKER_H
+#define DIRECTORYWALKER_H
+
+#include "qubuntuone_global.h"
+#include <QObject>
+#include <QStringList>
+
+namespace QtUbuntuOne {
+
+class Node;
+class NodeList;
+class Session;
+class DirectoryWalkerPrivate;
+
+/**
+ * \class DirectoryWalker
+ * \brief Lists a directory and all of its subdirectories.
+ *
+ * DirectoryWalker lists the directory at rootPath() using Files::listDirectory(),
+ * and then lists each subdirectory that is found, with up to maximumConcurrentRequests()
+ * listings in progress at once. Nodes are reported by nodeFound() as each listing
+ * is received.
+ *
+ * A subdirectory that no longer exists when it is listed is skipped. Any other
+ * failed listing fails the walk.
+ */
+class QUBUNTUONESHARED_EXPORT DirectoryWalker : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QString rootPath
+               READ rootPath
+               WRITE setRootPath)
+    Q_PROPERTY(int maximumDepth
+               READ maximumDepth
+               WRITE setMaximumDepth)
+    Q_PROPERTY(int maximumConcurrentRequests
+               READ maximumConcurrentRequests
+               WRITE setMaximumConcurrentRequests)
+    Q_PROPERTY(NodeFilter nodeFilter
+               READ nodeFilter
+               WRITE setNodeFilter)
+    Q_PROPERTY(QStringList nameFilters
+               READ nameFilters
+               WRITE setNameFilters)
+    Q_PROPERTY(int directoryCount
+               READ directoryCount
+               NOTIFY progressChanged)
+    Q_PROPERTY(int directoriesListed
+               READ directoriesListed
+               NOTIFY progressChanged)
+    Q_PROPERTY(int nodeCount
+               READ nodeCount
+               NOTIFY progressChanged)
+    Q_PROPERTY(int progress
+               READ progress
+               NOTIFY progressChanged)
+    Q_PROPERTY(Status status
+               READ status
+               NOTIFY statusChanged)
+    Q_PROPERTY(QString errorString
+               READ errorString
+               NOTIFY statusChanged)
+
+    Q_ENUMS(NodeFilter Status)
+
+public:
+    /**
+     * \enum NodeFilter
+     */
+    enum NodeFilter {
+        AllNodes = 0,
+        FilesOnly,
+        DirectoriesOnly
+    };
+
+    /**
+     * \enum Status
+     */
+    enum Status {
+        Idle = 0,
+        Walking,
+        Completed,
+        Cancelled,
+        Failed
+    };
+
+    explicit DirectoryWalker(QObject *parent = 0);
+    explicit DirectoryWalker(const QString &rootPath, QObject *parent = 0);
+    ~DirectoryWalker();
+
+    /**
+     * Returns the resource path of the directory to be walked.
+     *
+     * \return QString
+     */
+    QString rootPath() const;
+
+    /**
+     * Sets the resource path of the directory to be walked, e.g. '/~/Ubuntu One'.
+     *
+     * \param QString
+     */
+    void setRootPath(const QString &path);
+
+    /**
+     * Returns the maximum number of directory levels to be listed.
+     * A depth of 1 lists only the root directory. The default is 0 (no limit).
+     *
+     * \return int
+     */
+    int maximumDepth() const;
+
+    /**
+     * Sets the maximum number of directory levels to be listed.
+     * Pass 0 for no limit.
+     *
+     * \param int
+     */
+    void setMaximumDepth(int depth);
+
+    /**
+     * Returns the maximum number of directory listings
+     * that are requested concurrently. The default is 4.
+     *
+     * \return int
+     */
+    int maximumConcurrentRequests() const;
+
+    /**
+     * Sets the maximum number of directory listings
+     * that are requested concurrently.
+     *
+     * \param int
+     */
+    void setMaximumConcurrentRequests(int maximum);
+
+    /**
+     * Returns the types of node that are reported. The default is AllNodes.
+     * Directories are listed regardless of the filter.
+     *
+     * \return NodeFilter
+     */
+    NodeFilter nodeFilter() const;
+
+    /**
+     * Sets the types of node that are reported.
+     *
+     * \param NodeFilter
+     */
+    void setNodeFilter(NodeFilter filter);
+
+    /**
+     * Returns the wildcard patterns, e.g. '*.mp3', that the names of reported files must match.
+     * Matching is case insensitive. The default is an empty list (all files are reported).
+     *
+     * \return QStringList
+     */
+    QStringList nameFilters() const;
+
+    /**
+     * Sets the wildcard patterns that the names of reported files must match.
+     *
+     * \param QStringList
+     */
+    void setNameFilters(const QStringList &filters);
+
+    /**
+     * Returns the session whose credentials sign the listing requests,
+     * or 0 if the default session is used.
+     *
+     * \return Session*
+     */
+    Session* session() const;
+
+    /**
+     * Sets the session whose credentials sign the listing requests.
+     * The session must outlive the walk. Pass 0 to use the default session.
+     *
+     * \param Session*
+     */
+    void setSession(Session *session);
+
+    /**
+     * Returns the number of directories to be listed that have been found so far,
+     * including the root directory.
+     *
+     * \return int
+     */
+    int directoryCount() const;
+
+    /**
+     * Returns the number of directories that have been listed.
+     *
+     * \return int
+     */
+    int directoriesListed() const;
+
+    /**
+     * Returns the number of nodes found so far, including those that were not reported.
+     *
+     * \return int
+     */
+    int nodeCount() const;
+
+    /**
+     * Returns the proportion of the directories found so far that have been listed (maximum is 100).
+     * As more directories are found, the progress may decrease.
+     *
+     * \return int
+     */
+    int progress() const;
+
+    /**
+     * Returns the current status of the walk.
+     *
+     * \return Status
+     */
+    Status status() const;
+
+    /**
+     * Returns the error string resulting from the walk.
+     *
+     * \return QString
+     */
+    QString errorString() const;
+
+public slots:
+    /**
+     * Starts the walk.
+     */
+    void start();
+
+    /**
+     * Cancels the walk.
+     */
+    void cancel();
+
+signals:
+    /**
+     * Emitted when a node that passes the filters is found.
+     *
+     * The node is owned by the DirectoryWalker and may be deleted once control
+     * returns to the event loop, so it should be copied if it is needed later.
+     *
+     * \param node The Node object.
+     * \param depth The depth of the node. Children of the root directory have a depth of 1.
+     */
+    void nodeFound(Node *node, int depth);
+
+    void progressChanged();
+    void statusChanged(DirectoryWalker::Status status);
+
+private:
+    explicit DirectoryWalker(DirectoryWalkerPrivate &d, QObject *parent = 0);
+
+    QScopedPointer<DirectoryWalkerPrivate> d_ptr;
+
+    Q_DECLARE_PRIVATE(DirectoryWalker)
+
+    Q_PRIVATE_SLOT(d_func(), void _q_onItemsAvailable(NodeList* list, int first, int last))
+    Q_PRIVATE_SLOT(d_func(), void _q_onDirectoryListed(NodeList* list))
+};
+
+}
+
+Q_DECLARE_METATYPE(QtUbuntuOne::DirectoryWalker::NodeFilter)
+Q_DECLARE_METATYPE(QtUbuntuOne::DirectoryWalker::Status)
+
+#endif // DIRECTORYWALKER_H
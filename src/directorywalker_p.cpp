@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "directorywalker_p.h"
+#include "files.h"
+#include "node.h"
+#include "nodelist.h"
+
+namespace QtUbuntuOne {
+
+DirectoryWalkerPrivate::DirectoryWalkerPrivate(DirectoryWalker *parent) :
+    q_ptr(parent),
+    m_maximumDepth(0),
+    m_maximumConcurrentRequests(4),
+    m_nodeFilter(DirectoryWalker::AllNodes),
+    m_session(0),
+    m_directoryCount(0),
+    m_directoriesListed(0),
+    m_nodeCount(0),
+    m_status(DirectoryWalker::Idle)
+{
+}
+
+DirectoryWalkerPrivate::DirectoryWalkerPrivate(const QString &rootPath, DirectoryWalker *parent) :
+    q_ptr(parent),
+    m_rootPath(rootPath),
+    m_maximumDepth(0),
+    m_maximumConcurrentRequests(4),
+    m_nodeFilter(DirectoryWalker::AllNodes),
+    m_session(0),
+    m_directoryCount(0),
+    m_directoriesListed(0),
+    m_nodeCount(0),
+    m_status(DirectoryWalker::Idle)
+{
+}
+
+DirectoryWalkerPrivate::~DirectoryWalkerPrivate() {
+    this->abortRequests();
+}
+
+QString DirectoryWalkerPrivate::rootPath() const {
+    return m_rootPath;
+}
+
+void DirectoryWalkerPrivate::setRootPath(const QString &path) {
+    m_rootPath = path;
+}
+
+int DirectoryWalkerPrivate::maximumDepth() const {
+    return m_maximumDepth;
+}
+
+void DirectoryWalkerPrivate::setMaximumDepth(int depth) {
+    m_maximumDepth = qMax(0, depth);
+}
+
+int DirectoryWalkerPrivate::maximumConcurrentRequests() const {
+    return m_maximumConcurrentRequests;
+}
+
+void DirectoryWalkerPrivate::setMaximumConcurrentRequests(int maximum) {
+    m_maximumConcurrentRequests = qMax(1, maximum);
+}
+
+DirectoryWalker::NodeFilter DirectoryWalkerPrivate::nodeFilter() const {
+    return m_nodeFilter;
+}
+
+void DirectoryWalkerPrivate::setNodeFilter(DirectoryWalker::NodeFilter filter) {
+    m_nodeFilter = filter;
+}
+
+QStringList DirectoryWalkerPrivate::nameFilters() const {
+    return m_nameFilters;
+}
+
+void DirectoryWalkerPrivate::setNameFilters(const QStringList &filters) {
+    m_nameFilters = filters;
+    m_nameFilterPatterns.clear();
+
+    foreach (const QString &filter, filters) {
+        m_nameFilterPatterns.append(QRegExp(filter, Qt::CaseInsensitive, QRegExp::Wildcard));
+    }
+}
+
+Session* DirectoryWalkerPrivate::session() const {
+    return m_session;
+}
+
+void DirectoryWalkerPrivate::setSession(Session *session) {
+    m_session = session;
+}
+
+int DirectoryWalkerPrivate::directoryCount() const {
+    return m_directoryCount;
+}
+
+int DirectoryWalkerPrivate::directoriesListed() const {
+    return m_directoriesListed;
+}
+
+int DirectoryWalkerPrivate::nodeCount() const {
+    return m_nodeCount;
+}
+
+int DirectoryWalkerPrivate::progress() const {
+    return m_directoryCount > 0 ? m_directoriesListed * 100 / m_directoryCount : 0;
+}
+
+DirectoryWalker::Status DirectoryWalkerPrivate::status() const {
+    return m_status;
+}
+
+void DirectoryWalkerPrivate::setStatus(DirectoryWalker::Status status) {
+    Q_Q(DirectoryWalker);
+
+    if (status != this->status()) {
+        m_status = status;
+        emit q->statusChanged(status);
+    }
+}
+
+QString DirectoryWalkerPrivate::errorString() const {
+    return m_errorString;
+}
+
+void DirectoryWalkerPrivate::setErrorString(const QString &errorString) {
+    m_errorString = errorString;
+}
+
+void DirectoryWalkerPrivate::start() {
+    Q_Q(DirectoryWalker);
+
+    if (this->status() == DirectoryWalker::Walking) {
+        return;
+    }
+
+    m_pendingDirectories.clear();
+    m_directoryCount = 1;
+    m_directoriesListed = 0;
+    m_nodeCount = 0;
+    this->setErrorString(QString());
+    emit q->progressChanged();
+
+    if (this->rootPath().isEmpty()) {
+        this->setErrorString(QObject::tr("No root path specified"));
+        this->setStatus(DirectoryWalker::Failed);
+        return;
+    }
+
+    // The root directory has a depth of 0
+    m_pendingDirectories.append(qMakePair(this->rootPath(), 0));
+    this->setStatus(DirectoryWalker::Walking);
+    this->listDirectories();
+}
+
+void DirectoryWalkerPrivate::cancel() {
+    if (this->status() == DirectoryWalker::Walking) {
+        this->abortRequests();
+        m_pendingDirectories.clear();
+        this->setStatus(DirectoryWalker::Cancelled);
+    }
+}
+
+bool DirectoryWalkerPrivate::isReported(Node *node) const {
+    if (node->nodeType() == Node::Directory) {
+        return this->nodeFilter() != DirectoryWalker::FilesOnly;
+    }
+
+    if (this->nodeFilter() == DirectoryWalker::DirectoriesOnly) {
+        return false;
+    }
+
+    if (m_nameFilterPatterns.isEmpty()) {
+        return true;
+    }
+
+    foreach (const QRegExp &pattern, m_nameFilterPatterns) {
+        if (pattern.exactMatch(node->name())) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void DirectoryWalkerPrivate::listDirectories() {
+    Q_Q(DirectoryWalker);
+
+    // Directories are listed breadth first, so that listings fan out as quickly as possible
+    while ((m_lists.size() < this->maximumConcurrentRequests()) && (!m_pendingDirectories.isEmpty())) {
+        const QPair<QString, int> directory = m_pendingDirectories.takeFirst();
+        NodeList *list = Files::listDirectory(directory.first, this->session(), NetworkSettings::BackgroundPriority);
+        m_lists.insert(list, directory.second);
+        q->connect(list, SIGNAL(itemsAvailable(NodeList*,int,int)), q, SLOT(_q_onItemsAvailable(NodeList*,int,int)));
+        q->connect(list, SIGNAL(ready(NodeList*)), q, SLOT(_q_onDirectoryListed(NodeList*)));
+    }
+
+    if (m_lists.isEmpty()) {
+        this->setStatus(DirectoryWalker::Completed);
+    }
+}
+
+void DirectoryWalkerPrivate::abortRequests() {
+    Q_Q(DirectoryWalker);
+
+    foreach (NodeList *list, m_lists.keys()) {
+        list->disconnect(q);
+        list->cancel();
+        list->deleteLater();
+    }
+
+    m_lists.clear();
+}
+
+void DirectoryWalkerPrivate::_q_onItemsAvailable(NodeList *list, int first, int last) {
+    Q_Q(DirectoryWalker);
+
+    const int depth = m_lists.value(list) + 1;
+    const bool listChildren = (this->maximumDepth() <= 0) || (depth < this->maximumDepth());
+    const QList<Node*> nodes = list->nodes();
+
+    m_nodeCount += last - first + 1;
+
+    for (int i = first; i <= last; i++) {
+        Node *node = nodes.at(i);
+
+        if ((listChildren) && (node->nodeType() == Node::Directory) && (node->hasChildren())) {
+            m_pendingDirectories.append(qMakePair(node->resourcePath(), depth));
+            m_directoryCount++;
+        }
+
+        if (this->isReported(node)) {
+            emit q->nodeFound(node, depth);
+
+            // The walk may be cancelled by a receiver
+            if (this->status() != DirectoryWalker::Walking) {
+                return;
+            }
+        }
+    }
+
+    emit q->progressChanged();
+
+    this->listDirectories();
+}
+
+void DirectoryWalkerPrivate::_q_onDirectoryListed(NodeList *list) {
+    Q_Q(DirectoryWalker);
+
+    const int depth = m_lists.take(list);
+    list->deleteLater();
+
+    // A subdirectory may be removed after its parent is listed, so it is skipped.
+    // Any other error, or an error listing the root directory, fails the walk.
+    if ((list->error() != NodeList::NoError)
+        && ((depth == 0) || ((list->error() != NodeList::ContentNotFoundError)
+                             && (list->error() != NodeList::ContentGoneError)))) {
+        this->abortRequests();
+        m_pendingDirectories.clear();
+        this->setErrorString(list->errorString());
+        this->setStatus(DirectoryWalker::Failed);
+        return;
+    }
+
+    m_directoriesListed++;
+    emit q->progressChanged();
+
+    this->listDirectories();
+}
+
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef DIRECTORYWALKER_P_H
+#define DIRECTORYWALKER_P_H
+
+#include "directorywalker.h"
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QRegExp>
+
+namespace QtUbuntuOne {
+
+class DirectoryWalkerPrivate
+{
+
+public:
+    DirectoryWalkerPrivate(DirectoryWalker *parent);
+    DirectoryWalkerPrivate(const QString &rootPath, DirectoryWalker *parent);
+    virtual ~DirectoryWalkerPrivate();
+
+    QString rootPath() const;
+    void setRootPath(const QString &path);
+
+    int maximumDepth() const;
+    void setMaximumDepth(int depth);
+
+    int maximumConcurrentRequests() const;
+    void setMaximumConcurrentRequests(int maximum);
+
+    DirectoryWalker::NodeFilter nodeFilter() const;
+    void setNodeFilter(DirectoryWalker::NodeFilter filter);
+
+    QStringList nameFilters() const;
+    void setNameFilters(const QStringList &filters);
+
+    Session* session() const;
+    void setSession(Session *session);
+
+    int directoryCount() const;
+
+    int directoriesListed() const;
+
+    int nodeCount() const;
+
+    int progress() const;
+
+    DirectoryWalker::Status status() const;
+
+    QString errorString() const;
+
+    void start();
+    void cancel();
+
+private:
+    void setStatus(DirectoryWalker::Status status);
+
+    void setErrorString(const QString &errorString);
+
+    bool isReported(Node *node) const;
+
+    void listDirectories();
+
+    void abortRequests();
+
+    void _q_onItemsAvailable(NodeList *list, int first, int last);
+    void _q_onDirectoryListed(NodeList *list);
+
+    DirectoryWalker *q_ptr;
+
+    QString m_rootPath;
+
+    int m_maximumDepth;
+
+    int m_maximumConcurrentRequests;
+
+    DirectoryWalker::NodeFilter m_nodeFilter;
+
+    QStringList m_nameFilters;
+    QList<QRegExp> m_nameFilterPatterns;
+
+    Session *m_session;
+
+    int m_directoryCount;
+
+    int m_directoriesListed;
+
+    int m_nodeCount;
+
+    DirectoryWalker::Status m_status;
+
+    QString m_errorString;
+
+    // Resource paths of directories waiting to be listed, with their depth
+    QList< QPair<QString, int> > m_pendingDirectories;
+
+    // Listings in progress, with the depth of the listed directory
+    QHash<NodeList*, int> m_lists;
+
+    Q_DECLARE_PUBLIC(DirectoryWalker)
+};
+
+}
+
+#endif // DIRECTORYWALKER_P_H
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "diskcache.h"
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+
+namespace QtUbuntuOne {
+
+static const qint64 MAX_CACHE_SIZE = 10 * 1024 * 1024;
+
+static const quint32 CACHE_MAGIC = 0x51753143;
+static const qint32 CACHE_VERSION = 1;
+
+DiskCache::DiskCache(const QString &directory, QObject *parent) :
+    QAbstractNetworkCache(parent),
+    m_directory(directory),
+    m_maximumCacheSize(MAX_CACHE_SIZE)
+{
+    QDir().mkpath(m_directory);
+}
+
+DiskCache::~DiskCache() {
+    qDeleteAll(m_pending.keys());
+}
+
+QString DiskCache::cacheDirectory() const {
+    return m_directory;
+}
+
+qint64 DiskCache::maximumCacheSize() const {
+    return m_maximumCacheSize;
+}
+
+void DiskCache::setMaximumCacheSize(qint64 size) {
+    m_maximumCacheSize = size;
+    this->expire();
+}
+
+QNetworkCacheMetaData DiskCache::metaData(const QUrl &url) {
+    QNetworkCacheMetaData metaData;
+
+    return this->read(url, metaData, 0) ? metaData : QNetworkCacheMetaData();
+}
+
+void DiskCache::updateMetaData(const QNetworkCacheMetaData &metaData) {
+    QNetworkCacheMetaData oldMetaData;
+    QByteArray data;
+
+    if (this->read(metaData.url(), oldMetaData, &data)) {
+        this->write(metaData, data);
+    }
+}
+
+QIODevice* DiskCache::data(const QUrl &url) {
+    QNetworkCacheMetaData metaData;
+    QByteArray data;
+
+    if (!this->read(url, metaData, &data)) {
+        return 0;
+    }
+
+    // The caller takes ownership of the device
+    QBuffer *buffer = new QBuffer;
+    buffer->setData(data);
+    buffer->open(QIODevice::ReadOnly);
+
+    return buffer;
+}
+
+bool DiskCache::remove(const QUrl &url) {
+    // Discard any data being prepared for the url
+    QHash<QIODevice*, QNetworkCacheMetaData>::iterator pending = m_pending.begin();
+
+    while (pending != m_pending.end()) {
+        if (pending.value().url() == url) {
+            delete pending.key();
+            pending = m_pending.erase(pending);
+        }
+        else {
+            ++pending;
+        }
+    }
+
+    return QFile::remove(this->fileName(url));
+}
+
+qint64 DiskCache::cacheSize() const {
+    qint64 size = 0;
+
+    foreach (const QFileInfo &info, QDir(m_directory).entryInfoList(QStringList("*.cache"), QDir::Files)) {
+        size += info.size();
+    }
+
+    return size;
+}
+
+QIODevice* DiskCache::prepare(const QNetworkCacheMetaData &metaData) {
+    if ((!metaData.isValid()) || (!metaData.url().isValid()) || (!metaData.saveToDisk())) {
+        return 0;
+    }
+
+    QBuffer *buffer = new QBuffer;
+    buffer->open(QIODevice::ReadWrite);
+    m_pending.insert(buffer, metaData);
+
+    return buffer;
+}
+
+void DiskCache::insert(QIODevice *device) {
+    QHash<QIODevice*, QNetworkCacheMetaData>::iterator iterator = m_pending.find(device);
+
+    if (iterator == m_pending.end()) {
+        return;
+    }
+
+    const QNetworkCacheMetaData metaData = iterator.value();
+    m_pending.erase(iterator);
+
+    const QByteArray data = static_cast<QBuffer*>(device)->data();
+    delete device;
+
+    // Entries larger than the whole cache are not kept
+    if (data.size() <= m_maximumCacheSize) {
+        if (this->write(metaData, data)) {
+            this->expire();
+        }
+    }
+}
+
+void DiskCache::discard(QIODevice *device) {
+    if (m_pending.remove(device) > 0) {
+        delete device;
+    }
+}
+
+void DiskCache::clear() {
+    QDir dir(m_directory);
+
+    foreach (const QString &file, dir.entryList(QStringList("*.cache"), QDir::Files)) {
+        dir.remove(file);
+    }
+}
+
+QString DiskCache::fileName(const QUrl &url) const {
+    return m_directory + "/" + QString::fromLatin1(QCryptographicHash::hash(url.toEncoded(),
+                                                                            QCryptographicHash::Sha1).toHex()) + ".cache";
+}
+
+bool DiskCache::read(const QUrl &url, QNetworkCacheMetaData &metaData, QByteArray *data) const {
+    QFile file(this->fileName(url));
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_7);
+
+    quint32 magic = 0;
+    qint32 version = 0;
+    stream >> magic >> version;
+
+    if ((magic != CACHE_MAGIC) || (version != CACHE_VERSION)) {
+        return false;
+    }
+
+    stream >> metaData;
+
+    if (data) {
+        stream >> *data;
+    }
+
+    // The url is compared in case two urls share a file name
+    return (stream.status() == QDataStream::Ok) && (metaData.url() == url);
+}
+
+bool DiskCache::write(const QNetworkCacheMetaData &metaData, const QByteArray &data) {
+    const QString fileName = this->fileName(metaData.url());
+    QFile file(fileName + ".tmp");
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_7);
+    stream << CACHE_MAGIC << CACHE_VERSION << metaData << data;
+    file.close();
+
+    if ((stream.status() != QDataStream::Ok) || (file.error() != QFile::NoError)) {
+        file.remove();
+        return false;
+    }
+
+    // QFile::rename() does not overwrite an existing file
+    QFile::remove(fileName);
+
+    return file.rename(fileName);
+}
+
+void DiskCache::expire() {
+    // Sorted by modification time, most recently written first
+    QFileInfoList files = QDir(m_directory).entryInfoList(QStringList("*.cache"), QDir::Files, QDir::Time);
+    qint64 size = 0;
+
+    foreach (const QFileInfo &info, files) {
+        size += info.size();
+    }
+
+    while ((size > m_maximumCacheSize) && (!files.isEmpty())) {
+        const QFileInfo info = files.takeLast();
+
+        if (QFile::remove(info.absoluteFilePath())) {
+            size -= info.size();
+        }
+    }
+}
+
+}
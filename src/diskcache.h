@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+/**
+ * \file diskcache.h
+ */
+
+#ifndef DISKCACHE_H
+#define DISKCACHE_H
+
+#include "qubuntuone_global.h"
+#include <QAbstractNetworkCache>
+#include <QHash>
+
+namespace QtUbuntuOne {
+
+/**
+ * \class DiskCache
+ * \brief An on-disk network cache for API responses.
+ *
+ * DiskCache keeps each response in its own file in cacheDirectory(), so that
+ * unchanged metadata can be answered from the cache after a 304 Not Modified
+ * response, even after the application has been restarted. Entries are
+ * evicted, least recently written first, once the total size of the cache
+ * files exceeds maximumCacheSize().
+ *
+ * \sa MemoryCache, NetworkSettings::setResponseCache()
+ */
+class QUBUNTUONESHARED_EXPORT DiskCache : public QAbstractNetworkCache
+{
+    Q_OBJECT
+
+public:
+    explicit DiskCache(const QString &directory, QObject *parent = 0);
+    ~DiskCache();
+
+    /**
+     * Returns the directory in which the cache files are stored.
+     *
+     * \return QString
+     */
+    QString cacheDirectory() const;
+
+    /**
+     * Returns the maximum total size in bytes of the cache files. The default is 10MB.
+     *
+     * \return qint64
+     */
+    qint64 maximumCacheSize() const;
+
+    /**
+     * Sets the maximum total size in bytes of the cache files.
+     *
+     * \param size
+     */
+    void setMaximumCacheSize(qint64 size);
+
+    QNetworkCacheMetaData metaData(const QUrl &url);
+    void updateMetaData(const QNetworkCacheMetaData &metaData);
+
+    QIODevice* data(const QUrl &url);
+
+    bool remove(const QUrl &url);
+
+    qint64 cacheSize() const;
+
+    QIODevice* prepare(const QNetworkCacheMetaData &metaData);
+    void insert(QIODevice *device);
+
+    /**
+     * Discards a device returned by prepare() without inserting it,
+     * leaving any cached entry for the same url in place.
+     *
+     * \param device
+     */
+    void discard(QIODevice *device);
+
+public slots:
+    void clear();
+
+private:
+    QString fileName(const QUrl &url) const;
+    bool read(const QUrl &url, QNetworkCacheMetaData &metaData, QByteArray *data) const;
+    bool write(const QNetworkCacheMetaData &metaData, const QByteArray &data);
+    void expire();
+
+    QString m_directory;
+
+    qint64 m_maximumCacheSize;
+
+    QHash<QIODevice*, QNetworkCacheMetaData> m_pending;
+};
+
+}
+
+#endif // DISKCACHE_H
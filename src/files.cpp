@@ -24,9 +24,12 @@
 #include "reply.h"
 #include "filetransfer.h"
 #include "user.h"
-#include "authentication.h"
+#include "node_p.h"
+#include "nodecache.h"
+#include "session_p.h"
+#include "requestbuilder.h"
 #include "urls.h"
-#include "networkaccessmanager.h"
+#include "json.h"
 
 namespace QtUbuntuOne {
 
@@ -40,191 +43,161 @@ Files::~Files() {}
 /**
  * getUser
  */
-User* Files::getUser() {
-    QUrl url(BASE_URL_FILES);
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+User* Files::getUser(Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_FILES), RequestBuilder::SignEncodedPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.setCacheable(true);
 
-    return new User(NetworkAccessManager::instance()->get(request));
+    return new User(builder.get());
 }
 
 /**
  * getVolumes
  */
-NodeList* Files::getVolumes() {
-    QUrl url(BASE_URL_FILES + "/volumes");
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+NodeList* Files::getVolumes(Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_FILES + "/volumes"), RequestBuilder::SignEncodedPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.setCacheable(true);
 
-    return new NodeList(NetworkAccessManager::instance()->get(request));
+    return new NodeList(builder.get());
 }
 
 /**
  * getVolume
  */
-Node* Files::getVolume(const QString &resourcePath) {
-    QUrl url(BASE_URL_FILES + resourcePath);
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Node* Files::getVolume(const QString &resourcePath, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_FILES + resourcePath), RequestBuilder::SignEncodedPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
 
-    return new Node(NetworkAccessManager::instance()->get(request));
+    return new Node(builder.get());
 }
 
 /**
  * createVolume
  */
-Node* Files::createVolume(const QString &name) {
-    QUrl url(BASE_URL_FILES + "/volumes/~/" + name);
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("PUT", url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Node* Files::createVolume(const QString &name, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_FILES + "/volumes/~/" + name), RequestBuilder::SignEncodedPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
 
-    return new Node(NetworkAccessManager::instance()->put(request, QByteArray()));
+    return new Node(builder.put());
 }
 
 /**
  * deleteVolume
  */
-Reply* Files::deleteVolume(const QString &resourcePath) {
-    QUrl url(BASE_URL_FILES + resourcePath);
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("DELETE", url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Reply* Files::deleteVolume(const QString &resourcePath, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_FILES + resourcePath), RequestBuilder::SignEncodedPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    QNetworkReply *reply = builder.deleteResource();
+    // Nodes in the volume have the volume path without the /volumes prefix
+    NodeCache::instance()->remove(QStringList() << NodeCache::key(effectiveSession(session), resourcePath.mid(resourcePath.indexOf('/', 1))), reply);
 
-    return new Reply(NetworkAccessManager::instance()->deleteResource(request));
+    return new Reply(reply);
 }
 
 /**
  * makeDirectory
  */
-Node* Files::makeDirectory(const QString &resourcePath) {
-    QUrl url(BASE_URL_FILES + resourcePath);
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("PUT", url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Node* Files::makeDirectory(const QString &resourcePath, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_FILES + resourcePath), RequestBuilder::SignEncodedPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
 
-    return new Node(NetworkAccessManager::instance()->put(request, "{ \"kind\": \"directory\" }"));
+    return new Node(builder.putJson(QtJson::JsonWriter().beginObject().key("kind").value("directory").endObject().data()));
 }
 
 /**
  * listDirectory
  */
-NodeList* Files::listDirectory(const QString &resourcePath) {
-    QUrl url(BASE_URL_FILES + resourcePath);
-#if QT_VERSION >= 0x050000
-    QUrlQuery query(url);
-    query.addQueryItem("include_children", "true");
-    url.setQuery(query);
-#else
-    url.addQueryItem("include_children", "true");
-#endif
-    QMap<QString, QString> params;
-    params["include_children"] = "true";
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), params));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+NodeList* Files::listDirectory(const QString &resourcePath, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_FILES + resourcePath), RequestBuilder::SignEncodedPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.addQueryItem("include_children", "true");
 
-    return new NodeList(NetworkAccessManager::instance()->get(request));
+    return new NodeList(builder.get());
 }
 
 /**
  * getNode
  */
-Node* Files::getNode(const QString &resourcePath) {
-    QUrl url(BASE_URL_FILES + resourcePath);
-#if QT_VERSION >= 0x050000
-    QUrlQuery query(url);
-    query.addQueryItem("include_children", "false");
-    url.setQuery(query);
-#else
-    url.addQueryItem("include_children", "false");
-#endif
-    QMap<QString, QString> params;
-    params["include_children"] = "false";
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), params));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Node* Files::getNode(const QString &resourcePath, Session *session, NetworkSettings::Priority priority) {
+    const QString key = NodeCache::key(effectiveSession(session), resourcePath);
 
-    return new Node(NetworkAccessManager::instance()->get(request));
+    if (Node *node = NodeCache::instance()->node(key)) {
+        return node;
+    }
+
+    RequestBuilder builder(QUrl(BASE_URL_FILES + resourcePath), RequestBuilder::SignEncodedPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.addQueryItem("include_children", "false");
+
+    Node *node = new Node(builder.get());
+    node->d_func()->setCacheKey(key);
+
+    return node;
 }
 
 /**
  * moveNode
  */
-Node* Files::moveNode(const QString &resourcePath, const QString &newPath) {
-    QUrl url(BASE_URL_FILES + resourcePath);
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("PUT", url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Node* Files::moveNode(const QString &resourcePath, const QString &newPath, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_FILES + resourcePath), RequestBuilder::SignEncodedPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    QNetworkReply *reply = builder.putJson(QtJson::JsonWriter().beginObject().key("path").value(newPath).endObject().data());
+    NodeCache::instance()->remove(QStringList() << NodeCache::key(effectiveSession(session), resourcePath), reply);
 
-    return new Node(NetworkAccessManager::instance()->put(request, "{ \"path\": \"" + newPath.toUtf8() + "\" }"));
+    Node *node = new Node(reply);
+    // newPath is relative to the volume, so the destination is only known from the response
+    NodeCache::instance()->removeWhenReady(effectiveSession(session), node);
+
+    return node;
 }
 
 /**
  * deleteNode
  */
-Reply* Files::deleteNode(const QString &resourcePath) {
-    QUrl url(BASE_URL_FILES + resourcePath);
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("DELETE", url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Reply* Files::deleteNode(const QString &resourcePath, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_FILES + resourcePath), RequestBuilder::SignEncodedPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    QNetworkReply *reply = builder.deleteResource();
+    NodeCache::instance()->remove(QStringList() << NodeCache::key(effectiveSession(session), resourcePath), reply);
 
-    return new Reply(NetworkAccessManager::instance()->deleteResource(request));
+    return new Reply(reply);
 }
 
 /**
  * getPublicFiles
  */
-NodeList* Files::getPublicFiles() {
-    QUrl url(BASE_URL_FILES + "/public_files");
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+NodeList* Files::getPublicFiles(Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_FILES + "/public_files"), RequestBuilder::SignEncodedPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
 
-    return new NodeList(NetworkAccessManager::instance()->get(request));
+    return new NodeList(builder.get());
 }
 
 /**
  * setFilePublic
  */
-Node* Files::setFilePublic(const QString &resourcePath, bool isPublic) {
-    QUrl url(BASE_URL_FILES + resourcePath);
-    QString json = QString("{ \"is_public\": %1 }").arg(isPublic ? "true" : "false");
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("PUT", url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Node* Files::setFilePublic(const QString &resourcePath, bool isPublic, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_FILES + resourcePath), RequestBuilder::SignEncodedPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    QNetworkReply *reply = builder.putJson(QtJson::JsonWriter().beginObject().key("is_public").value(isPublic).endObject().data());
+    NodeCache::instance()->remove(QStringList() << NodeCache::key(effectiveSession(session), resourcePath), reply);
 
-    return new Node(NetworkAccessManager::instance()->put(request, json.toUtf8()));
+    return new Node(reply);
 }
 
 /**
  * uploadFile
  */
-FileTransfer* Files::uploadFile(const QString &filePath, const QString &contentType, const QString &contentPath, bool isPublic) {
+FileTransfer* Files::uploadFile(const QString &filePath, const QString &contentType, const QString &contentPath, bool isPublic, Session *session, NetworkSettings::Priority priority) {
     FileTransfer *transfer = new FileTransfer;
     transfer->setTransferType(FileTransfer::Upload);
     transfer->setFilePath(filePath);
     transfer->setContentType(contentType.isEmpty() ? "application/octet-stream" : contentType);
     transfer->setContentPath(contentPath);
     transfer->setPublic(isPublic);
+    transfer->setSession(session);
+    transfer->setPriority(priority);
     transfer->start();
 
     return transfer;
@@ -233,15 +206,39 @@ FileTransfer* Files::uploadFile(const QString &filePath, const QString &contentT
 /**
  * downloadFile
  */
-FileTransfer* Files::downloadFile(const QString &contentPath, const QString &localPath, bool overwriteExistingFile) {
+FileTransfer* Files::downloadFile(const QString &contentPath, const QString &localPath, bool overwriteExistingFile, Session *session, NetworkSettings::Priority priority) {
     FileTransfer *transfer = new FileTransfer;
     transfer->setTransferType(FileTransfer::Download);
     transfer->setContentPath(contentPath);
     transfer->setFilePath(localPath);
     transfer->setOverwriteExistingFile(overwriteExistingFile);
+    transfer->setSession(session);
+    transfer->setPriority(priority);
     transfer->start();
 
     return transfer;
 }
 
+
+/**
+ * nodeCacheTimeToLive
+ */
+int Files::nodeCacheTimeToLive() {
+    return NodeCache::instance()->timeToLive();
+}
+
+/**
+ * setNodeCacheTimeToLive
+ */
+void Files::setNodeCacheTimeToLive(int msecs) {
+    NodeCache::instance()->setTimeToLive(msecs);
+}
+
+/**
+ * clearNodeCache
+ */
+void Files::clearNodeCache() {
+    NodeCache::instance()->clear();
+}
+
 }
@@ -23,6 +23,7 @@
 #define FILES_H
 
 #include "qubuntuone_global.h"
+#include "networksettings.h"
 #include <QObject>
 #include <QList>
 
@@ -33,6 +34,7 @@ class NodeList;
 class Reply;
 class FileTransfer;
 class User;
+class Session;
 
 /**
  * \class Files
@@ -52,77 +54,95 @@ public:
      * Requests the root for the currently authenticated user,
      * and returns a User instance that handles the response.
      *
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
+     *
      * \return User* An instance of User that contains the response metadata.
      */
-    Q_INVOKABLE static User* getUser();
+    Q_INVOKABLE static User* getUser(Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests the list of volumes for the currently authenticated user,
      * and returns a NodeList instance that handles the response.
      *
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
+     *
      * \return NodeList* An instance of NodeList that contains the response metadata.
      */
-    Q_INVOKABLE static NodeList* getVolumes();
+    Q_INVOKABLE static NodeList* getVolumes(Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests the specified volume for the currently authenticated user,
      * and returns a Node instance that handles the response.
      *
      * \param resourcePath
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Node* An instance of Node that contains the response metadata.
      */
-    Q_INVOKABLE static Node* getVolume(const QString &resourcePath);
+    Q_INVOKABLE static Node* getVolume(const QString &resourcePath, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Creates a new volume for the currently authenticated user,
      * and returns a Node instance that handles the response.
      *
      * \param name
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Node* An instance of Node that contains the response metadata.
      */
-    Q_INVOKABLE static Node* createVolume(const QString &name);
+    Q_INVOKABLE static Node* createVolume(const QString &name, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Deletes the specified volume for the currently authenticated user,
      * and returns a Reply instance that handles the response.
      *
      * \param resourcePath
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Reply* An instance of Reply that contains the response metadata.
      */
-    Q_INVOKABLE static Reply* deleteVolume(const QString &resourcePath);
+    Q_INVOKABLE static Reply* deleteVolume(const QString &resourcePath, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Creates a new directory for the currently authenticated user,
      * and returns a Node instance that handles the response.
      *
      * \param resourcePath
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Node* An instance of Node that contains the response metadata.
      */
-    Q_INVOKABLE static Node* makeDirectory(const QString &resourcePath);
+    Q_INVOKABLE static Node* makeDirectory(const QString &resourcePath, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests the children of the specified directory for the currently authenticated user,
      * and returns a NodeList instance that handles the response.
      *
      * \param resourcePath
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return NodeList* An instance of NodeList that contains the response metadata.
      */
-    Q_INVOKABLE static NodeList* listDirectory(const QString &resourcePath);
+    Q_INVOKABLE static NodeList* listDirectory(const QString &resourcePath, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::InteractivePriority);
 
     /**
      * Requests the specified node (file or directory) for the currently authenticated user,
      * and returns a Node instance that handles the response.
      *
      * \param resourcePath
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Node* An instance of Node that contains the response metadata.
      */
-    Q_INVOKABLE static Node* getNode(const QString &resourcePath);
+    Q_INVOKABLE static Node* getNode(const QString &resourcePath, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::InteractivePriority);
 
     /**
      * Moves the specified node (file or directory) for the currently authenticated user,
@@ -130,28 +150,35 @@ public:
      *
      * \param resourcePath
      * \param newPath
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Node* An instance of Node that contains the response metadata.
      */
-    Q_INVOKABLE static Node* moveNode(const QString &resourcePath, const QString &newPath);
+    Q_INVOKABLE static Node* moveNode(const QString &resourcePath, const QString &newPath, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Deletes the specified node for the currently authenticated user,
      * and returns a Reply instance that handles the response.
      *
      * \param resourcePath
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Reply* An instance of Reply that contains the response metadata.
      */
-    Q_INVOKABLE static Reply* deleteNode(const QString &resourcePath);
+    Q_INVOKABLE static Reply* deleteNode(const QString &resourcePath, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests the list of public files for the currently authenticated user,
      * and returns a NodeList instance that handles the response.
      *
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
+     *
      * \return NodeList* An instance of NodeList that contains the response metadata.
      */
-    Q_INVOKABLE static NodeList* getPublicFiles();
+    Q_INVOKABLE static NodeList* getPublicFiles(Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Sets the public status of the specified file for the currently authenticated user,
@@ -159,10 +186,12 @@ public:
      *
      * \param resourcePath
      * \param isPublic
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Node* An instance of Node that contains the response metadata.
      */
-    Q_INVOKABLE static Node* setFilePublic(const QString &resourcePath, bool isPublic);
+    Q_INVOKABLE static Node* setFilePublic(const QString &resourcePath, bool isPublic, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Starts a file upload for the currently authenticated user,
@@ -172,10 +201,12 @@ public:
      * \param contentType
      * \param contentPath
      * \param isPublic
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the transfer's requests are ordered among queued requests.
      *
      * \return FileTransfer* An instance of Reply that performs the file upload.
      */
-    Q_INVOKABLE static FileTransfer* uploadFile(const QString &filePath, const QString &contentType, const QString &contentPath, bool isPublic);
+    Q_INVOKABLE static FileTransfer* uploadFile(const QString &filePath, const QString &contentType, const QString &contentPath, bool isPublic, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::BackgroundPriority);
 
     /**
      * Starts a file download for the currently authenticated user,
@@ -184,9 +215,34 @@ public:
      * \param contentPath
      * \param localPath
      * \param overwriteExistingFile
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the transfer's requests are ordered among queued requests.
      * \return FileTransfer* An instance of Reply that performs the file download.
      */
-    Q_INVOKABLE static FileTransfer* downloadFile(const QString &contentPath, const QString &localPath, bool overwriteExistingFile);
+    Q_INVOKABLE static FileTransfer* downloadFile(const QString &contentPath, const QString &localPath, bool overwriteExistingFile, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::BackgroundPriority);
+
+    /**
+     * Returns the time in msecs for which node metadata is cached, so that getNode()
+     * can return it without making a request. The default is 0, meaning no caching.
+     *
+     * \return int
+     */
+    Q_INVOKABLE static int nodeCacheTimeToLive();
+
+    /**
+     * Sets the time in msecs for which node metadata is cached.
+     * Moving, deleting, publishing or uploading a node through Files
+     * removes its cached metadata.
+     *
+     * \param msecs
+     */
+    Q_INVOKABLE static void setNodeCacheTimeToLive(int msecs);
+
+    /**
+     * Removes all cached node metadata.
+     */
+    Q_INVOKABLE static void clearNodeCache();
+
 };
 
 }
@@ -197,6 +197,42 @@ void FileTransfer::setPublic(bool isPublic) {
     d->setPublic(isPublic);
 }
 
+/**
+ * priority
+ */
+NetworkSettings::Priority FileTransfer::priority() const {
+    Q_D(const FileTransfer);
+
+    return d->priority();
+}
+
+/**
+ * setPriority
+ */
+void FileTransfer::setPriority(NetworkSettings::Priority priority) {
+    Q_D(FileTransfer);
+
+    d->setPriority(priority);
+}
+
+/**
+ * session
+ */
+Session* FileTransfer::session() const {
+    Q_D(const FileTransfer);
+
+    return d->session();
+}
+
+/**
+ * setSession
+ */
+void FileTransfer::setSession(Session *session) {
+    Q_D(FileTransfer);
+
+    d->setSession(session);
+}
+
 /**
  * status
  */
@@ -23,12 +23,14 @@
 #define FILETRANSFER_H
 
 #include "qubuntuone_global.h"
+#include "networksettings.h"
 #include <QObject>
 #include <QNetworkReply>
 
 namespace QtUbuntuOne {
 
 class Node;
+class Session;
 class FileTransferPrivate;
 
 /**
@@ -73,6 +75,9 @@ class QUBUNTUONESHARED_EXPORT FileTransfer : public QObject
     Q_PROPERTY(bool isPublic
                READ isPublic
                WRITE setPublic)
+    Q_PROPERTY(QtUbuntuOne::NetworkSettings::Priority priority
+               READ priority
+               WRITE setPriority)
     Q_PROPERTY(Status status
                READ status
                NOTIFY statusChanged)
@@ -278,6 +283,37 @@ public:
      */
     void setPublic(bool isPublic);
 
+    /**
+     * Returns the priority of the transfer requests among queued requests.
+     * The default is NetworkSettings::BackgroundPriority.
+     *
+     * \return NetworkSettings::Priority
+     */
+    NetworkSettings::Priority priority() const;
+
+    /**
+     * Sets the priority of the transfer requests among queued requests.
+     *
+     * \param NetworkSettings::Priority
+     */
+    void setPriority(NetworkSettings::Priority priority);
+
+    /**
+     * Returns the session whose credentials sign the transfer requests,
+     * or 0 if the default session is used.
+     *
+     * \return Session*
+     */
+    Session* session() const;
+
+    /**
+     * Sets the session whose credentials sign the transfer requests.
+     * The session must outlive the transfer. Pass 0 to use the default session.
+     *
+     * \param Session*
+     */
+    void setSession(Session *session);
+
     /**
      * Returns the current status of the transfer.
      *
@@ -347,6 +383,7 @@ private:
     Q_PRIVATE_SLOT(d_func(), void _q_onReadyRead())
     Q_PRIVATE_SLOT(d_func(), void _q_onUploadFinished())
     Q_PRIVATE_SLOT(d_func(), void _q_onDownloadFinished())
+    Q_PRIVATE_SLOT(d_func(), void _q_retryDownload())
     Q_PRIVATE_SLOT(d_func(), void _q_onFilePublished(Node* node))
 };
 
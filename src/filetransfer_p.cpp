@@ -16,14 +16,17 @@
  */
 
 #include "filetransfer_p.h"
-#include "authentication.h"
 #include "files.h"
 #include "node.h"
+#include "session_p.h"
+#include "nodecache.h"
+#include "requestbuilder.h"
 #include "networkaccessmanager.h"
 #include "urls.h"
 #include "json.h"
 #include <QDir>
 #include <QDateTime>
+#include <QTimer>
 
 namespace QtUbuntuOne {
 
@@ -41,9 +44,13 @@ FileTransferPrivate::FileTransferPrivate(FileTransfer *parent) :
     m_size(0),
     m_resumePosition(0),
     m_transferredBytes(0),
+    m_rangeChecked(false),
+    m_resumeAttempts(0),
     m_progress(0),
     m_overwrite(false),
     m_public(false),
+    m_priority(NetworkSettings::BackgroundPriority),
+    m_session(0),
     m_status(FileTransfer::Queued),
     m_error(FileTransfer::NoError)
 {
@@ -82,9 +89,13 @@ FileTransferPrivate::FileTransferPrivate(FileTransfer::TransferType transferType
     m_size(0),
     m_resumePosition(0),
     m_transferredBytes(0),
+    m_rangeChecked(false),
+    m_resumeAttempts(0),
     m_progress(0),
     m_overwrite(false),
     m_public(false),
+    m_priority(NetworkSettings::BackgroundPriority),
+    m_session(0),
     m_status(FileTransfer::Queued),
     m_error(FileTransfer::NoError)
 {
@@ -276,6 +287,22 @@ void FileTransferPrivate::setPublic(bool isPublic) {
     m_public = isPublic;
 }
 
+NetworkSettings::Priority FileTransferPrivate::priority() const {
+    return m_priority;
+}
+
+void FileTransferPrivate::setPriority(NetworkSettings::Priority priority) {
+    m_priority = priority;
+}
+
+Session* FileTransferPrivate::session() const {
+    return m_session;
+}
+
+void FileTransferPrivate::setSession(Session *session) {
+    m_session = session;
+}
+
 FileTransfer::Status FileTransferPrivate::status() const {
     return m_status;
 }
@@ -362,6 +389,8 @@ void FileTransferPrivate::start() {
         return;
     }
     
+    m_resumeAttempts = 0;
+    
     switch (this->transferType()) {
     case FileTransfer::Upload:
         m_file.setFileName(this->filePath());
@@ -452,13 +481,11 @@ void FileTransferPrivate::performUpload() {
     
     this->setStatus(FileTransfer::Uploading);
     
-    QNetworkRequest request(this->url());
-    request.setHeader(QNetworkRequest::ContentTypeHeader, this->contentType());
-    request.setHeader(QNetworkRequest::ContentLengthHeader, this->size());
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("PUT", this->url().toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
-    m_reply = NetworkAccessManager::instance()->put(request, &m_file);
+    RequestBuilder builder(this->url(), RequestBuilder::SignEncodedPath, m_session);
+    builder.setPriority(RequestBuilder::Priority(this->priority()));
+    builder.setHeader(QNetworkRequest::ContentTypeHeader, this->contentType());
+    builder.setHeader(QNetworkRequest::ContentLengthHeader, this->size());
+    m_reply = builder.put(&m_file);
     q->connect(m_reply, SIGNAL(uploadProgress(qint64,qint64)), q, SLOT(_q_onProgressChanged(qint64,qint64)));
     q->connect(m_reply, SIGNAL(finished()), q, SLOT(_q_onUploadFinished()));
 }
@@ -468,15 +495,16 @@ void FileTransferPrivate::performDownload() {
     
     this->setStatus(FileTransfer::Downloading);
     
-    QNetworkRequest request(this->url());
+    RequestBuilder builder(this->url(), RequestBuilder::SignEncodedPath, m_session);
+    builder.setPriority(RequestBuilder::Priority(this->priority()));
+    builder.setAcceptJson(false);
     
     if (this->resumePosition() > 0) {
-        request.setRawHeader("Range", QByteArray::number(this->resumePosition()) + "-");
+        builder.setRawHeader("Range", "bytes=" + QByteArray::number(this->resumePosition()) + "-");
     }
     
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", this->url().toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="), QMap<QString, QString>()));
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
-    m_reply = NetworkAccessManager::instance()->get(request);
+    m_rangeChecked = false;
+    m_reply = builder.get();
     q->connect(m_reply, SIGNAL(downloadProgress(qint64,qint64)), q, SLOT(_q_onProgressChanged(qint64,qint64)));
     q->connect(m_reply, SIGNAL(readyRead()), q, SLOT(_q_onReadyRead()));
     q->connect(m_reply, SIGNAL(finished()), q, SLOT(_q_onDownloadFinished()));
@@ -495,7 +523,7 @@ void FileTransferPrivate::getMetaData() {
     
     this->setStatus(FileTransfer::Connecting);
     
-    Node *node = Files::getNode(this->contentPath().remove(0, 8));
+    Node *node = Files::getNode(this->contentPath().remove(0, 8), m_session, this->priority());
     q->connect(node, SIGNAL(ready(Node*)), q, SLOT(_q_setMetaData(Node*)));
 }
 
@@ -538,11 +566,60 @@ void FileTransferPrivate::_q_onProgressChanged(qint64 transferred, qint64 total)
 }
 
 void FileTransferPrivate::_q_onReadyRead() {
-    if (m_reply) {
+    if ((m_reply) && (this->checkRange())) {
         m_file.write(m_reply->readAll());
     }
 }
 
+bool FileTransferPrivate::checkRange() {
+    /* A resumed download must continue from the end of the partial file. If the server sends the whole file instead,
+       the partial file is truncated, and if it sends a different range, the download is restarted from the beginning.
+    */
+    
+    if (m_rangeChecked) {
+        return true;
+    }
+    
+    const int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    
+    if ((status < 200) || (status >= 300)) {
+        // Error responses are handled when the reply is finished
+        return false;
+    }
+    
+    m_rangeChecked = true;
+    
+    if (this->resumePosition() <= 0) {
+        return true;
+    }
+    
+    if (status == 206) {
+        // Content-Range: bytes <first>-<last>/<length>
+        const QByteArray range = m_reply->rawHeader("Content-Range").trimmed();
+        
+        if ((range.startsWith("bytes ")) && (range.mid(6, range.indexOf('-') - 6).trimmed().toLongLong() == this->resumePosition())) {
+            return true;
+        }
+        
+        Q_Q(FileTransfer);
+        
+        m_reply->disconnect(q);
+        m_reply->abort();
+        m_reply->deleteLater();
+        m_reply = 0;
+        m_file.resize(0);
+        this->setResumePosition(0);
+        m_transferredBytes = 0;
+        this->performDownload();
+        return false;
+    }
+    
+    m_file.resize(0);
+    this->setResumePosition(0);
+    
+    return true;
+}
+
 void FileTransferPrivate::_q_onUploadFinished() {
     m_file.close();
     
@@ -572,13 +649,15 @@ void FileTransferPrivate::_q_onUploadFinished() {
         }
         
         bool ok;
-        QString response(m_reply->readAll());
+        QByteArray response(m_reply->readAll());
         QVariant result = QtJson::Json::parse(response, ok);
         
         m_reply->deleteLater();
         m_reply = 0;
         
         if (ok) {
+            NodeCache::instance()->remove(NodeCache::key(effectiveSession(m_session), result.toMap().value("resource_path").toString()));
+
             if (this->isPublic()) {
                 this->publishFile(result.toMap().value("resource_path").toString());
             }
@@ -624,6 +703,12 @@ void FileTransferPrivate::_q_onDownloadFinished() {
             m_reply = 0;
             return;
         default:
+            if (this->retryDownload()) {
+                m_reply->deleteLater();
+                m_reply = 0;
+                return;
+            }
+            
             this->setError(FileTransfer::Error(m_reply->error()));
             this->setErrorString(m_reply->errorString());
             this->setStatus(FileTransfer::Failed);
@@ -636,6 +721,45 @@ void FileTransferPrivate::_q_onDownloadFinished() {
     }
 }
 
+bool FileTransferPrivate::retryDownload() {
+    /* The network access manager only retries requests that fail before any data is received,
+       so resume from the end of the partial file if the connection dropped after some data was written.
+    */
+    
+    Q_Q(FileTransfer);
+    
+    if ((!NetworkAccessManager::isTransientError(m_reply->error())) || (m_transferredBytes <= 0) || (!m_rangeChecked)) {
+        return false;
+    }
+    
+    NetworkAccessManager *manager = NetworkAccessManager::instance();
+    
+    if ((m_resumeAttempts >= manager->maximumRetries()) || (!manager->takeRetryToken())) {
+        return false;
+    }
+    
+    m_file.write(m_reply->readAll());
+    m_file.flush();
+    this->setResumePosition(m_file.size());
+    m_transferredBytes = 0;
+    QTimer::singleShot(manager->backoffDelay(m_resumeAttempts), q, SLOT(_q_retryDownload()));
+    m_resumeAttempts++;
+    
+    return true;
+}
+
+void FileTransferPrivate::_q_retryDownload() {
+    switch (this->status()) {
+    case FileTransfer::Downloading:
+        this->performDownload();
+        return;
+    default:
+        // Paused or cancelled while waiting
+        m_file.close();
+        return;
+    }
+}
+
 void FileTransferPrivate::renameDownloadedFile() {
     QString fileName = this->filePath();
     
@@ -660,7 +784,7 @@ void FileTransferPrivate::renameDownloadedFile() {
 void FileTransferPrivate::publishFile(const QString &resourcePath) {
     Q_Q(FileTransfer);
     
-    Node *node = Files::setFilePublic(resourcePath, true);
+    Node *node = Files::setFilePublic(resourcePath, true, m_session, this->priority());
     q->connect(node, SIGNAL(ready(Node*)), q, SLOT(_q_onFilePublished(Node*)));
 }
 
@@ -66,6 +66,12 @@ public:
     bool isPublic() const;
     void setPublic(bool isPublic);
 
+    NetworkSettings::Priority priority() const;
+    void setPriority(NetworkSettings::Priority priority);
+
+    Session* session() const;
+    void setSession(Session *session);
+
     FileTransfer::Status status() const;
     QString statusString() const;
 
@@ -100,6 +106,10 @@ private:
     void performUpload();
     void performDownload();
 
+    bool checkRange();
+
+    bool retryDownload();
+
     void getMetaData();
 
     void _q_setMetaData(Node *node);
@@ -111,6 +121,7 @@ private:
 
     void _q_onUploadFinished();
     void _q_onDownloadFinished();
+    void _q_retryDownload();
 
     void _q_onFilePublished(Node *node);
 
@@ -138,12 +149,21 @@ private:
 
     qint64 m_transferredBytes;
 
+    bool m_rangeChecked;
+
+    // Resumes since the transfer was started, so that the backoff grows on a flaky connection
+    int m_resumeAttempts;
+
     int m_progress;
 
     bool m_overwrite;
 
     bool m_public;
 
+    NetworkSettings::Priority m_priority;
+
+    Session *m_session;
+
     FileTransfer::Status m_status;
 
     FileTransfer::Error m_error;
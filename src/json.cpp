@@ -31,558 +31,2729 @@
  */
 
 #include "json.h"
-#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define QTJSON_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define QTJSON_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(QTJSON_SSE2)
+#include <intrin.h>
+#endif
 
 namespace QtJson
 {
 
 
-static QString sanitizeString(QString str)
+static inline bool isWhitespace(char c)
+{
+        return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+}
+
+static inline bool isNumberChar(char c)
+{
+        return ((c >= '0') && (c <= '9')) || (c == '+') || (c == '-') || (c == '.')
+                || (c == 'e') || (c == 'E');
+}
+
+#ifdef QTJSON_SSE2
+/**
+ * Returns the index of the lowest set bit in a non-zero mask
+ */
+static inline int firstBit(uint mask)
 {
-        str.replace(QLatin1String("\\"), QLatin1String("\\\\"));
-        str.replace(QLatin1String("\""), QLatin1String("\\\""));
-        str.replace(QLatin1String("\b"), QLatin1String("\\b"));
-        str.replace(QLatin1String("\f"), QLatin1String("\\f"));
-        str.replace(QLatin1String("\n"), QLatin1String("\\n"));
-        str.replace(QLatin1String("\r"), QLatin1String("\\r"));
-        str.replace(QLatin1String("\t"), QLatin1String("\\t"));
-        return QString(QLatin1String("\"%1\"")).arg(str);
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return int(index);
+#else
+        return __builtin_ctz(mask);
+#endif
 }
+#endif
 
-static QByteArray join(const QList<QByteArray> &list, const QByteArray &sep)
+/**
+ * Returns the index of the first byte from index that is not whitespace,
+ * or size if there is none
+ */
+static inline int skipWhitespace(const char *data, int size, int index)
 {
-        QByteArray res;
-        Q_FOREACH(const QByteArray &i, list)
+        //Most tokens are preceded by no whitespace at all
+        if((index < size) && (!isWhitespace(data[index])))
+        {
+                return index;
+        }
+
+#ifdef QTJSON_AVX2
+        const __m256i space32 = _mm256_set1_epi8(' ');
+        const __m256i tab32 = _mm256_set1_epi8('\t');
+        const __m256i newline32 = _mm256_set1_epi8('\n');
+        const __m256i carriage32 = _mm256_set1_epi8('\r');
+
+        while(size - index >= 32)
+        {
+                const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + index));
+                const __m256i whitespace = _mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space32), _mm256_cmpeq_epi8(chunk, tab32)),
+                        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, newline32), _mm256_cmpeq_epi8(chunk, carriage32)));
+                const uint mask = ~uint(_mm256_movemask_epi8(whitespace));
+
+                if(mask)
+                {
+                        return index + firstBit(mask);
+                }
+
+                index += 32;
+        }
+#endif
+
+#ifdef QTJSON_SSE2
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i newline = _mm_set1_epi8('\n');
+        const __m128i carriage = _mm_set1_epi8('\r');
+
+        while(size - index >= 16)
         {
-                if(!res.isEmpty())
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + index));
+                const __m128i whitespace = _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                        _mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, carriage)));
+                const uint mask = ~uint(_mm_movemask_epi8(whitespace)) & 0xffff;
+
+                if(mask)
                 {
-                        res += sep;
+                        return index + firstBit(mask);
                 }
-                res += i;
+
+                index += 16;
+        }
+#endif
+
+        while((index < size) && (isWhitespace(data[index])))
+        {
+                index++;
         }
-        return res;
+
+        return index;
 }
 
 /**
- * parse
+ * Returns the index of the first quote or backslash from index,
+ * or size if there is none
  */
-QVariant Json::parse(const QString &json)
+static inline int findQuoteOrBackslash(const char *data, int size, int index)
 {
-        bool success = true;
-        return Json::parse(json, success);
+#ifdef QTJSON_AVX2
+        const __m256i quote32 = _mm256_set1_epi8('\"');
+        const __m256i backslash32 = _mm256_set1_epi8('\\');
+
+        while(size - index >= 32)
+        {
+                const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + index));
+                const uint mask = uint(_mm256_movemask_epi8(
+                        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote32), _mm256_cmpeq_epi8(chunk, backslash32))));
+
+                if(mask)
+                {
+                        return index + firstBit(mask);
+                }
+
+                index += 32;
+        }
+#endif
+
+#ifdef QTJSON_SSE2
+        const __m128i quote = _mm_set1_epi8('\"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+
+        while(size - index >= 16)
+        {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + index));
+                const uint mask = uint(_mm_movemask_epi8(
+                        _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash))));
+
+                if(mask)
+                {
+                        return index + firstBit(mask);
+                }
+
+                index += 16;
+        }
+#endif
+
+        while((index < size) && (data[index] != '\"') && (data[index] != '\\'))
+        {
+                index++;
+        }
+
+        return index;
 }
 
 /**
- * parse
+ * Returns the index of the first byte from index that must be escaped in
+ * a JSON string (a quote, a backslash or a control character), or size if
+ * there is none
  */
-QVariant Json::parse(const QString &json, bool &success)
+static inline int findEscapable(const char *data, int size, int index)
 {
-        success = true;
+#ifdef QTJSON_SSE2
+        const __m128i quote = _mm_set1_epi8('\"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control = _mm_set1_epi8(0x1f);
+
+        while(size - index >= 16)
+        {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + index));
+                //Unsigned c <= 0x1f is equivalent to min(c, 0x1f) == c
+                const __m128i escapable = _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                        _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));
+                const uint mask = uint(_mm_movemask_epi8(escapable));
+
+                if(mask)
+                {
+                        return index + firstBit(mask);
+                }
+
+                index += 16;
+        }
+#endif
 
-        //Return an empty QVariant if the JSON data is either null or empty
-        if(!json.isNull() || !json.isEmpty())
+        while(index < size)
         {
-                QString data = json;
-                //We'll start from index 0
-                int index = 0;
+                const uchar c = data[index];
 
-                //Parse the first value
-                QVariant value = Json::parseValue(data, index, success);
+                if((c < 0x20) || (c == '\"') || (c == '\\'))
+                {
+                        break;
+                }
 
-                //Return the parsed value
-                return value;
+                index++;
         }
-        else
+
+        return index;
+}
+
+/**
+ * Appends the size bytes of UTF-8 data to out as a quoted JSON string,
+ * escaping in a single pass
+ */
+static void appendString(QByteArray &out, const char *data, int size)
+{
+        static const char hex[] = "0123456789abcdef";
+        int start = 0;
+
+        out.append('\"');
+
+        for(int i = findEscapable(data, size, 0); i < size; i = findEscapable(data, size, i + 1))
         {
-                //Return the empty QVariant
-                return QVariant();
+                const uchar c = data[i];
+
+                //Copy the run of plain characters before the escape
+                out.append(data + start, i - start);
+                start = i + 1;
+
+                switch(c)
+                {
+                        case '\"':
+                                out.append("\\\"", 2);
+                                break;
+                        case '\\':
+                                out.append("\\\\", 2);
+                                break;
+                        case '\b':
+                                out.append("\\b", 2);
+                                break;
+                        case '\f':
+                                out.append("\\f", 2);
+                                break;
+                        case '\n':
+                                out.append("\\n", 2);
+                                break;
+                        case '\r':
+                                out.append("\\r", 2);
+                                break;
+                        case '\t':
+                                out.append("\\t", 2);
+                                break;
+                        default:
+                        {
+                                const char escape[] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+                                out.append(escape, 6);
+                                break;
+                        }
+                }
         }
+
+        out.append(data + start, size - start);
+        out.append('\"');
 }
 
-QByteArray Json::serialize(const QVariant &data)
+/**
+ * Appends str to out as a quoted JSON string
+ */
+static void appendString(QByteArray &out, const QString &str)
 {
-        bool success = true;
-        return Json::serialize(data, success);
+        const QByteArray utf8 = str.toUtf8();
+        appendString(out, utf8.constData(), utf8.size());
 }
 
-QByteArray Json::serialize(const QVariant &data, bool &success)
+/**
+ * Appends the JSON representation of data to out
+ */
+static bool serializeValue(const QVariant &data, QByteArray &out, JsonFormat format)
 {
-        QByteArray str;
-        success = true;
+        const bool compact = (format == JsonFormatCompact);
 
         if(!data.isValid()) // invalid or null?
         {
-                str = "null";
+                out.append("null", 4);
         }
         else if((data.type() == QVariant::List) || (data.type() == QVariant::StringList)) // variant is a list?
         {
-                QList<QByteArray> values;
                 const QVariantList list = data.toList();
-                Q_FOREACH(const QVariant& v, list)
+
+                out.append(compact ? "[" : "[ ");
+
+                for(int i = 0; i < list.size(); i++)
                 {
-                        QByteArray serializedValue = serialize(v);
-                        if(serializedValue.isNull())
+                        if(i > 0)
                         {
-                                success = false;
-                                break;
+                                out.append(compact ? "," : ", ");
+                        }
+
+                        if(!serializeValue(list.at(i), out, format))
+                        {
+                                return false;
                         }
-                        values << serializedValue;
                 }
 
-                str = "[ " + join( values, ", " ) + " ]";
+                out.append(compact ? "]" : " ]");
         }
         else if(data.type() == QVariant::Map) // variant is a map?
         {
                 const QVariantMap vmap = data.toMap();
                 QMapIterator<QString, QVariant> it( vmap );
-                str = "{ ";
-                QList<QByteArray> pairs;
-                while(it.hasNext())
+
+                out.append(compact ? "{" : "{ ");
+
+                for(bool first = true; it.hasNext(); first = false)
                 {
                         it.next();
-                        QByteArray serializedValue = serialize(it.value());
-                        if(serializedValue.isNull())
+
+                        if(!first)
                         {
-                                success = false;
-                                break;
+                                out.append(compact ? "," : ", ");
+                        }
+
+                        appendString(out, it.key());
+                        out.append(compact ? ":" : " : ");
+
+                        if(!serializeValue(it.value(), out, format))
+                        {
+                                return false;
                         }
-                        pairs << sanitizeString(it.key()).toUtf8() + " : " + serializedValue;
                 }
-                str += join(pairs, ", ");
-                str += " }";
+
+                out.append(compact ? "}" : " }");
         }
         else if((data.type() == QVariant::String) || (data.type() == QVariant::ByteArray)) // a string or a byte array?
         {
-                str = sanitizeString(data.toString()).toUtf8();
+                appendString(out, data.toString());
         }
         else if(data.type() == QVariant::Double) // double?
         {
-                str = QByteArray::number(data.toDouble());
+                const QByteArray str = QByteArray::number(data.toDouble());
+                out.append(str);
+
                 if(!str.contains(".") && ! str.contains("e"))
                 {
-                        str += ".0";
+                        out.append(".0", 2);
                 }
         }
         else if (data.type() == QVariant::Bool) // boolean value?
         {
-                str = data.toBool() ? "true" : "false";
+                out.append(data.toBool() ? "true" : "false");
         }
         else if (data.type() == QVariant::ULongLong) // large unsigned number?
         {
-                str = QByteArray::number(data.value<qulonglong>());
+                out.append(QByteArray::number(data.value<qulonglong>()));
         }
         else if ( data.canConvert<qlonglong>() ) // any signed number?
         {
-                str = QByteArray::number(data.value<qlonglong>());
+                out.append(QByteArray::number(data.value<qlonglong>()));
         }
         else if (data.canConvert<long>())
         {
-                str = QString::number(data.value<long>()).toUtf8();
+                out.append(QString::number(data.value<long>()).toUtf8());
         }
         else if (data.canConvert<QString>()) // can value be converted to string?
         {
                 // this will catch QDate, QDateTime, QUrl, ...
-                str = sanitizeString(data.toString()).toUtf8();
-        }
-        else
-        {
-                success = false;
-        }
-        if (success)
-        {
-                return str;
+                appendString(out, data.toString());
         }
         else
         {
-                return QByteArray();
+                return false;
         }
+
+        return true;
 }
 
-/**
- * parseValue
- */
-QVariant Json::parseValue(const QString &json, int &index, bool &success)
+static bool readHex4(const char *data, int size, int &index, uint &symbol)
 {
-        //Determine what kind of data we should parse by
-        //checking out the upcoming token
-        switch(Json::lookAhead(json, index))
+        if(size - index < 4)
         {
-                case JsonTokenString:
-                        return Json::parseString(json, index, success);
-                case JsonTokenNumber:
-                        return Json::parseNumber(json, index);
-                case JsonTokenCurlyOpen:
-                        return Json::parseObject(json, index, success);
-                case JsonTokenSquaredOpen:
-                        return Json::parseArray(json, index, success);
-                case JsonTokenTrue:
-                        Json::nextToken(json, index);
-                        return QVariant(true);
-                case JsonTokenFalse:
-                        Json::nextToken(json, index);
-                        return QVariant(false);
-                case JsonTokenNull:
-                        Json::nextToken(json, index);
-                        return QVariant();
-                case JsonTokenNone:
-                        break;
+                return false;
         }
 
-        //If there were no tokens, flag the failure and return an empty QVariant
-        success = false;
-        return QVariant();
-}
-
-/**
- * parseObject
- */
-QVariant Json::parseObject(const QString &json, int &index, bool &success)
-{
-        QVariantMap map;
-        int token;
-
-        //Get rid of the whitespace and increment index
-        Json::nextToken(json, index);
+        symbol = 0;
 
-        //Loop through all of the key/value pairs of the object
-        bool done = false;
-        while(!done)
+        for(int i = 0; i < 4; i++)
         {
-                //Get the upcoming token
-                token = Json::lookAhead(json, index);
+                char c = data[index + i];
+                symbol <<= 4;
 
-                if(token == JsonTokenNone)
+                if((c >= '0') && (c <= '9'))
                 {
-                         success = false;
-                         return QVariantMap();
+                        symbol |= c - '0';
                 }
-                else if(token == JsonTokenComma)
+                else if((c >= 'a') && (c <= 'f'))
                 {
-                        Json::nextToken(json, index);
+                        symbol |= c - 'a' + 10;
                 }
-                else if(token == JsonTokenCurlyClose)
+                else if((c >= 'A') && (c <= 'F'))
                 {
-                        Json::nextToken(json, index);
-                        return map;
+                        symbol |= c - 'A' + 10;
                 }
                 else
                 {
-                        //Parse the key/value pair's name
-                        QString name = Json::parseString(json, index, success).toString();
-
-                        if(!success)
-                        {
-                                return QVariantMap();
-                        }
-
-                        //Get the next token
-                        token = Json::nextToken(json, index);
-
-                        //If the next token is not a colon, flag the failure
-                        //return an empty QVariant
-                        if(token != JsonTokenColon)
-                        {
-                                success = false;
-                                return QVariant(QVariantMap());
-                        }
-
-                        //Parse the key/value pair's value
-                        QVariant value = Json::parseValue(json, index, success);
-
-                        if(!success)
-                        {
-                                return QVariantMap();
-                        }
-
-                        //Assign the value to the key in the map
-                        map[name] = value;
+                        return false;
                 }
         }
 
-        //Return the map successfully
-        return QVariant(map);
+        index += 4;
+        return true;
+}
+
+static void appendUtf8(QByteArray &s, uint symbol)
+{
+        if(symbol < 0x80)
+        {
+                s.append(char(symbol));
+        }
+        else if(symbol < 0x800)
+        {
+                s.append(char(0xc0 | (symbol >> 6)));
+                s.append(char(0x80 | (symbol & 0x3f)));
+        }
+        else if(symbol < 0x10000)
+        {
+                s.append(char(0xe0 | (symbol >> 12)));
+                s.append(char(0x80 | ((symbol >> 6) & 0x3f)));
+                s.append(char(0x80 | (symbol & 0x3f)));
+        }
+        else
+        {
+                s.append(char(0xf0 | (symbol >> 18)));
+                s.append(char(0x80 | ((symbol >> 12) & 0x3f)));
+                s.append(char(0x80 | ((symbol >> 6) & 0x3f)));
+                s.append(char(0x80 | (symbol & 0x3f)));
+        }
 }
 
 /**
- * parseArray
+ * Decodes the string starting at the opening quote at index. On success
+ * index is left after the closing quote, otherwise at the offending byte.
  */
-QVariant Json::parseArray(const QString &json, int &index, bool &success)
+static bool readString(const char *data, int size, int &index, QString &result)
 {
-        QVariantList list;
+        //Skip the opening quote
+        if((index == size) || (data[index] != '\"'))
+        {
+                return false;
+        }
 
-        Json::nextToken(json, index);
+        index++;
 
-        bool done = false;
-        while(!done)
+        //Find the end of the plain run of characters. Strings without escapes
+        //(the vast majority) are decoded straight from the network buffer.
+        int start = index;
+
+        index = findQuoteOrBackslash(data, size, index);
+
+        if(index == size)
         {
-                int token = Json::lookAhead(json, index);
+                return false;
+        }
 
-                if(token == JsonTokenNone)
+        if(data[index] == '\"')
+        {
+                index++;
+                result = QString::fromUtf8(data + start, index - start - 1);
+                return true;
+        }
+
+        //The string contains escapes, so unescape it into a UTF-8 buffer
+        //and decode the whole buffer at once
+        QByteArray s;
+        s.reserve(index - start + 16);
+        index = start;
+
+        while(index < size)
+        {
+                int runStart = index;
+
+                index = findQuoteOrBackslash(data, size, index);
+
+                s.append(data + runStart, index - runStart);
+
+                if(index == size)
                 {
-                        success = false;
-                        return QVariantList();
+                        break;
                 }
-                else if(token == JsonTokenComma)
+
+                char c = data[index++];
+
+                if(c == '\"')
                 {
-                        Json::nextToken(json, index);
+                        result = QString::fromUtf8(s.constData(), s.size());
+                        return true;
                 }
-                else if(token == JsonTokenSquaredClose)
+
+                if(index == size)
                 {
-                        Json::nextToken(json, index);
                         break;
                 }
-                else
-                {
+
+                c = data[index++];
+
+                switch(c)
+                {
+                        case '\"':
+                        case '\\':
+                        case '/':
+                                s.append(c);
+                                break;
+                        case 'b':
+                                s.append('\b');
+                                break;
+                        case 'f':
+                                s.append('\f');
+                                break;
+                        case 'n':
+                                s.append('\n');
+                                break;
+                        case 'r':
+                                s.append('\r');
+                                break;
+                        case 't':
+                                s.append('\t');
+                                break;
+                        case 'u':
+                        {
+                                uint symbol = 0;
+
+                                if(!readHex4(data, size, index, symbol))
+                                {
+                                        return false;
+                                }
+
+                                //Combine UTF-16 surrogate pairs into one code point
+                                if((symbol >= 0xd800) && (symbol < 0xdc00) && (index + 1 < size)
+                                        && (data[index] == '\\') && (data[index + 1] == 'u'))
+                                {
+                                        int lowIndex = index + 2;
+                                        uint low = 0;
+
+                                        if((readHex4(data, size, lowIndex, low)) && (low >= 0xdc00) && (low < 0xe000))
+                                        {
+                                                symbol = 0x10000 + ((symbol - 0xd800) << 10) + (low - 0xdc00);
+                                                index = lowIndex;
+                                        }
+                                }
+
+                                appendUtf8(s, symbol);
+                                break;
+                        }
+                        default:
+                                break;
+                }
+        }
+
+        return false;
+}
+
+/**
+ * Converts the number spanning length bytes at data. Integers are
+ * converted in place, without allocating; a negative integer becomes a
+ * qlonglong and a positive one a qulonglong, preserving all 64 bits.
+ */
+static QVariant numberValue(const char *data, int length)
+{
+        const bool negative = (length > 0) && (data[0] == '-');
+        const qulonglong limit = negative ? qulonglong(Q_INT64_C(0x7fffffffffffffff)) + 1
+                                          : Q_UINT64_C(0xffffffffffffffff);
+        qulonglong magnitude = 0;
+        int i = negative ? 1 : 0;
+        bool integer = (i < length);
+
+        for(; (integer) && (i < length); i++)
+        {
+                const uint digit = uint(data[i] - '0');
+
+                if((digit > 9) || (magnitude > (limit - digit) / 10))
+                {
+                        integer = false;
+                }
+                else
+                {
+                        magnitude = magnitude * 10 + digit;
+                }
+        }
+
+        if(integer)
+        {
+                if(negative)
+                {
+                        return QVariant(qlonglong(0 - magnitude));
+                }
+
+                return QVariant(magnitude);
+        }
+
+        //A fraction, an exponent or an integer too large for 64 bits
+        const QByteArray numberStr(data, length);
+        bool ok = false;
+        const double value = numberStr.toDouble(&ok);
+
+        if(ok)
+        {
+                return QVariant(value);
+        }
+
+        //Not a number, but Json::parse() has always accepted these
+        if(negative)
+        {
+                return QVariant(numberStr.toLongLong(NULL));
+        }
+
+        return QVariant(numberStr.toULongLong(NULL));
+}
+
+/**
+ * parse
+ */
+QVariant Json::parse(const QString &json)
+{
+        bool success = true;
+        return Json::parse(json, success);
+}
+
+/**
+ * parse
+ */
+QVariant Json::parse(const QString &json, bool &success)
+{
+        //A null string holds no data, so there is nothing to fail on
+        if(json.isNull())
+        {
+                success = true;
+                return QVariant();
+        }
+
+        return Json::parse(json.toUtf8(), success);
+}
+
+/**
+ * parse
+ */
+QVariant Json::parse(const QByteArray &json)
+{
+        bool success = true;
+        return Json::parse(json, success);
+}
+
+/**
+ * parse
+ */
+QVariant Json::parse(const QByteArray &json, bool &success)
+{
+        int errorOffset = -1;
+        return Json::parse(json, success, errorOffset);
+}
+
+/**
+ * parse
+ */
+QVariant Json::parse(const QByteArray &json, bool &success, int &errorOffset)
+{
+        success = true;
+        errorOffset = -1;
+
+        //We'll start from index 0
+        int index = 0;
+
+        //Parse the first value
+        QVariant value = Json::parseValue(json, index, success);
+
+        if(!success)
+        {
+                //The failing routine leaves index at the offending byte
+                errorOffset = index;
+                return QVariant();
+        }
+
+        //Return the parsed value
+        return value;
+}
+
+QByteArray Json::serialize(const QVariant &data)
+{
+        bool success = true;
+        return Json::serialize(data, success);
+}
+
+QByteArray Json::serialize(const QVariant &data, bool &success)
+{
+        return Json::serialize(data, success, JsonFormatPadded);
+}
+
+QByteArray Json::serialize(const QVariant &data, JsonFormat format)
+{
+        bool success = true;
+        return Json::serialize(data, success, format);
+}
+
+QByteArray Json::serialize(const QVariant &data, bool &success, JsonFormat format)
+{
+        QByteArray str;
+        str.reserve(256);
+        success = serializeValue(data, str, format);
+
+        if (success)
+        {
+                return str;
+        }
+        else
+        {
+                return QByteArray();
+        }
+}
+
+/**
+ * parseValue
+ */
+QVariant Json::parseValue(const QByteArray &json, int &index, bool &success)
+{
+        //Determine what kind of data we should parse by
+        //checking out the upcoming token
+        switch(Json::lookAhead(json, index))
+        {
+                case JsonTokenString:
+                        return Json::parseString(json, index, success);
+                case JsonTokenNumber:
+                        return Json::parseNumber(json, index);
+                case JsonTokenCurlyOpen:
+                        return Json::parseObject(json, index, success);
+                case JsonTokenSquaredOpen:
+                        return Json::parseArray(json, index, success);
+                case JsonTokenTrue:
+                        Json::nextToken(json, index);
+                        return QVariant(true);
+                case JsonTokenFalse:
+                        Json::nextToken(json, index);
+                        return QVariant(false);
+                case JsonTokenNull:
+                        Json::nextToken(json, index);
+                        return QVariant();
+                case JsonTokenNone:
+                        break;
+        }
+
+        //If there were no tokens, flag the failure and return an empty QVariant
+        Json::eatWhitespace(json, index);
+        success = false;
+        return QVariant();
+}
+
+/**
+ * parseObject
+ */
+QVariant Json::parseObject(const QByteArray &json, int &index, bool &success)
+{
+        QVariantMap map;
+        int token;
+
+        //Get rid of the whitespace and increment index
+        Json::nextToken(json, index);
+
+        //Loop through all of the key/value pairs of the object
+        bool done = false;
+        while(!done)
+        {
+                //Get the upcoming token
+                token = Json::lookAhead(json, index);
+
+                if(token == JsonTokenNone)
+                {
+                        Json::eatWhitespace(json, index);
+                        success = false;
+                        return QVariantMap();
+                }
+                else if(token == JsonTokenComma)
+                {
+                        Json::nextToken(json, index);
+                }
+                else if(token == JsonTokenCurlyClose)
+                {
+                        Json::nextToken(json, index);
+                        return map;
+                }
+                else
+                {
+                        //Parse the key/value pair's name
+                        QString name = Json::parseString(json, index, success).toString();
+
+                        if(!success)
+                        {
+                                return QVariantMap();
+                        }
+
+                        //Get the next token
+                        Json::eatWhitespace(json, index);
+                        int colonIndex = index;
+                        token = Json::nextToken(json, index);
+
+                        //If the next token is not a colon, flag the failure
+                        //return an empty QVariant
+                        if(token != JsonTokenColon)
+                        {
+                                index = colonIndex;
+                                success = false;
+                                return QVariant(QVariantMap());
+                        }
+
+                        //Parse the key/value pair's value
                         QVariant value = Json::parseValue(json, index, success);
 
-                        if(!success)
-                        {
-                                return QVariantList();
-                        }
+                        if(!success)
+                        {
+                                return QVariantMap();
+                        }
+
+                        //Assign the value to the key in the map
+                        map[name] = value;
+                }
+        }
+
+        //Return the map successfully
+        return QVariant(map);
+}
+
+/**
+ * parseArray
+ */
+QVariant Json::parseArray(const QByteArray &json, int &index, bool &success)
+{
+        QVariantList list;
+
+        Json::nextToken(json, index);
+
+        bool done = false;
+        while(!done)
+        {
+                int token = Json::lookAhead(json, index);
+
+                if(token == JsonTokenNone)
+                {
+                        Json::eatWhitespace(json, index);
+                        success = false;
+                        return QVariantList();
+                }
+                else if(token == JsonTokenComma)
+                {
+                        Json::nextToken(json, index);
+                }
+                else if(token == JsonTokenSquaredClose)
+                {
+                        Json::nextToken(json, index);
+                        break;
+                }
+                else
+                {
+                        QVariant value = Json::parseValue(json, index, success);
+
+                        if(!success)
+                        {
+                                return QVariantList();
+                        }
+
+                        list.push_back(value);
+                }
+        }
+
+        return QVariant(list);
+}
+
+/**
+ * parseString
+ */
+QVariant Json::parseString(const QByteArray &json, int &index, bool &success)
+{
+        QString s;
+
+        Json::eatWhitespace(json, index);
+
+        if(!readString(json.constData(), json.size(), index, s))
+        {
+                success = false;
+                return QVariant();
+        }
+
+        return QVariant(s);
+}
+
+/**
+ * parseNumber
+ */
+QVariant Json::parseNumber(const QByteArray &json, int &index)
+{
+        Json::eatWhitespace(json, index);
+
+        int lastIndex = Json::lastIndexOfNumber(json, index);
+        int charLength = (lastIndex - index) + 1;
+        QVariant number = numberValue(json.constData() + index, charLength);
+
+        index = lastIndex + 1;
+
+        return number;
+}
+
+/**
+ * lastIndexOfNumber
+ */
+int Json::lastIndexOfNumber(const QByteArray &json, int index)
+{
+        const char *data = json.constData();
+        int lastIndex;
+
+        for(lastIndex = index; lastIndex < json.size(); lastIndex++)
+        {
+                if(!isNumberChar(data[lastIndex]))
+                {
+                        break;
+                }
+        }
+
+        return lastIndex -1;
+}
+
+/**
+ * eatWhitespace
+ */
+void Json::eatWhitespace(const QByteArray &json, int &index)
+{
+        index = skipWhitespace(json.constData(), json.size(), index);
+}
+
+/**
+ * lookAhead
+ */
+int Json::lookAhead(const QByteArray &json, int index)
+{
+        int saveIndex = index;
+        return Json::nextToken(json, saveIndex);
+}
+
+/**
+ * nextToken
+ */
+int Json::nextToken(const QByteArray &json, int &index)
+{
+        Json::eatWhitespace(json, index);
+
+        if(index == json.size())
+        {
+                return JsonTokenNone;
+        }
+
+        const char *data = json.constData();
+        char c = data[index];
+        index++;
+        switch(c)
+        {
+                case '{': return JsonTokenCurlyOpen;
+                case '}': return JsonTokenCurlyClose;
+                case '[': return JsonTokenSquaredOpen;
+                case ']': return JsonTokenSquaredClose;
+                case ',': return JsonTokenComma;
+                case '"': return JsonTokenString;
+                case '0': case '1': case '2': case '3': case '4':
+                case '5': case '6': case '7': case '8': case '9':
+                case '-': return JsonTokenNumber;
+                case ':': return JsonTokenColon;
+        }
+
+        index--;
+
+        int remainingLength = json.size() - index;
+
+        //True
+        if((remainingLength >= 4) && (qstrncmp(data + index, "true", 4) == 0))
+        {
+                index += 4;
+                return JsonTokenTrue;
+        }
+
+        //False
+        if((remainingLength >= 5) && (qstrncmp(data + index, "false", 5) == 0))
+        {
+                index += 5;
+                return JsonTokenFalse;
+        }
+
+        //Null
+        if((remainingLength >= 4) && (qstrncmp(data + index, "null", 4) == 0))
+        {
+                index += 4;
+                return JsonTokenNull;
+        }
+
+        return JsonTokenNone;
+}
+
+
+/**
+ * Returns the length of the number token at index, or 0 if the bytes do
+ * not form a valid JSON number. When the token runs to the end of the
+ * data, complete is set to false.
+ */
+static int numberLength(const char *data, int size, int index, bool &complete)
+{
+        int end = index;
+
+        while((end < size) && (isNumberChar(data[end])))
+        {
+                end++;
+        }
+
+        complete = (end < size);
+
+        int i = index;
+
+        if(data[i] == '-')
+        {
+                i++;
+        }
+
+        if((i == end) || (data[i] < '0') || (data[i] > '9'))
+        {
+                return 0;
+        }
+
+        if((data[i] == '0') && (i + 1 < end) && (data[i + 1] >= '0') && (data[i + 1] <= '9'))
+        {
+                return 0;
+        }
+
+        while((i < end) && (data[i] >= '0') && (data[i] <= '9'))
+        {
+                i++;
+        }
+
+        if((i < end) && (data[i] == '.'))
+        {
+                i++;
+
+                if((i == end) || (data[i] < '0') || (data[i] > '9'))
+                {
+                        return 0;
+                }
+
+                while((i < end) && (data[i] >= '0') && (data[i] <= '9'))
+                {
+                        i++;
+                }
+        }
+
+        if((i < end) && ((data[i] == 'e') || (data[i] == 'E')))
+        {
+                i++;
+
+                if((i < end) && ((data[i] == '+') || (data[i] == '-')))
+                {
+                        i++;
+                }
+
+                if((i == end) || (data[i] < '0') || (data[i] > '9'))
+                {
+                        return 0;
+                }
+
+                while((i < end) && (data[i] >= '0') && (data[i] <= '9'))
+                {
+                        i++;
+                }
+        }
+
+        return (i == end) ? end - index : 0;
+}
+
+/**
+ * Returns the index of the closing quote of the string starting at the
+ * opening quote at index, or -1 if the string is not yet complete.
+ *
+ * The search resumes at index + scanned, where an earlier call for the same
+ * string stopped, and scanned is updated if the string is still incomplete
+ */
+static int closingQuote(const char *data, int size, int index, int &scanned)
+{
+        int i = findQuoteOrBackslash(data, size, index + qMax(scanned, 1));
+
+        while(i < size)
+        {
+                if(data[i] == '\"')
+                {
+                        scanned = 0;
+                        return i;
+                }
+
+                i = findQuoteOrBackslash(data, size, i + 2);
+        }
+
+        //Past the end if the last byte is a backslash, so that the escaped byte is skipped
+        scanned = i - index;
+        return -1;
+}
+
+static int closingQuote(const char *data, int size, int index)
+{
+        int scanned = 0;
+        return closingQuote(data, size, index, scanned);
+}
+
+/**
+ * Returns true if the escape sequences of the string between the quotes
+ * at start and end are valid
+ */
+static bool validEscapes(const char *data, int start, int end)
+{
+        for(int i = start + 1; i < end; i++)
+        {
+                if(data[i] != '\\')
+                {
+                        continue;
+                }
+
+                i++;
+
+                switch(data[i])
+                {
+                        case '\"':
+                        case '\\':
+                        case '/':
+                        case 'b':
+                        case 'f':
+                        case 'n':
+                        case 'r':
+                        case 't':
+                                break;
+                        case 'u':
+                        {
+                                int index = i + 1;
+                                uint symbol;
+
+                                if(!readHex4(data, end, index, symbol))
+                                {
+                                        return false;
+                                }
+
+                                i = index - 1;
+                                break;
+                        }
+                        default:
+                                return false;
+                }
+        }
+
+        return true;
+}
+
+/**
+ * JsonKeyTable
+ */
+JsonKeyTable::JsonKeyTable(const char * const keys[], int count) :
+        m_keys(keys),
+        m_seed(0),
+        m_mask(7)
+{
+        while(m_mask < uint(count) * 2)
+        {
+                m_mask = (m_mask << 1) | 1;
+        }
+
+        //Search for a seed that maps every key to its own slot,
+        //growing the table if none is found
+        while(true)
+        {
+                for(m_seed = 1; m_seed <= 1024; m_seed++)
+                {
+                        m_slots.fill(-1, m_mask + 1);
+
+                        bool collision = false;
+
+                        for(int i = 0; (i < count) && (!collision); i++)
+                        {
+                                const QString key = QString::fromLatin1(keys[i]);
+                                int &slot = m_slots[hash(key.utf16(), key.size(), m_seed) & m_mask];
+
+                                if(slot == -1)
+                                {
+                                        slot = i;
+                                }
+                                else
+                                {
+                                        collision = true;
+                                }
+                        }
+
+                        if(!collision)
+                        {
+                                return;
+                        }
+                }
+
+                m_mask = (m_mask << 1) | 1;
+        }
+}
+
+/**
+ * indexOf
+ */
+int JsonKeyTable::indexOf(const QString &key) const
+{
+        const int index = m_slots.at(hash(key.utf16(), key.size(), m_seed) & m_mask);
+
+        if((index == -1) || (key != QLatin1String(m_keys[index])))
+        {
+                return -1;
+        }
+
+        return index;
+}
+
+/**
+ * hash
+ */
+uint JsonKeyTable::hash(const ushort *data, int size, uint seed)
+{
+        uint h = 2166136261u ^ (seed * 0x9e3779b9u);
+
+        for(int i = 0; i < size; i++)
+        {
+                h ^= data[i];
+                h *= 16777619u;
+        }
+
+        return h ^ (h >> 15);
+}
+
+/**
+ * JsonStreamParser
+ */
+JsonStreamParser::JsonStreamParser(JsonHandler *handler) :
+        m_handler(handler),
+        m_offset(0),
+        m_scanned(0),
+        m_state(StateValue),
+        m_errorOffset(-1)
+{
+}
+
+/**
+ * feed
+ */
+bool JsonStreamParser::feed(const QByteArray &data)
+{
+        if(this->hasError())
+        {
+                return false;
+        }
+
+        if(m_buffer.isEmpty())
+        {
+                m_buffer = data;
+        }
+        else
+        {
+                m_buffer.append(data);
+        }
+
+        return this->parseBuffer(false);
+}
+
+/**
+ * finish
+ */
+bool JsonStreamParser::finish()
+{
+        if((!this->hasError()) && (this->parseBuffer(true)) && (m_state != StateDone))
+        {
+                this->setError(m_buffer.size());
+        }
+
+        return !this->hasError();
+}
+
+/**
+ * hasError
+ */
+bool JsonStreamParser::hasError() const
+{
+        return m_errorOffset != -1;
+}
+
+/**
+ * errorOffset
+ */
+int JsonStreamParser::errorOffset() const
+{
+        return m_errorOffset;
+}
+
+/**
+ * isComplete
+ */
+bool JsonStreamParser::isComplete() const
+{
+        return (m_state == StateDone) && (!this->hasError());
+}
+
+/**
+ * reset
+ */
+void JsonStreamParser::reset()
+{
+        m_buffer.clear();
+        m_containers.clear();
+        m_offset = 0;
+        m_scanned = 0;
+        m_state = StateValue;
+        m_errorOffset = -1;
+}
+
+/**
+ * parseBuffer
+ */
+bool JsonStreamParser::parseBuffer(bool final)
+{
+        const char *data = m_buffer.constData();
+        const int size = m_buffer.size();
+        int index = 0;
+
+        while(true)
+        {
+                index = skipWhitespace(data, size, index);
+
+                if(index == size)
+                {
+                        break;
+                }
+
+                const char c = data[index];
+
+                if(m_state == StateDone)
+                {
+                        return this->setError(index);
+                }
+
+                if(m_state == StateColon)
+                {
+                        if(c != ':')
+                        {
+                                return this->setError(index);
+                        }
+
+                        m_state = StateValue;
+                        index++;
+                        continue;
+                }
+
+                if(m_state == StateCommaOrEnd)
+                {
+                        const char container = m_containers.at(m_containers.size() - 1);
+
+                        if(c == ',')
+                        {
+                                m_state = (container == '{') ? StateKey : StateValue;
+                        }
+                        else if((c == '}') && (container == '{'))
+                        {
+                                m_containers.chop(1);
+                                m_handler->endObject();
+                                this->valueCompleted();
+                        }
+                        else if((c == ']') && (container == '['))
+                        {
+                                m_containers.chop(1);
+                                m_handler->endArray();
+                                this->valueCompleted();
+                        }
+                        else
+                        {
+                                return this->setError(index);
+                        }
+
+                        index++;
+                        continue;
+                }
+
+                if((m_state == StateKey) || (m_state == StateKeyOrObjectEnd))
+                {
+                        if((c == '}') && (m_state == StateKeyOrObjectEnd))
+                        {
+                                m_containers.chop(1);
+                                m_handler->endObject();
+                                this->valueCompleted();
+                                index++;
+                                continue;
+                        }
+
+                        if(c != '\"')
+                        {
+                                return this->setError(index);
+                        }
+
+                        //m_scanned is only set for an incomplete string kept at the start of the buffer
+                        const int end = closingQuote(data, size, index, m_scanned);
+
+                        if(end == -1)
+                        {
+                                break;
+                        }
+
+                        QString key;
+
+                        if((!validEscapes(data, index, end)) || (!readString(data, end + 1, index, key)))
+                        {
+                                return this->setError(index);
+                        }
+
+                        m_handler->key(key);
+                        m_state = StateColon;
+                        continue;
+                }
+
+                //StateValue or StateValueOrArrayEnd
+                if((c == ']') && (m_state == StateValueOrArrayEnd))
+                {
+                        m_containers.chop(1);
+                        m_handler->endArray();
+                        this->valueCompleted();
+                        index++;
+                }
+                else if(c == '{')
+                {
+                        m_containers.append('{');
+                        m_handler->startObject();
+                        m_state = StateKeyOrObjectEnd;
+                        index++;
+                }
+                else if(c == '[')
+                {
+                        m_containers.append('[');
+                        m_handler->startArray();
+                        m_state = StateValueOrArrayEnd;
+                        index++;
+                }
+                else if(c == '\"')
+                {
+                        //m_scanned is only set for an incomplete string kept at the start of the buffer
+                        const int end = closingQuote(data, size, index, m_scanned);
+
+                        if(end == -1)
+                        {
+                                break;
+                        }
+
+                        QString value;
+
+                        if((!validEscapes(data, index, end)) || (!readString(data, end + 1, index, value)))
+                        {
+                                return this->setError(index);
+                        }
+
+                        m_handler->value(QVariant(value));
+                        this->valueCompleted();
+                }
+                else if((c == '-') || ((c >= '0') && (c <= '9')))
+                {
+                        bool complete = false;
+                        const int length = numberLength(data, size, index, complete);
+
+                        if((!complete) && (!final))
+                        {
+                                break;
+                        }
+
+                        if(length == 0)
+                        {
+                                return this->setError(index);
+                        }
+
+                        m_handler->value(numberValue(data + index, length));
+                        this->valueCompleted();
+                        index += length;
+                }
+                else
+                {
+                        const char *literal = (c == 't') ? "true" : (c == 'f') ? "false" : (c == 'n') ? "null" : 0;
+
+                        if(!literal)
+                        {
+                                return this->setError(index);
+                        }
+
+                        const int length = qstrlen(literal);
+                        const int available = qMin(length, size - index);
+
+                        if(qstrncmp(data + index, literal, available) != 0)
+                        {
+                                return this->setError(index);
+                        }
+
+                        if(available < length)
+                        {
+                                if(final)
+                                {
+                                        return this->setError(index);
+                                }
+
+                                break;
+                        }
+
+                        m_handler->value(c == 'n' ? QVariant() : QVariant(c == 't'));
+                        this->valueCompleted();
+                        index += length;
+                }
+        }
+
+        //Keep only the incomplete token, if any, for the next chunk
+        if(index == size)
+        {
+                m_buffer.clear();
+        }
+        else if(index > 0)
+        {
+                m_buffer.remove(0, index);
+        }
+
+        m_offset += index;
+
+        if((final) && (!m_buffer.isEmpty()))
+        {
+                return this->setError(0);
+        }
+
+        return true;
+}
+
+/**
+ * valueCompleted
+ */
+void JsonStreamParser::valueCompleted()
+{
+        m_state = m_containers.isEmpty() ? StateDone : StateCommaOrEnd;
+}
+
+/**
+ * setError
+ */
+bool JsonStreamParser::setError(int position)
+{
+        m_errorOffset = m_offset + position;
+        return false;
+}
+
+/**
+ * JsonArrayReader
+ */
+JsonArrayReader::JsonArrayReader(const QStringList &path) :
+        m_path(path),
+        m_depth(0),
+        m_arrayDepth(-1),
+        m_valid(false)
+{
+}
+
+/**
+ * path
+ */
+QStringList JsonArrayReader::path() const
+{
+        return m_path;
+}
+
+/**
+ * setPath
+ */
+void JsonArrayReader::setPath(const QStringList &path)
+{
+        m_path = path;
+}
+
+/**
+ * isValid
+ */
+bool JsonArrayReader::isValid() const
+{
+        return m_valid;
+}
+
+/**
+ * startObject
+ */
+void JsonArrayReader::startObject()
+{
+        this->startContainer(true);
+}
+
+/**
+ * endObject
+ */
+void JsonArrayReader::endObject()
+{
+        this->endContainer();
+}
+
+/**
+ * startArray
+ */
+void JsonArrayReader::startArray()
+{
+        this->startContainer(false);
+}
+
+/**
+ * endArray
+ */
+void JsonArrayReader::endArray()
+{
+        this->endContainer();
+}
+
+/**
+ * key
+ */
+void JsonArrayReader::key(const QString &key)
+{
+        if((m_arrayDepth != -1) && (m_depth > m_arrayDepth + 1))
+        {
+                m_items.last().key = key;
+        }
+        else if(m_arrayDepth == -1)
+        {
+                m_keys.last() = key;
+        }
+}
+
+/**
+ * value
+ */
+void JsonArrayReader::value(const QVariant &value)
+{
+        if(m_arrayDepth == -1)
+        {
+                return;
+        }
+
+        if(m_depth == m_arrayDepth + 1)
+        {
+                this->readItem(value);
+        }
+        else
+        {
+                this->addValue(value);
+        }
+}
+
+/**
+ * startContainer
+ */
+void JsonArrayReader::startContainer(bool isObject)
+{
+        if(m_depth == 0)
+        {
+                m_valid = true;
+        }
+
+        if((m_arrayDepth != -1) && (m_depth > m_arrayDepth))
+        {
+                //A container within an item
+                if((isObject) && (m_items.isEmpty()))
+                {
+                        this->beginItem();
+                }
+
+                Container container;
+                container.isObject = isObject;
+                m_items.append(container);
+        }
+        else if(m_arrayDepth == -1)
+        {
+                if((!isObject) && (this->isTargetArray()))
+                {
+                        m_arrayDepth = m_depth;
+                }
+
+                m_keys.append(QString());
+                m_kinds.append(isObject ? '{' : '[');
+        }
+
+        m_depth++;
+}
+
+/**
+ * endContainer
+ */
+void JsonArrayReader::endContainer()
+{
+        m_depth--;
+
+        if((m_arrayDepth != -1) && (m_depth > m_arrayDepth))
+        {
+                Container container = m_items.takeLast();
+
+                if((m_items.isEmpty()) && (container.isObject))
+                {
+                        this->endItem();
+                }
+                else if(m_items.isEmpty())
+                {
+                        this->readItem(QVariant(container.list));
+                }
+                else
+                {
+                        this->addValue(container.isObject ? QVariant(container.map) : QVariant(container.list));
+                }
+        }
+        else
+        {
+                if(m_depth == m_arrayDepth)
+                {
+                        m_arrayDepth = -1;
+                }
+
+                m_keys.removeLast();
+                m_kinds.chop(1);
+        }
+}
+
+/**
+ * addValue
+ */
+void JsonArrayReader::addValue(const QVariant &value)
+{
+        Container &container = m_items.last();
+
+        if((m_items.size() == 1) && (container.isObject))
+        {
+                this->readItemValue(container.key, value);
+        }
+        else if(container.isObject)
+        {
+                container.map.insert(container.key, value);
+        }
+        else
+        {
+                container.list.append(value);
+        }
+}
+
+/**
+ * beginItem
+ */
+void JsonArrayReader::beginItem()
+{
+        m_item.clear();
+}
+
+/**
+ * readItemValue
+ */
+void JsonArrayReader::readItemValue(const QString &key, const QVariant &value)
+{
+        m_item.insert(key, value);
+}
+
+/**
+ * endItem
+ */
+void JsonArrayReader::endItem()
+{
+        const QVariantMap item = m_item;
+        m_item.clear();
+        this->readItem(QVariant(item));
+}
+
+/**
+ * isTargetArray
+ */
+bool JsonArrayReader::isTargetArray() const
+{
+        if(m_depth == 0)
+        {
+                return true;
+        }
+
+        if((m_depth != m_path.size()) || (m_kinds.contains('[')))
+        {
+                return false;
+        }
+
+        return m_keys == m_path;
+}
+
+/**
+ * JsonObjectReader
+ */
+JsonObjectReader::JsonObjectReader(const QStringList &path) :
+        m_path(path),
+        m_depth(0),
+        m_objectDepth(-1),
+        m_valid(false),
+        m_found(false)
+{
+}
+
+/**
+ * path
+ */
+QStringList JsonObjectReader::path() const
+{
+        return m_path;
+}
+
+/**
+ * setPath
+ */
+void JsonObjectReader::setPath(const QStringList &path)
+{
+        m_path = path;
+}
+
+/**
+ * isValid
+ */
+bool JsonObjectReader::isValid() const
+{
+        return m_valid;
+}
+
+/**
+ * isFound
+ */
+bool JsonObjectReader::isFound() const
+{
+        return m_found;
+}
+
+/**
+ * startObject
+ */
+void JsonObjectReader::startObject()
+{
+        this->startContainer(true);
+}
+
+/**
+ * endObject
+ */
+void JsonObjectReader::endObject()
+{
+        this->endContainer();
+}
+
+/**
+ * startArray
+ */
+void JsonObjectReader::startArray()
+{
+        this->startContainer(false);
+}
+
+/**
+ * endArray
+ */
+void JsonObjectReader::endArray()
+{
+        this->endContainer();
+}
+
+/**
+ * key
+ */
+void JsonObjectReader::key(const QString &key)
+{
+        if(m_objectDepth == -1)
+        {
+                if(!m_keys.isEmpty())
+                {
+                        m_keys.last() = key;
+                }
+        }
+        else if(m_depth > m_objectDepth + 1)
+        {
+                m_values.last().key = key;
+        }
+        else
+        {
+                m_member = key;
+        }
+}
+
+/**
+ * value
+ */
+void JsonObjectReader::value(const QVariant &value)
+{
+        if(m_objectDepth == -1)
+        {
+                return;
+        }
+
+        if(m_depth == m_objectDepth + 1)
+        {
+                this->readItemValue(m_member, value);
+        }
+        else
+        {
+                this->addValue(value);
+        }
+}
+
+/**
+ * startContainer
+ */
+void JsonObjectReader::startContainer(bool isObject)
+{
+        if(m_depth == 0)
+        {
+                m_valid = true;
+        }
+
+        if(m_objectDepth != -1)
+        {
+                //A container within a member value
+                Container container;
+                container.isObject = isObject;
+                m_values.append(container);
+        }
+        else if((isObject) && (!m_found) && (this->isTargetObject()))
+        {
+                m_objectDepth = m_depth;
+                this->beginItem();
+        }
+        else
+        {
+                m_keys.append(QString());
+                m_kinds.append(isObject ? '{' : '[');
+        }
+
+        m_depth++;
+}
+
+/**
+ * endContainer
+ */
+void JsonObjectReader::endContainer()
+{
+        m_depth--;
+
+        if((m_objectDepth != -1) && (m_depth > m_objectDepth))
+        {
+                Container container = m_values.takeLast();
+                const QVariant value = container.isObject ? QVariant(container.map) : QVariant(container.list);
+
+                if(m_values.isEmpty())
+                {
+                        this->readItemValue(m_member, value);
+                }
+                else
+                {
+                        this->addValue(value);
+                }
+        }
+        else if(m_objectDepth != -1)
+        {
+                m_objectDepth = -1;
+                m_found = true;
+                this->endItem();
+        }
+        else
+        {
+                m_keys.removeLast();
+                m_kinds.chop(1);
+        }
+}
+
+/**
+ * addValue
+ */
+void JsonObjectReader::addValue(const QVariant &value)
+{
+        Container &container = m_values.last();
+
+        if(container.isObject)
+        {
+                container.map.insert(container.key, value);
+        }
+        else
+        {
+                container.list.append(value);
+        }
+}
+
+/**
+ * beginItem
+ */
+void JsonObjectReader::beginItem()
+{
+}
+
+/**
+ * endItem
+ */
+void JsonObjectReader::endItem()
+{
+}
+
+/**
+ * isTargetObject
+ */
+bool JsonObjectReader::isTargetObject() const
+{
+        if((m_depth != m_path.size()) || (m_kinds.contains('[')))
+        {
+                return false;
+        }
+
+        return m_keys == m_path;
+}
+
+/**
+ * A value in the node table of a JsonDocument. Strings, keys and numbers
+ * are ranges of the source data; the children of a container follow it
+ * in the table and are chained through next.
+ */
+struct JsonNode
+{
+        JsonValue::Type type;
+        int offset;
+        int length;
+        int keyOffset;
+        int keyLength;
+        int count;
+        int next;
+};
+
+/**
+ * JsonDocumentData
+ */
+class JsonDocumentData : public QSharedData
+{
+        public:
+                bool parse();
+
+                QString string(int offset, int length) const;
+
+                QVariant toVariant(int index) const;
+
+                QByteArray json;
+
+                QVector<JsonNode> nodes;
+};
+
+/**
+ * parse
+ */
+bool JsonDocumentData::parse()
+{
+        enum State
+        {
+                StateValue,
+                StateValueOrArrayEnd,
+                StateKeyOrObjectEnd,
+                StateKey,
+                StateColon,
+                StateCommaOrEnd,
+                StateDone
+        };
+
+        const char *data = json.constData();
+        const int size = json.size();
+        int index = 0;
+        State state = StateValue;
+        int keyOffset = -1;
+        int keyLength = 0;
+        QVector<int> open;
+        QVector<int> last;
+
+        nodes.reserve(size / 16 + 1);
+
+        while(true)
+        {
+                index = skipWhitespace(data, size, index);
+
+                if(index == size)
+                {
+                        return state == StateDone;
+                }
+
+                const char c = data[index];
+
+                if(state == StateDone)
+                {
+                        return false;
+                }
+
+                if(state == StateColon)
+                {
+                        if(c != ':')
+                        {
+                                return false;
+                        }
+
+                        state = StateValue;
+                        index++;
+                        continue;
+                }
+
+                const bool objectEnd = (c == '}') && ((state == StateKeyOrObjectEnd)
+                                || ((state == StateCommaOrEnd) && (nodes.at(open.last()).type == JsonValue::Object)));
+                const bool arrayEnd = (c == ']') && ((state == StateValueOrArrayEnd)
+                                || ((state == StateCommaOrEnd) && (nodes.at(open.last()).type == JsonValue::Array)));
+
+                if((objectEnd) || (arrayEnd))
+                {
+                        open.removeLast();
+                        last.removeLast();
+                        state = open.isEmpty() ? StateDone : StateCommaOrEnd;
+                        index++;
+                        continue;
+                }
+
+                if(state == StateCommaOrEnd)
+                {
+                        if(c != ',')
+                        {
+                                return false;
+                        }
+
+                        state = (nodes.at(open.last()).type == JsonValue::Object) ? StateKey : StateValue;
+                        index++;
+                        continue;
+                }
+
+                if((state == StateKey) || (state == StateKeyOrObjectEnd))
+                {
+                        const int end = (c == '\"') ? closingQuote(data, size, index) : -1;
+
+                        if((end == -1) || (!validEscapes(data, index, end)))
+                        {
+                                return false;
+                        }
+
+                        keyOffset = index;
+                        keyLength = end + 1 - index;
+                        state = StateColon;
+                        index = end + 1;
+                        continue;
+                }
+
+                //StateValue or StateValueOrArrayEnd
+                JsonNode node;
+                node.offset = index;
+                node.keyOffset = keyOffset;
+                node.keyLength = keyLength;
+                node.count = 0;
+                node.next = -1;
+
+                if(c == '{')
+                {
+                        node.type = JsonValue::Object;
+                        node.length = 1;
+                }
+                else if(c == '[')
+                {
+                        node.type = JsonValue::Array;
+                        node.length = 1;
+                }
+                else if(c == '\"')
+                {
+                        const int end = closingQuote(data, size, index);
+
+                        if((end == -1) || (!validEscapes(data, index, end)))
+                        {
+                                return false;
+                        }
+
+                        node.type = JsonValue::String;
+                        node.length = end + 1 - index;
+                }
+                else if((c == '-') || ((c >= '0') && (c <= '9')))
+                {
+                        bool complete;
+                        node.type = JsonValue::Number;
+                        node.length = numberLength(data, size, index, complete);
+
+                        if(node.length == 0)
+                        {
+                                return false;
+                        }
+                }
+                else if((c == 't') && (size - index >= 4) && (qstrncmp(data + index, "true", 4) == 0))
+                {
+                        node.type = JsonValue::Bool;
+                        node.length = 4;
+                }
+                else if((c == 'f') && (size - index >= 5) && (qstrncmp(data + index, "false", 5) == 0))
+                {
+                        node.type = JsonValue::Bool;
+                        node.length = 5;
+                }
+                else if((c == 'n') && (size - index >= 4) && (qstrncmp(data + index, "null", 4) == 0))
+                {
+                        node.type = JsonValue::Null;
+                        node.length = 4;
+                }
+                else
+                {
+                        return false;
+                }
+
+                const int nodeIndex = nodes.size();
+                nodes.append(node);
+                keyOffset = -1;
+                keyLength = 0;
+                index += node.length;
+
+                if(!open.isEmpty())
+                {
+                        nodes[open.last()].count++;
+
+                        if(last.last() != -1)
+                        {
+                                nodes[last.last()].next = nodeIndex;
+                        }
+
+                        last.last() = nodeIndex;
+                }
+
+                if(node.type == JsonValue::Object)
+                {
+                        open.append(nodeIndex);
+                        last.append(-1);
+                        state = StateKeyOrObjectEnd;
+                }
+                else if(node.type == JsonValue::Array)
+                {
+                        open.append(nodeIndex);
+                        last.append(-1);
+                        state = StateValueOrArrayEnd;
+                }
+                else
+                {
+                        state = open.isEmpty() ? StateDone : StateCommaOrEnd;
+                }
+        }
+}
+
+/**
+ * string
+ */
+QString JsonDocumentData::string(int offset, int length) const
+{
+        QString result;
+        int index = offset;
+        readString(json.constData(), offset + length, index, result);
+        return result;
+}
+
+/**
+ * toVariant
+ */
+QVariant JsonDocumentData::toVariant(int index) const
+{
+        const JsonNode &node = nodes.at(index);
+
+        switch(node.type)
+        {
+                case JsonValue::Bool:
+                        return QVariant(node.length == 4);
+                case JsonValue::Number:
+                        return numberValue(json.constData() + node.offset, node.length);
+                case JsonValue::String:
+                        return QVariant(this->string(node.offset, node.length));
+                case JsonValue::Array:
+                {
+                        QVariantList list;
+                        list.reserve(node.count);
+
+                        for(int child = (node.count > 0) ? index + 1 : -1; child != -1; child = nodes.at(child).next)
+                        {
+                                list.append(this->toVariant(child));
+                        }
+
+                        return QVariant(list);
+                }
+                case JsonValue::Object:
+                {
+                        QVariantMap map;
+
+                        for(int child = (node.count > 0) ? index + 1 : -1; child != -1; child = nodes.at(child).next)
+                        {
+                                const JsonNode &member = nodes.at(child);
+                                map.insert(this->string(member.keyOffset, member.keyLength), this->toVariant(child));
+                        }
+
+                        return QVariant(map);
+                }
+                default:
+                        return QVariant();
+        }
+}
+
+/**
+ * JsonValue
+ */
+JsonValue::JsonValue() :
+        m_index(-1)
+{
+}
+
+JsonValue::JsonValue(JsonDocumentData *data, int index) :
+        d(data),
+        m_index(index)
+{
+}
+
+JsonValue::JsonValue(const JsonValue &other) :
+        d(other.d),
+        m_index(other.m_index)
+{
+}
+
+JsonValue::~JsonValue()
+{
+}
+
+JsonValue &JsonValue::operator=(const JsonValue &other)
+{
+        d = other.d;
+        m_index = other.m_index;
+        return *this;
+}
+
+/**
+ * type
+ */
+JsonValue::Type JsonValue::type() const
+{
+        return d ? d->nodes.at(m_index).type : Undefined;
+}
+
+/**
+ * isUndefined
+ */
+bool JsonValue::isUndefined() const
+{
+        return this->type() == Undefined;
+}
 
-                        list.push_back(value);
-                }
-        }
+/**
+ * isArray
+ */
+bool JsonValue::isArray() const
+{
+        return this->type() == Array;
+}
 
-        return QVariant(list);
+/**
+ * isObject
+ */
+bool JsonValue::isObject() const
+{
+        return this->type() == Object;
 }
 
 /**
- * parseString
+ * toBool
  */
-QVariant Json::parseString(const QString &json, int &index, bool &success)
+bool JsonValue::toBool() const
 {
-        QString s;
-        QChar c;
+        if(this->type() == Bool)
+        {
+                return d->nodes.at(m_index).length == 4;
+        }
 
-        Json::eatWhitespace(json, index);
+        return this->toVariant().toBool();
+}
+
+/**
+ * toDouble
+ */
+double JsonValue::toDouble() const
+{
+        return this->toVariant().toDouble();
+}
 
-        c = json[index++];
+/**
+ * toLongLong
+ */
+qlonglong JsonValue::toLongLong() const
+{
+        return this->toVariant().toLongLong();
+}
 
-        bool complete = false;
-        while(!complete)
+/**
+ * toString
+ */
+QString JsonValue::toString() const
+{
+        if(this->type() == String)
         {
-                if(index == json.size())
-                {
-                        break;
-                }
+                const JsonNode &node = d->nodes.at(m_index);
+                return d->string(node.offset, node.length);
+        }
 
-                c = json[index++];
+        return this->toVariant().toString();
+}
 
-                if(c == '\"')
-                {
-                        complete = true;
-                        break;
-                }
-                else if(c == '\\')
-                {
-                        if(index == json.size())
-                        {
-                                break;
-                        }
+/**
+ * size
+ */
+int JsonValue::size() const
+{
+        const Type t = this->type();
+        return (t == Array) || (t == Object) ? d->nodes.at(m_index).count : 0;
+}
 
-                        c = json[index++];
+/**
+ * at
+ */
+JsonValue JsonValue::at(int i) const
+{
+        if((this->type() != Array) || (i < 0) || (i >= this->size()))
+        {
+                return JsonValue();
+        }
 
-                        if(c == '\"')
-                        {
-                                s.append('\"');
-                        }
-                        else if(c == '\\')
-                        {
-                                s.append('\\');
-                        }
-                        else if(c == '/')
-                        {
-                                s.append('/');
-                        }
-                        else if(c == 'b')
-                        {
-                                s.append('\b');
-                        }
-                        else if(c == 'f')
-                        {
-                                s.append('\f');
-                        }
-                        else if(c == 'n')
-                        {
-                                s.append('\n');
-                        }
-                        else if(c == 'r')
-                        {
-                                s.append('\r');
-                        }
-                        else if(c == 't')
-                        {
-                                s.append('\t');
-                        }
-                        else if(c == 'u')
-                        {
-                                int remainingLength = json.size() - index;
+        int child = m_index + 1;
 
-                                if(remainingLength >= 4)
-                                {
-                                        QString unicodeStr = json.mid(index, 4);
+        while(i-- > 0)
+        {
+                child = d->nodes.at(child).next;
+        }
 
-                                        int symbol = unicodeStr.toInt(0, 16);
+        return JsonValue(d.data(), child);
+}
 
-                                        s.append(QChar(symbol));
+/**
+ * value
+ */
+JsonValue JsonValue::value(const QString &key) const
+{
+        if((this->type() != Object) || (this->size() == 0))
+        {
+                return JsonValue();
+        }
 
-                                        index += 4;
-                                }
-                                else
-                                {
-                                        break;
-                                }
-                        }
+        //Compare the raw member names where possible, to avoid decoding each one
+        const QByteArray utf8 = key.toUtf8();
+        const char *data = d->json.constData();
+        JsonValue result;
+
+        for(int child = m_index + 1; child != -1; child = d->nodes.at(child).next)
+        {
+                const JsonNode &member = d->nodes.at(child);
+                const char *name = data + member.keyOffset + 1;
+                const int length = member.keyLength - 2;
+                bool match;
+
+                if(memchr(name, '\\', length))
+                {
+                        match = (d->string(member.keyOffset, member.keyLength) == key);
                 }
                 else
                 {
-                        s.append(c);
+                        match = (length == utf8.size()) && (memcmp(name, utf8.constData(), length) == 0);
                 }
-        }
 
-        if(!complete)
-        {
-                success = false;
-                return QVariant();
+                //As in Json::parse(), the last duplicate member wins
+                if(match)
+                {
+                        result = JsonValue(d.data(), child);
+                }
         }
 
-        return QVariant(s);
+        return result;
 }
 
 /**
- * parseNumber
+ * toVariant
  */
-QVariant Json::parseNumber(const QString &json, int &index)
+QVariant JsonValue::toVariant() const
 {
-        Json::eatWhitespace(json, index);
+        return d ? d->toVariant(m_index) : QVariant();
+}
 
-        int lastIndex = Json::lastIndexOfNumber(json, index);
-        int charLength = (lastIndex - index) + 1;
-        QString numberStr;
+/**
+ * JsonDocument
+ */
+JsonDocument::JsonDocument()
+{
+}
 
-        numberStr = json.mid(index, charLength);
+JsonDocument::JsonDocument(const JsonDocument &other) :
+        d(other.d)
+{
+}
 
-        index = lastIndex + 1;
+JsonDocument::~JsonDocument()
+{
+}
 
-        if (numberStr.contains('.')) {
-                return QVariant(numberStr.toDouble(NULL));
-        } else if (numberStr.startsWith('-')) {
-                return QVariant(numberStr.toLongLong(NULL));
-        } else {
-                return QVariant(numberStr.toULongLong(NULL));
-        }
+JsonDocument &JsonDocument::operator=(const JsonDocument &other)
+{
+        d = other.d;
+        return *this;
 }
 
 /**
- * lastIndexOfNumber
+ * fromJson
  */
-int Json::lastIndexOfNumber(const QString &json, int index)
+JsonDocument JsonDocument::fromJson(const QByteArray &json)
 {
-        int lastIndex;
+        bool success = true;
+        return JsonDocument::fromJson(json, success);
+}
 
-        for(lastIndex = index; lastIndex < json.size(); lastIndex++)
+/**
+ * fromJson
+ */
+JsonDocument JsonDocument::fromJson(const QByteArray &json, bool &success)
+{
+        JsonDocument document;
+        JsonDocumentData *data = new JsonDocumentData;
+        data->json = json;
+        document.d = data;
+        success = data->parse();
+
+        if(!success)
         {
-                if(QString("0123456789+-.eE").indexOf(json[lastIndex]) == -1)
-                {
-                        break;
-                }
+                document.d = 0;
         }
 
-        return lastIndex -1;
+        return document;
 }
 
 /**
- * eatWhitespace
+ * isNull
  */
-void Json::eatWhitespace(const QString &json, int &index)
+bool JsonDocument::isNull() const
 {
-        for(; index < json.size(); index++)
-        {
-                if(QString(" \t\n\r").indexOf(json[index]) == -1)
-                {
-                        break;
-                }
-        }
+        return !d;
 }
 
 /**
- * lookAhead
+ * root
  */
-int Json::lookAhead(const QString &json, int index)
+JsonValue JsonDocument::root() const
 {
-        int saveIndex = index;
-        return Json::nextToken(json, saveIndex);
+        return d ? JsonValue(d.data(), 0) : JsonValue();
 }
 
 /**
- * nextToken
+ * toVariant
  */
-int Json::nextToken(const QString &json, int &index)
+QVariant JsonDocument::toVariant() const
 {
-        Json::eatWhitespace(json, index);
+        return this->root().toVariant();
+}
 
-        if(index == json.size())
-        {
-                return JsonTokenNone;
-        }
+/**
+ * JsonWriter
+ */
+JsonWriter::JsonWriter(int reserve)
+{
+        m_data.reserve(reserve);
+}
 
-        QChar c = json[index];
-        index++;
-        switch(c.toLatin1())
-        {
-                case '{': return JsonTokenCurlyOpen;
-                case '}': return JsonTokenCurlyClose;
-                case '[': return JsonTokenSquaredOpen;
-                case ']': return JsonTokenSquaredClose;
-                case ',': return JsonTokenComma;
-                case '"': return JsonTokenString;
-                case '0': case '1': case '2': case '3': case '4':
-                case '5': case '6': case '7': case '8': case '9':
-                case '-': return JsonTokenNumber;
-                case ':': return JsonTokenColon;
-        }
+/**
+ * beginObject
+ */
+JsonWriter &JsonWriter::beginObject()
+{
+        this->separate();
+        m_data.append('{');
+        return *this;
+}
 
-        index--;
+/**
+ * endObject
+ */
+JsonWriter &JsonWriter::endObject()
+{
+        m_data.append('}');
+        return *this;
+}
 
-        int remainingLength = json.size() - index;
+/**
+ * beginArray
+ */
+JsonWriter &JsonWriter::beginArray()
+{
+        this->separate();
+        m_data.append('[');
+        return *this;
+}
 
-        //True
-        if(remainingLength >= 4)
-        {
-                if (json[index] == 't' && json[index + 1] == 'r' &&
-                        json[index + 2] == 'u' && json[index + 3] == 'e')
-                {
-                        index += 4;
-                        return JsonTokenTrue;
-                }
-        }
+/**
+ * endArray
+ */
+JsonWriter &JsonWriter::endArray()
+{
+        m_data.append(']');
+        return *this;
+}
 
-        //False
-        if (remainingLength >= 5)
+/**
+ * key
+ */
+JsonWriter &JsonWriter::key(const char *key)
+{
+        this->separate();
+        appendString(m_data, key, qstrlen(key));
+        m_data.append(':');
+        return *this;
+}
+
+/**
+ * key
+ */
+JsonWriter &JsonWriter::key(const QString &key)
+{
+        this->separate();
+        appendString(m_data, key);
+        m_data.append(':');
+        return *this;
+}
+
+/**
+ * value
+ */
+JsonWriter &JsonWriter::value(const QString &value)
+{
+        this->separate();
+        appendString(m_data, value);
+        return *this;
+}
+
+/**
+ * value
+ */
+JsonWriter &JsonWriter::value(const char *value)
+{
+        this->separate();
+        appendString(m_data, value, qstrlen(value));
+        return *this;
+}
+
+/**
+ * value
+ */
+JsonWriter &JsonWriter::value(bool value)
+{
+        this->separate();
+        m_data.append(value ? "true" : "false");
+        return *this;
+}
+
+/**
+ * value
+ */
+JsonWriter &JsonWriter::value(int value)
+{
+        this->separate();
+        m_data.append(QByteArray::number(value));
+        return *this;
+}
+
+/**
+ * value
+ */
+JsonWriter &JsonWriter::value(qlonglong value)
+{
+        this->separate();
+        m_data.append(QByteArray::number(value));
+        return *this;
+}
+
+/**
+ * value
+ */
+JsonWriter &JsonWriter::value(const QStringList &value)
+{
+        this->beginArray();
+
+        for(int i = 0; i < value.size(); i++)
         {
-                if (json[index] == 'f' && json[index + 1] == 'a' &&
-                        json[index + 2] == 'l' && json[index + 3] == 's' &&
-                        json[index + 4] == 'e')
-                {
-                        index += 5;
-                        return JsonTokenFalse;
-                }
+                this->value(value.at(i));
         }
 
-        //Null
-        if (remainingLength >= 4)
+        return this->endArray();
+}
+
+/**
+ * value
+ */
+JsonWriter &JsonWriter::value(const QVariant &value)
+{
+        this->separate();
+        serializeValue(value, m_data, JsonFormatCompact);
+        return *this;
+}
+
+/**
+ * data
+ */
+QByteArray JsonWriter::data() const
+{
+        return m_data;
+}
+
+/**
+ * separate
+ */
+void JsonWriter::separate()
+{
+        if(!m_data.isEmpty())
         {
-                if (json[index] == 'n' && json[index + 1] == 'u' &&
-                        json[index + 2] == 'l' && json[index + 3] == 'l')
+                const char last = m_data.at(m_data.size() - 1);
+
+                if((last != '{') && (last != '[') && (last != ':'))
                 {
-                        index += 4;
-                        return JsonTokenNull;
+                        m_data.append(',');
                 }
         }
-
-        return JsonTokenNone;
 }
 
-
 } //end namespace
@@ -35,6 +35,10 @@
 
 #include <QVariant>
 #include <QString>
+#include <QByteArray>
+#include <QSharedData>
+#include <QStringList>
+#include <QVector>
 
 namespace QtJson
 {
@@ -58,6 +62,15 @@ enum JsonToken
         JsonTokenNull = 11
 };
 
+/**
+ * \enum JsonFormat
+ */
+enum JsonFormat
+{
+        JsonFormatPadded = 0,
+        JsonFormatCompact = 1
+};
+
 /**
  * \class Json
  * \brief A JSON data parser
@@ -82,6 +95,32 @@ class Json
                  */
                 static QVariant parse(const QString &json, bool &success);
 
+                /**
+                 * Parse UTF-8 encoded JSON data
+                 *
+                 * \param json The JSON data
+                 */
+                static QVariant parse(const QByteArray &json);
+
+                /**
+                 * Parse UTF-8 encoded JSON data
+                 *
+                 * \param json The JSON data
+                 * \param success The success of the parsing
+                 */
+                static QVariant parse(const QByteArray &json, bool &success);
+
+                /**
+                 * Parse UTF-8 encoded JSON data
+                 *
+                 * \param json The JSON data
+                 * \param success The success of the parsing
+                 * \param errorOffset The byte offset at which parsing failed,
+                 * or -1 if the parsing succeeded
+                 */
+                static QVariant parse(const QByteArray &json, bool &success,
+                                      int &errorOffset);
+
                 /**
                 * This method generates a textual JSON representation
                 *
@@ -100,6 +139,30 @@ class Json
                 */
                 static QByteArray serialize(const QVariant &data, bool &success);
 
+                /**
+                * This method generates a textual JSON representation
+                *
+                * \param data The JSON data generated by the parser.
+                * \param format JsonFormatCompact omits the spaces
+                * around brackets, colons and commas
+                *
+                * \return QByteArray Textual JSON representation
+                */
+                static QByteArray serialize(const QVariant &data, JsonFormat format);
+
+                /**
+                * This method generates a textual JSON representation
+                *
+                * \param data The JSON data generated by the parser.
+                * \param success The success of the serialization
+                * \param format JsonFormatCompact omits the spaces
+                * around brackets, colons and commas
+                *
+                * \return QByteArray Textual JSON representation
+                */
+                static QByteArray serialize(const QVariant &data, bool &success,
+                                            JsonFormat format);
+
         private:
                 /**
                  * Parses a value starting from index
@@ -110,7 +173,7 @@ class Json
                  *
                  * \return QVariant The parsed value
                  */
-                static QVariant parseValue(const QString &json, int &index,
+                static QVariant parseValue(const QByteArray &json, int &index,
                                                                    bool &success);
 
                 /**
@@ -122,7 +185,7 @@ class Json
                  *
                  * \return QVariant The parsed object map
                  */
-                static QVariant parseObject(const QString &json, int &index,
+                static QVariant parseObject(const QByteArray &json, int &index,
                                                                            bool &success);
 
                 /**
@@ -134,7 +197,7 @@ class Json
                  *
                  * \return QVariant The parsed variant array
                  */
-                static QVariant parseArray(const QString &json, int &index,
+                static QVariant parseArray(const QByteArray &json, int &index,
                                                                            bool &success);
 
                 /**
@@ -146,7 +209,7 @@ class Json
                  *
                  * \return QVariant The parsed string
                  */
-                static QVariant parseString(const QString &json, int &index,
+                static QVariant parseString(const QByteArray &json, int &index,
                                                                         bool &success);
 
                 /**
@@ -157,7 +220,7 @@ class Json
                  *
                  * \return QVariant The parsed number
                  */
-                static QVariant parseNumber(const QString &json, int &index);
+                static QVariant parseNumber(const QByteArray &json, int &index);
 
                 /**
                  * Get the last index of a number starting from index
@@ -167,7 +230,7 @@ class Json
                  *
                  * \return The last index of the number
                  */
-                static int lastIndexOfNumber(const QString &json, int index);
+                static int lastIndexOfNumber(const QByteArray &json, int index);
 
                 /**
                  * Skip unwanted whitespace symbols starting from index
@@ -175,7 +238,7 @@ class Json
                  * \param json The JSON data
                  * \param index The start index
                  */
-                static void eatWhitespace(const QString &json, int &index);
+                static void eatWhitespace(const QByteArray &json, int &index);
 
                 /**
                  * Check what token lies ahead
@@ -185,7 +248,7 @@ class Json
                  *
                  * \return int The upcoming token
                  */
-                static int lookAhead(const QString &json, int index);
+                static int lookAhead(const QByteArray &json, int index);
 
                 /**
                  * Get the next JSON token
@@ -195,9 +258,701 @@ class Json
                  *
                  * \return int The next JSON token
                  */
-                static int nextToken(const QString &json, int &index);
+                static int nextToken(const QByteArray &json, int &index);
+};
+
+
+class JsonDocumentData;
+
+/**
+ * \class JsonValue
+ * \brief A value inside a JsonDocument
+ *
+ * JsonValue is a lightweight reference to a value stored in a
+ * JsonDocument. Strings and numbers are decoded from the source
+ * data only when they are read, and containers are converted to
+ * QVariant only by toVariant(). A JsonValue keeps its document
+ * alive.
+ */
+class JsonValue
+{
+        public:
+                /**
+                 * The JSON value types
+                 */
+                enum Type
+                {
+                        Undefined,
+                        Null,
+                        Bool,
+                        Number,
+                        String,
+                        Array,
+                        Object
+                };
+
+                /**
+                 * Constructs an undefined value
+                 */
+                JsonValue();
+
+                JsonValue(const JsonValue &other);
+
+                ~JsonValue();
+
+                JsonValue &operator=(const JsonValue &other);
+
+                /**
+                 * Returns the type of the value
+                 */
+                Type type() const;
+
+                /**
+                 * Returns true if the value does not exist
+                 */
+                bool isUndefined() const;
+
+                /**
+                 * Returns true if the value is an array
+                 */
+                bool isArray() const;
+
+                /**
+                 * Returns true if the value is an object
+                 */
+                bool isObject() const;
+
+                /**
+                 * Returns the value converted to a boolean, as by QVariant
+                 */
+                bool toBool() const;
+
+                /**
+                 * Returns the value converted to a double, as by QVariant
+                 */
+                double toDouble() const;
+
+                /**
+                 * Returns the value converted to a long long, as by QVariant
+                 */
+                qlonglong toLongLong() const;
+
+                /**
+                 * Returns the value converted to a string, as by QVariant
+                 */
+                QString toString() const;
+
+                /**
+                 * Returns the number of items in an array or
+                 * members in an object, otherwise 0
+                 */
+                int size() const;
+
+                /**
+                 * Returns the item at position i in an array, or an
+                 * undefined value. Items are visited in order, so
+                 * iterating an array with at() is quadratic.
+                 *
+                 * \param i The position of the item
+                 */
+                JsonValue at(int i) const;
+
+                /**
+                 * Returns the member named key of an object, or an
+                 * undefined value
+                 *
+                 * \param key The member name
+                 */
+                JsonValue value(const QString &key) const;
+
+                /**
+                 * Converts the value and its children to QVariant,
+                 * as returned by Json::parse()
+                 */
+                QVariant toVariant() const;
+
+        private:
+                JsonValue(JsonDocumentData *data, int index);
+
+                QExplicitlySharedDataPointer<JsonDocumentData> d;
+
+                int m_index;
+
+                friend class JsonDocument;
+};
+
+/**
+ * \class JsonDocument
+ * \brief A parsed JSON document with lazy conversion
+ *
+ * JsonDocument validates UTF-8 encoded JSON data in a single
+ * pass and records the position of every value in one contiguous
+ * node table that references the source data, instead of building
+ * a tree of separately allocated QVariant maps and lists. Values
+ * are converted to QVariant only when accessed.
+ */
+class JsonDocument
+{
+        public:
+                /**
+                 * Constructs a null document
+                 */
+                JsonDocument();
+
+                JsonDocument(const JsonDocument &other);
+
+                ~JsonDocument();
+
+                JsonDocument &operator=(const JsonDocument &other);
+
+                /**
+                 * Parses the JSON data
+                 *
+                 * \param json The JSON data
+                 *
+                 * \return JsonDocument The document, or a null document if
+                 * the data is not valid JSON
+                 */
+                static JsonDocument fromJson(const QByteArray &json);
+
+                /**
+                 * Parses the JSON data
+                 *
+                 * \param json The JSON data
+                 * \param success Set to true if the data was valid JSON
+                 *
+                 * \return JsonDocument The document, or a null document if
+                 * the data is not valid JSON
+                 */
+                static JsonDocument fromJson(const QByteArray &json, bool &success);
+
+                /**
+                 * Returns true if the document holds no data
+                 */
+                bool isNull() const;
+
+                /**
+                 * Returns the top level value
+                 */
+                JsonValue root() const;
+
+                /**
+                 * Converts the whole document to QVariant
+                 */
+                QVariant toVariant() const;
+
+        private:
+                QExplicitlySharedDataPointer<JsonDocumentData> d;
 };
 
+/**
+ * \class JsonKeyTable
+ * \brief A perfect hash table of member names
+ *
+ * JsonKeyTable maps a fixed set of member names to their index
+ * in the array passed to the constructor. The hash seed is chosen
+ * when the table is constructed so that no two names share a slot,
+ * making every lookup a single hash and a single comparison.
+ */
+class JsonKeyTable
+{
+        public:
+                /**
+                 * Constructs a table for count names. The array must
+                 * outlive the table.
+                 *
+                 * \param keys The member names
+                 * \param count The number of names
+                 */
+                JsonKeyTable(const char * const keys[], int count);
+
+                /**
+                 * Returns the index of key, or -1 if key is not in the table
+                 *
+                 * \param key The member name
+                 */
+                int indexOf(const QString &key) const;
+
+        private:
+                static uint hash(const ushort *data, int size, uint seed);
+
+                const char * const *m_keys;
+
+                uint m_seed;
+
+                uint m_mask;
+
+                QVector<int> m_slots;
+};
+
+/**
+ * \class JsonWriter
+ * \brief Builds compact UTF-8 encoded JSON
+ *
+ * JsonWriter appends keys and values to a single buffer, adding
+ * separators and escaping strings as it goes. Calls can be chained:
+ *
+ * \code
+ * QByteArray body = JsonWriter().beginObject().key("name").value(name).endObject().data();
+ * \endcode
+ */
+class JsonWriter
+{
+        public:
+                /**
+                 * Constructs an empty writer
+                 *
+                 * \param reserve The number of bytes to preallocate
+                 */
+                explicit JsonWriter(int reserve = 128);
+
+                /**
+                 * Opens an object
+                 */
+                JsonWriter &beginObject();
+
+                /**
+                 * Closes the current object
+                 */
+                JsonWriter &endObject();
+
+                /**
+                 * Opens an array
+                 */
+                JsonWriter &beginArray();
+
+                /**
+                 * Closes the current array
+                 */
+                JsonWriter &endArray();
+
+                /**
+                 * Writes the name of the next object member
+                 *
+                 * \param key The UTF-8 encoded member name
+                 */
+                JsonWriter &key(const char *key);
+
+                /**
+                 * Writes the name of the next object member
+                 *
+                 * \param key The member name
+                 */
+                JsonWriter &key(const QString &key);
+
+                /**
+                 * Writes a string value
+                 */
+                JsonWriter &value(const QString &value);
+
+                /**
+                 * Writes a UTF-8 encoded string value
+                 */
+                JsonWriter &value(const char *value);
+
+                /**
+                 * Writes a boolean value
+                 */
+                JsonWriter &value(bool value);
+
+                /**
+                 * Writes a number value
+                 */
+                JsonWriter &value(int value);
+
+                /**
+                 * Writes a number value
+                 */
+                JsonWriter &value(qlonglong value);
+
+                /**
+                 * Writes an array of strings
+                 */
+                JsonWriter &value(const QStringList &value);
+
+                /**
+                 * Writes any value supported by Json::serialize()
+                 */
+                JsonWriter &value(const QVariant &value);
+
+                /**
+                 * Returns the JSON written so far
+                 */
+                QByteArray data() const;
+
+        private:
+                void separate();
+
+                QByteArray m_data;
+};
+
+/**
+ * \class JsonHandler
+ * \brief Receives the events reported by JsonStreamParser
+ *
+ * Reimplement the callbacks of interest. The default
+ * implementations ignore the event.
+ */
+class JsonHandler
+{
+        public:
+                virtual ~JsonHandler() {}
+
+                /**
+                 * Called when an object is opened
+                 */
+                virtual void startObject() {}
+
+                /**
+                 * Called when an object is closed
+                 */
+                virtual void endObject() {}
+
+                /**
+                 * Called when an array is opened
+                 */
+                virtual void startArray() {}
+
+                /**
+                 * Called when an array is closed
+                 */
+                virtual void endArray() {}
+
+                /**
+                 * Called with the name of each object member,
+                 * before the member's value
+                 *
+                 * \param key The member name
+                 */
+                virtual void key(const QString &key) { Q_UNUSED(key) }
+
+                /**
+                 * Called for each string, number, boolean or null value
+                 *
+                 * \param value The value
+                 */
+                virtual void value(const QVariant &value) { Q_UNUSED(value) }
+};
+
+/**
+ * \class JsonStreamParser
+ * \brief A push-based JSON parser
+ *
+ * JsonStreamParser parses UTF-8 encoded JSON data in arbitrary
+ * chunks, as they arrive from the network, and reports the
+ * document structure to a JsonHandler. Tokens split across
+ * chunks are retained until the rest of their data is fed.
+ */
+class JsonStreamParser
+{
+        public:
+                /**
+                 * Constructs a parser reporting to handler
+                 *
+                 * \param handler The handler that receives the events
+                 */
+                explicit JsonStreamParser(JsonHandler *handler);
+
+                /**
+                 * Parses the next chunk of data
+                 *
+                 * \param data The JSON data
+                 *
+                 * \return bool False if the data is not valid JSON
+                 */
+                bool feed(const QByteArray &data);
+
+                /**
+                 * Signals the end of the data
+                 *
+                 * \return bool True if a complete document was parsed
+                 */
+                bool finish();
+
+                /**
+                 * Returns true if the data fed so far is not valid JSON
+                 */
+                bool hasError() const;
+
+                /**
+                 * Returns the byte offset in the stream at which parsing failed,
+                 * or -1 if no error occurred
+                 */
+                int errorOffset() const;
+
+                /**
+                 * Returns true once the top level value has been completed
+                 */
+                bool isComplete() const;
+
+                /**
+                 * Discards all state so that a new document can be parsed
+                 */
+                void reset();
+
+        private:
+                /**
+                 * The grammar states of the parser
+                 */
+                enum State
+                {
+                        StateValue,
+                        StateValueOrArrayEnd,
+                        StateKeyOrObjectEnd,
+                        StateKey,
+                        StateColon,
+                        StateCommaOrEnd,
+                        StateDone
+                };
+
+                /**
+                 * Parses as many complete tokens from the buffer as possible
+                 *
+                 * \param final True if no more data will be fed
+                 */
+                bool parseBuffer(bool final);
+
+                /**
+                 * Updates the state after a complete value
+                 */
+                void valueCompleted();
+
+                /**
+                 * Flags a failure at the position in the buffer
+                 */
+                bool setError(int position);
+
+                JsonHandler *m_handler;
+
+                QByteArray m_buffer;
+
+                int m_offset;
+
+                //How far the incomplete string at the start of the buffer has been searched
+                int m_scanned;
+
+                QByteArray m_containers;
+
+                State m_state;
+
+                int m_errorOffset;
+};
+
+/**
+ * \class JsonArrayReader
+ * \brief Reads the items of an array inside a JSON document
+ *
+ * JsonArrayReader is a JsonHandler that rebuilds each item of
+ * the array found at a member path (for example "response",
+ * "songs") as a QVariant, and passes it to readItem() as soon
+ * as the item is complete. If the document root is itself an
+ * array, its items are read regardless of the path.
+ */
+class JsonArrayReader : public JsonHandler
+{
+        public:
+                /**
+                 * Constructs a reader for the array at path
+                 *
+                 * \param path The member names leading to the array
+                 */
+                explicit JsonArrayReader(const QStringList &path = QStringList());
+
+                /**
+                 * Returns the member names leading to the array
+                 */
+                QStringList path() const;
+
+                /**
+                 * Sets the member names leading to the array
+                 */
+                void setPath(const QStringList &path);
+
+                /**
+                 * Returns true if the document root is an object or an array
+                 */
+                bool isValid() const;
+
+                void startObject();
+                void endObject();
+                void startArray();
+                void endArray();
+                void key(const QString &key);
+                void value(const QVariant &value);
+
+        protected:
+                /**
+                 * Called with each completed item of the array. Items
+                 * that are objects are passed by the default endItem().
+                 *
+                 * \param item The item
+                 */
+                virtual void readItem(const QVariant &item) = 0;
+
+                /**
+                 * Called when an item that is an object is opened.
+                 *
+                 * Together with readItemValue() and endItem(), this
+                 * allows the members of an object item to be bound
+                 * directly to their destination without building a
+                 * QVariantMap. The default implementations collect
+                 * the members into a map and pass it to readItem().
+                 */
+                virtual void beginItem();
+
+                /**
+                 * Called with each member of the current object item
+                 *
+                 * \param key The member name
+                 * \param value The member value
+                 */
+                virtual void readItemValue(const QString &key, const QVariant &value);
+
+                /**
+                 * Called when the current object item is closed
+                 */
+                virtual void endItem();
+
+        private:
+                /**
+                 * A partially built object or array inside an item
+                 */
+                struct Container
+                {
+                        bool isObject;
+                        QString key;
+                        QVariantMap map;
+                        QVariantList list;
+                };
+
+                void startContainer(bool isObject);
+                void endContainer();
+                void addValue(const QVariant &value);
+
+                bool isTargetArray() const;
+
+                QStringList m_path;
+
+                QStringList m_keys;
+
+                QByteArray m_kinds;
+
+                int m_depth;
+
+                int m_arrayDepth;
+
+                bool m_valid;
+
+                QList<Container> m_items;
+
+                QVariantMap m_item;
+};
+
+/**
+ * \class JsonObjectReader
+ * \brief Reads the members of an object inside a JSON document
+ *
+ * JsonObjectReader is a JsonHandler that passes each member of
+ * the object found at a member path (for example "response")
+ * to readItemValue() as soon as the member is complete. If the
+ * path is empty, the members of the document root are read.
+ * Only member values that are objects or arrays are rebuilt
+ * as a QVariant.
+ */
+class JsonObjectReader : public JsonHandler
+{
+        public:
+                /**
+                 * Constructs a reader for the object at path
+                 *
+                 * \param path The member names leading to the object
+                 */
+                explicit JsonObjectReader(const QStringList &path = QStringList());
+
+                /**
+                 * Returns the member names leading to the object
+                 */
+                QStringList path() const;
+
+                /**
+                 * Sets the member names leading to the object
+                 */
+                void setPath(const QStringList &path);
+
+                /**
+                 * Returns true if the document root is an object or an array
+                 */
+                bool isValid() const;
+
+                /**
+                 * Returns true if the object was read to its end
+                 */
+                bool isFound() const;
+
+                void startObject();
+                void endObject();
+                void startArray();
+                void endArray();
+                void key(const QString &key);
+                void value(const QVariant &value);
+
+        protected:
+                /**
+                 * Called when the object is opened. The default
+                 * implementation does nothing.
+                 */
+                virtual void beginItem();
+
+                /**
+                 * Called with each member of the object
+                 *
+                 * \param key The member name
+                 * \param value The member value
+                 */
+                virtual void readItemValue(const QString &key, const QVariant &value) = 0;
+
+                /**
+                 * Called when the object is closed. The default
+                 * implementation does nothing.
+                 */
+                virtual void endItem();
+
+        private:
+                /**
+                 * A partially built object or array inside a member value
+                 */
+                struct Container
+                {
+                        bool isObject;
+                        QString key;
+                        QVariantMap map;
+                        QVariantList list;
+                };
+
+                void startContainer(bool isObject);
+                void endContainer();
+                void addValue(const QVariant &value);
+
+                bool isTargetObject() const;
+
+                QStringList m_path;
+
+                QStringList m_keys;
+
+                QByteArray m_kinds;
+
+                int m_depth;
+
+                int m_objectDepth;
+
+                bool m_valid;
+
+                bool m_found;
+
+                QString m_member;
+
+                QList<Container> m_values;
+};
 
 } //end namespace
 
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "memorycache.h"
+#include <QBuffer>
+
+namespace QtUbuntuOne {
+
+static const qint64 MAX_CACHE_SIZE = 2 * 1024 * 1024;
+
+MemoryCache::MemoryCache(QObject *parent) :
+    QAbstractNetworkCache(parent),
+    m_maximumCacheSize(MAX_CACHE_SIZE),
+    m_cacheSize(0)
+{
+}
+
+MemoryCache::~MemoryCache() {
+    qDeleteAll(m_pending.keys());
+}
+
+qint64 MemoryCache::maximumCacheSize() const {
+    return m_maximumCacheSize;
+}
+
+void MemoryCache::setMaximumCacheSize(qint64 size) {
+    m_maximumCacheSize = size;
+    this->expire();
+}
+
+QNetworkCacheMetaData MemoryCache::metaData(const QUrl &url) {
+    QHash<QUrl, Entry>::const_iterator iterator = m_entries.constFind(url);
+
+    return iterator == m_entries.constEnd() ? QNetworkCacheMetaData() : iterator.value().metaData;
+}
+
+void MemoryCache::updateMetaData(const QNetworkCacheMetaData &metaData) {
+    QHash<QUrl, Entry>::iterator iterator = m_entries.find(metaData.url());
+
+    if (iterator != m_entries.end()) {
+        iterator.value().metaData = metaData;
+    }
+}
+
+QIODevice* MemoryCache::data(const QUrl &url) {
+    QHash<QUrl, Entry>::const_iterator iterator = m_entries.constFind(url);
+
+    if (iterator == m_entries.constEnd()) {
+        return 0;
+    }
+
+    this->touch(url);
+
+    // The caller takes ownership of the device
+    QBuffer *buffer = new QBuffer;
+    buffer->setData(iterator.value().data);
+    buffer->open(QIODevice::ReadOnly);
+
+    return buffer;
+}
+
+bool MemoryCache::remove(const QUrl &url) {
+    // Discard any data being prepared for the url
+    QHash<QIODevice*, QNetworkCacheMetaData>::iterator pending = m_pending.begin();
+
+    while (pending != m_pending.end()) {
+        if (pending.value().url() == url) {
+            delete pending.key();
+            pending = m_pending.erase(pending);
+        }
+        else {
+            ++pending;
+        }
+    }
+
+    return this->removeEntry(url);
+}
+
+qint64 MemoryCache::cacheSize() const {
+    return m_cacheSize;
+}
+
+QIODevice* MemoryCache::prepare(const QNetworkCacheMetaData &metaData) {
+    if ((!metaData.isValid()) || (!metaData.url().isValid()) || (!metaData.saveToDisk())) {
+        return 0;
+    }
+
+    QBuffer *buffer = new QBuffer;
+    buffer->open(QIODevice::ReadWrite);
+    m_pending.insert(buffer, metaData);
+
+    return buffer;
+}
+
+void MemoryCache::insert(QIODevice *device) {
+    QHash<QIODevice*, QNetworkCacheMetaData>::iterator iterator = m_pending.find(device);
+
+    if (iterator == m_pending.end()) {
+        return;
+    }
+
+    const QNetworkCacheMetaData metaData = iterator.value();
+    m_pending.erase(iterator);
+
+    Entry entry;
+    entry.metaData = metaData;
+    entry.data = static_cast<QBuffer*>(device)->data();
+    delete device;
+
+    // Entries larger than the whole cache are not kept
+    if (entry.data.size() <= m_maximumCacheSize) {
+        this->removeEntry(metaData.url());
+        m_entries.insert(metaData.url(), entry);
+        m_recentlyUsed.append(metaData.url());
+        m_cacheSize += entry.data.size();
+        this->expire();
+    }
+}
+
+void MemoryCache::discard(QIODevice *device) {
+    if (m_pending.remove(device) > 0) {
+        delete device;
+    }
+}
+
+void MemoryCache::clear() {
+    m_entries.clear();
+    m_recentlyUsed.clear();
+    m_cacheSize = 0;
+}
+
+bool MemoryCache::removeEntry(const QUrl &url) {
+    QHash<QUrl, Entry>::iterator iterator = m_entries.find(url);
+
+    if (iterator == m_entries.end()) {
+        return false;
+    }
+
+    m_cacheSize -= iterator.value().data.size();
+    m_entries.erase(iterator);
+    m_recentlyUsed.removeOne(url);
+
+    return true;
+}
+
+void MemoryCache::touch(const QUrl &url) {
+    m_recentlyUsed.removeOne(url);
+    m_recentlyUsed.append(url);
+}
+
+void MemoryCache::expire() {
+    while ((m_cacheSize > m_maximumCacheSize) && (!m_recentlyUsed.isEmpty())) {
+        this->removeEntry(m_recentlyUsed.first());
+    }
+}
+
+}
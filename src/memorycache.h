@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * \file memorycache.h
+ */
+
+#ifndef MEMORYCACHE_H
+#define MEMORYCACHE_H
+
+#include "qubuntuone_global.h"
+#include <QAbstractNetworkCache>
+#include <QHash>
+#include <QList>
+
+namespace QtUbuntuOne {
+
+/**
+ * \class MemoryCache
+ * \brief An in-memory network cache for API responses.
+ *
+ * MemoryCache keeps responses in memory, so that unchanged metadata can be
+ * answered from the cache after a 304 Not Modified response. Entries are
+ * evicted, least recently used first, once the total size of the cached
+ * data exceeds maximumCacheSize().
+ *
+ * \sa NetworkSettings::setResponseCache()
+ */
+class QUBUNTUONESHARED_EXPORT MemoryCache : public QAbstractNetworkCache
+{
+    Q_OBJECT
+
+public:
+    explicit MemoryCache(QObject *parent = 0);
+    ~MemoryCache();
+
+    /**
+     * Returns the maximum total size in bytes of the cached data. The default is 2MB.
+     *
+     * \return qint64
+     */
+    qint64 maximumCacheSize() const;
+
+    /**
+     * Sets the maximum total size in bytes of the cached data.
+     *
+     * \param size
+     */
+    void setMaximumCacheSize(qint64 size);
+
+    QNetworkCacheMetaData metaData(const QUrl &url);
+    void updateMetaData(const QNetworkCacheMetaData &metaData);
+
+    QIODevice* data(const QUrl &url);
+
+    bool remove(const QUrl &url);
+
+    qint64 cacheSize() const;
+
+    QIODevice* prepare(const QNetworkCacheMetaData &metaData);
+    void insert(QIODevice *device);
+
+    /**
+     * Discards a device returned by prepare() without inserting it,
+     * leaving any cached entry for the same url in place.
+     *
+     * \param device
+     */
+    void discard(QIODevice *device);
+
+public slots:
+    void clear();
+
+private:
+    struct Entry {
+        QNetworkCacheMetaData metaData;
+        QByteArray data;
+    };
+
+    bool removeEntry(const QUrl &url);
+    void touch(const QUrl &url);
+    void expire();
+
+    qint64 m_maximumCacheSize;
+    qint64 m_cacheSize;
+
+    QHash<QUrl, Entry> m_entries;
+    QList<QUrl> m_recentlyUsed;
+    QHash<QIODevice*, QNetworkCacheMetaData> m_pending;
+};
+
+}
+
+#endif // MEMORYCACHE_H
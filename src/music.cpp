@@ -16,9 +16,8 @@
  */
 
 #include "music.h"
-#include "authentication.h"
+#include "requestbuilder.h"
 #include "urls.h"
-#include "networkaccessmanager.h"
 #include "reply.h"
 #include "artwork.h"
 #include "musicstream.h"
@@ -26,13 +25,11 @@
 #include "albumlist.h"
 #include "playlistlist.h"
 #include "songlist.h"
+#include "json.h"
 #include <QUrl>
 #include <QStringList>
 #include <QDir>
 #include <QSize>
-#if QT_VERSION >= 0x050000
-#include <QUrlQuery>
-#endif
 
 namespace QtUbuntuOne {
 
@@ -43,251 +40,148 @@ Music::Music(QObject *parent) :
 
 Music::~Music() {}
 
-ArtistList* Music::getArtists() {
-    QUrl url(BASE_URL_MUSIC + "/artists/");
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+ArtistList* Music::getArtists(Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/artists/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.setCacheable(true);
 
-    return new ArtistList(NetworkAccessManager::instance()->get(request));
+    return new ArtistList(builder.get());
 }
 
-ArtistList* Music::getArtists(int offset, int limit) {
-    QUrl url(BASE_URL_MUSIC + "/artists/");
-#if QT_VERSION >= 0x050000
-    QUrlQuery query(url);
-    query.addQueryItem("offset", QString::number(offset));
-    query.addQueryItem("limit", QString::number(limit));
-    url.setQuery(query);
-#else
-    url.addQueryItem("offset", QString::number(offset));
-    url.addQueryItem("limit", QString::number(limit));
-#endif
-    QMap<QString, QString> params;
-    params["offset"] = QString::number(offset);
-    params["limit"] = QString::number(limit);
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery), params));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
-
-    return new ArtistList(NetworkAccessManager::instance()->get(request));
+ArtistList* Music::getArtists(int offset, int limit, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/artists/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.setCacheable(true);
+    builder.addQueryItem("offset", QString::number(offset));
+    builder.addQueryItem("limit", QString::number(limit));
+
+    return new ArtistList(builder.get());
 }
 
-AlbumList* Music::getAlbums() {
-    QUrl url(BASE_URL_MUSIC + "/albums/");
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+AlbumList* Music::getAlbums(Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/albums/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.setCacheable(true);
 
-    return new AlbumList(NetworkAccessManager::instance()->get(request));
+    return new AlbumList(builder.get());
 }
 
-AlbumList* Music::getAlbums(int offset, int limit) {
-    QUrl url(BASE_URL_MUSIC + "/albums/");
-#if QT_VERSION >= 0x050000
-    QUrlQuery query(url);
-    query.addQueryItem("offset", QString::number(offset));
-    query.addQueryItem("limit", QString::number(limit));
-    url.setQuery(query);
-#else
-    url.addQueryItem("offset", QString::number(offset));
-    url.addQueryItem("limit", QString::number(limit));
-#endif
-    QMap<QString, QString> params;
-    params["offset"] = QString::number(offset);
-    params["limit"] = QString::number(limit);
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery), params));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
-
-    return new AlbumList(NetworkAccessManager::instance()->get(request));
+AlbumList* Music::getAlbums(int offset, int limit, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/albums/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.setCacheable(true);
+    builder.addQueryItem("offset", QString::number(offset));
+    builder.addQueryItem("limit", QString::number(limit));
+
+    return new AlbumList(builder.get());
 }
 
-AlbumList* Music::getArtistAlbums(const QString &artistId) {
-    QUrl url(BASE_URL_MUSIC + "/artists/" + artistId + "/");
-#if QT_VERSION >= 0x050000
-    QUrlQuery query(url);
-    query.addQueryItem("artist_id", artistId);
-    url.setQuery(query);
-#else
-    url.addQueryItem("artist_id", artistId);
-#endif
-    QMap<QString, QString> params;
-    params["artist_id"] = artistId;
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery), params));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
-
-    return new AlbumList(NetworkAccessManager::instance()->get(request));
+AlbumList* Music::getArtistAlbums(const QString &artistId, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/artists/" + artistId + "/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.addQueryItem("artist_id", artistId);
+
+    return new AlbumList(builder.get());
 }
 
-SongList* Music::getSongs() {
-    QUrl url(BASE_URL_MUSIC + "/songs/");
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+SongList* Music::getSongs(Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/songs/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
 
-    return new SongList(NetworkAccessManager::instance()->get(request));
+    return new SongList(builder.get());
 }
 
-SongList* Music::getSongs(int offset, int limit) {
-    QUrl url(BASE_URL_MUSIC + "/songs/");
-#if QT_VERSION >= 0x050000
-    QUrlQuery query(url);
-    query.addQueryItem("offset", QString::number(offset));
-    query.addQueryItem("limit", QString::number(limit));
-    url.setQuery(query);
-#else
-    url.addQueryItem("offset", QString::number(offset));
-    url.addQueryItem("limit", QString::number(limit));
-#endif
-    QMap<QString, QString> params;
-    params["offset"] = QString::number(offset);
-    params["limit"] = QString::number(limit);
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery), params));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
-
-    return new SongList(NetworkAccessManager::instance()->get(request));
+SongList* Music::getSongs(int offset, int limit, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/songs/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.addQueryItem("offset", QString::number(offset));
+    builder.addQueryItem("limit", QString::number(limit));
+
+    return new SongList(builder.get());
 }
 
-SongList* Music::getAlbumSongs(const QString &albumId) {
-    QUrl url(BASE_URL_MUSIC + "/albums/" + albumId + "/");
-#if QT_VERSION >= 0x050000
-    QUrlQuery query(url);
-    query.addQueryItem("album_id", albumId);
-    url.setQuery(query);
-#else
-    url.addQueryItem("album_id", albumId);
-#endif
-    QMap<QString, QString> params;
-    params["album_id"] = albumId;
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery), params));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
-
-    return new SongList(NetworkAccessManager::instance()->get(request));
+SongList* Music::getAlbumSongs(const QString &albumId, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/albums/" + albumId + "/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.addQueryItem("album_id", albumId);
+
+    return new SongList(builder.get());
 }
 
-SongList* Music::getPlaylistSongs(const QString &playlistId) {
-    QUrl url(BASE_URL_MUSIC + "/playlists/" + playlistId + "/");
-#if QT_VERSION >= 0x050000
-    QUrlQuery query(url);
-    query.addQueryItem("playlist_id", playlistId);
-    url.setQuery(query);
-#else
-    url.addQueryItem("playlist_id", playlistId);
-#endif
-    QMap<QString, QString> params;
-    params["playlist_id"] = playlistId;
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery), params));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
-
-    return new SongList(NetworkAccessManager::instance()->get(request));
+SongList* Music::getPlaylistSongs(const QString &playlistId, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/playlists/" + playlistId + "/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.addQueryItem("playlist_id", playlistId);
+
+    return new SongList(builder.get());
 }
 
-PlaylistList* Music::getPlaylists() {
-    QUrl url(BASE_URL_MUSIC + "/playlists/");
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+PlaylistList* Music::getPlaylists(Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/playlists/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.setCacheable(true);
 
-    return new PlaylistList(NetworkAccessManager::instance()->get(request));
+    return new PlaylistList(builder.get());
 }
 
-PlaylistList* Music::getPlaylists(int offset, int limit) {
-    QUrl url(BASE_URL_MUSIC + "/playlists/");
-#if QT_VERSION >= 0x050000
-    QUrlQuery query(url);
-    query.addQueryItem("offset", QString::number(offset));
-    query.addQueryItem("limit", QString::number(limit));
-    url.setQuery(query);
-#else
-    url.addQueryItem("offset", QString::number(offset));
-    url.addQueryItem("limit", QString::number(limit));
-#endif
-    QMap<QString, QString> params;
-    params["offset"] = QString::number(offset);
-    params["limit"] = QString::number(limit);
-    QNetworkRequest request(url);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery), params));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
-
-    return new PlaylistList(NetworkAccessManager::instance()->get(request));
+PlaylistList* Music::getPlaylists(int offset, int limit, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/playlists/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.setCacheable(true);
+    builder.addQueryItem("offset", QString::number(offset));
+    builder.addQueryItem("limit", QString::number(limit));
+
+    return new PlaylistList(builder.get());
 }
 
-Playlist* Music::createPlaylist(const QString &title) {
-    QUrl url(BASE_URL_MUSIC + "/playlists/");
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("POST", url.toString(QUrl::RemoveQuery), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Playlist* Music::createPlaylist(const QString &title, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/playlists/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
 
-    return new Playlist(NetworkAccessManager::instance()->put(request, "{ \"name\": \"" + title.toUtf8() + "\" }"));
+    return new Playlist(builder.putJson(QtJson::JsonWriter().beginObject().key("name").value(title).endObject().data()));
 }
 
-Playlist* Music::createPlaylist(const QString &title, const QStringList &songIds) {
-    QUrl url(BASE_URL_MUSIC + "/playlists/");
-    QString json = QString("{ \"name\": \"%1\", \"song_id_list\": [ %2 ] }").arg(title).arg(songIds.join(", "));
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("PUT", url.toString(QUrl::RemoveQuery), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Playlist* Music::createPlaylist(const QString &title, const QStringList &songIds, Session *session, NetworkSettings::Priority priority) {
+    QByteArray json = QtJson::JsonWriter().beginObject().key("name").value(title).key("song_id_list").value(songIds).endObject().data();
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/playlists/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
 
-    return new Playlist(NetworkAccessManager::instance()->put(request, json.toUtf8()));
+    return new Playlist(builder.putJson(json));
 }
 
-Reply* Music::updatePlaylist(const QString &id, const QString &title) {
-    QUrl url(BASE_URL_MUSIC + "/playlists/" + id + "/");
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("PUT", url.toString(QUrl::RemoveQuery), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Reply* Music::updatePlaylist(const QString &id, const QString &title, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/playlists/" + id + "/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
 
-    return new Reply(NetworkAccessManager::instance()->put(request, "{ \"name\": \"" + title.toUtf8() + "\" }"));
+    return new Reply(builder.putJson(QtJson::JsonWriter().beginObject().key("name").value(title).endObject().data()));
 }
 
-Reply* Music::updatePlaylist(const QString &id, const QStringList &songIds) {
-    QUrl url(BASE_URL_MUSIC + "/playlists/" + id + "/");
-    QString json = QString("{ \"song_id_list\": [ %1 ] }").arg(songIds.join(", "));
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("PUT", url.toString(QUrl::RemoveQuery), QMap<QString, QString>()));
-    request.setRawHeader("Accept", "application/json");
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Reply* Music::updatePlaylist(const QString &id, const QStringList &songIds, Session *session, NetworkSettings::Priority priority) {
+    QByteArray json = QtJson::JsonWriter().beginObject().key("song_id_list").value(songIds).endObject().data();
+    RequestBuilder builder(QUrl(BASE_URL_MUSIC + "/playlists/" + id + "/"), RequestBuilder::SignPath, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
 
-    return new Reply(NetworkAccessManager::instance()->put(request, json.toUtf8()));
+    return new Reply(builder.putJson(json));
 }
 
-Artwork* Music::getArtwork(const QUrl &artworkUrl) {
-    return Music::getArtwork(artworkUrl, QSize());
+Artwork* Music::getArtwork(const QUrl &artworkUrl, Session *session, NetworkSettings::Priority priority) {
+    return Music::getArtwork(artworkUrl, QSize(), session, priority);
 }
 
-Artwork* Music::getArtwork(const QUrl &artworkUrl, const QSize &size) {
-    QNetworkRequest request(artworkUrl);
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", artworkUrl.toString(), QMap<QString, QString>()));
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+Artwork* Music::getArtwork(const QUrl &artworkUrl, const QSize &size, Session *session, NetworkSettings::Priority priority) {
+    RequestBuilder builder(artworkUrl, RequestBuilder::SignUrl, session);
+    builder.setPriority(RequestBuilder::Priority(priority));
+    builder.setAcceptJson(false);
+    builder.setPriority(RequestBuilder::Interactive);
 
-    return new Artwork(NetworkAccessManager::instance()->get(request), size);
+    return new Artwork(builder.get(), size);
 }
 
-MusicStream* Music::getMusicStream(const QUrl &url, const QString &localPath) {
-    return new MusicStream(url, localPath);
+MusicStream* Music::getMusicStream(const QUrl &url, const QString &localPath, Session *session) {
+    MusicStream *stream = new MusicStream(url, localPath);
+    stream->setSession(session);
+
+    return stream;
 }
 
 }
@@ -23,6 +23,7 @@
 #define MUSIC_H
 
 #include "qubuntuone_global.h"
+#include "networksettings.h"
 #include <QObject>
 
 class QUrl;
@@ -38,6 +39,7 @@ class SongList;
 class Reply;
 class Artwork;
 class MusicStream;
+class Session;
 
 /**
  * \class Music
@@ -57,9 +59,12 @@ public:
      * Requests a list of artists for the currently authenticated user,
      * and returns an ArtistList instance that handles the response.
      *
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
+     *
      * \return ArtistList* An instance of ArtistList that contains the response metadata.
      */
-    Q_INVOKABLE static ArtistList* getArtists();
+    Q_INVOKABLE static ArtistList* getArtists(Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests a list of artists for the currently authenticated user,
@@ -67,18 +72,23 @@ public:
      *
      * \param offset
      * \param limit
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return ArtistList* An instance of ArtistList that contains the response metadata.
      */
-    Q_INVOKABLE static ArtistList* getArtists(int offset, int limit);
+    Q_INVOKABLE static ArtistList* getArtists(int offset, int limit, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests a list of albums for the currently authenticated user,
      * and returns an AlbumList instance that handles the response.
      *
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
+     *
      * \return AlbumList* An instance of AlbumList that contains the response metadata.
      */
-    Q_INVOKABLE static AlbumList* getAlbums();
+    Q_INVOKABLE static AlbumList* getAlbums(Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests a list of albums for the currently authenticated user,
@@ -86,28 +96,35 @@ public:
      *
      * \param offset
      * \param limit
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return AlbumList* An instance of AlbumList that contains the response metadata.
      */
-    Q_INVOKABLE static AlbumList* getAlbums(int offset, int limit);
+    Q_INVOKABLE static AlbumList* getAlbums(int offset, int limit, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests the albums from the specified artist for the currently authenticated user,
      * and returns an AlbumList instance that handles the response.
      *
      * \param artistId
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return AlbumList* An instance of AlbumList that contains the response metadata.
      */
-    Q_INVOKABLE static AlbumList* getArtistAlbums(const QString &artistId);
+    Q_INVOKABLE static AlbumList* getArtistAlbums(const QString &artistId, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests a list of songs for the currently authenticated user,
      * and returns a SongList instance that handles the response.
      *
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
+     *
      * \return SongList* An instance of SongList that contains the response metadata.
      */
-    Q_INVOKABLE static SongList* getSongs();
+    Q_INVOKABLE static SongList* getSongs(Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests a list of songs for the currently authenticated user,
@@ -115,38 +132,47 @@ public:
      *
      * \param offset
      * \param limit
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return SongList* An instance of SongList that contains the response metadata.
      */
-    Q_INVOKABLE static SongList* getSongs(int offset, int limit);
+    Q_INVOKABLE static SongList* getSongs(int offset, int limit, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests the songs from the specified album for the currently authenticated user,
      * and returns a SongList instance that handles the response.
      *
      * \param albumId
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return SongList* An instance of SongList that contains the response metadata.
      */
-    Q_INVOKABLE static SongList* getAlbumSongs(const QString &albumId);
+    Q_INVOKABLE static SongList* getAlbumSongs(const QString &albumId, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests the songs from the specified playlist for the currently authenticated user,
      * and returns a SongList instance that handles the response.
      *
      * \param playlistId
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return SongList* An instance of SongList that contains the response metadata.
      */
-    Q_INVOKABLE static SongList* getPlaylistSongs(const QString &playlistId);
+    Q_INVOKABLE static SongList* getPlaylistSongs(const QString &playlistId, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests a list of playlists for the currently authenticated user,
      * and returns a PlaylistList instance that handles the response.
      *
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
+     *
      * \return PlaylistList* An instance of Reply that contains the response metadata.
      */
-    Q_INVOKABLE static PlaylistList* getPlaylists();
+    Q_INVOKABLE static PlaylistList* getPlaylists(Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests a list of playlists for the currently authenticated user,
@@ -154,20 +180,24 @@ public:
      *
      * \param offset
      * \param limit
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return PlaylistList* An instance of Reply that contains the response metadata.
      */
-    Q_INVOKABLE static PlaylistList* getPlaylists(int offset, int limit);
+    Q_INVOKABLE static PlaylistList* getPlaylists(int offset, int limit, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Creates a playlist for the currently authenticated user,
      * and returns a Playlist instance that handles the response.
      *
      * \param title
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Playlist* An instance of Reply that contains the response metadata.
      */
-    Q_INVOKABLE static Playlist* createPlaylist(const QString &title);
+    Q_INVOKABLE static Playlist* createPlaylist(const QString &title, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Creates a playlist for the currently authenticated user,
@@ -175,10 +205,12 @@ public:
      *
      * \param title
      * \param songIds
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Playlist* An instance of Playlist that contains the response metadata.
      */
-    Q_INVOKABLE static Playlist* createPlaylist(const QString &title, const QStringList &songIds);
+    Q_INVOKABLE static Playlist* createPlaylist(const QString &title, const QStringList &songIds, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Updates the title of the specified playlist for the currently authenticated user,
@@ -186,10 +218,12 @@ public:
      *
      * \param playlistId
      * \param title
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Reply* An instance of Reply that contains the response metadata.
      */
-    Q_INVOKABLE static Reply* updatePlaylist(const QString &playlistId, const QString &title);
+    Q_INVOKABLE static Reply* updatePlaylist(const QString &playlistId, const QString &title, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Updates the song list of the specified playlist for the currently authenticated user,
@@ -197,19 +231,23 @@ public:
      *
      * \param playlistId
      * \param songIds
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Reply* An instance of Reply that contains the response metadata.
      */
-    Q_INVOKABLE static Reply* updatePlaylist(const QString &playlistId, const QStringList &songIds);
+    Q_INVOKABLE static Reply* updatePlaylist(const QString &playlistId, const QStringList &songIds, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::NormalPriority);
 
     /**
      * Requests the requested artwork image, and returns an Artwork instance that handles the repsonse.
      *
      * \param artworkUrl
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Artwork* An instance of Artwork that contains the response metadata.
      */
-    Q_INVOKABLE static Artwork* getArtwork(const QUrl &artworkUrl);
+    Q_INVOKABLE static Artwork* getArtwork(const QUrl &artworkUrl, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::InteractivePriority);
 
     /**
      * Requests the requested artwork image, and returns an Artwork instance that handles the repsonse.
@@ -217,10 +255,12 @@ public:
      *
      * \param artworkUrl
      * \param size
+     * \param session The session whose credentials sign the request, or 0 for the default session.
+     * \param priority How the request is ordered among queued requests.
      *
      * \return Artwork* An instance of Artwork that contains the response metadata.
      */
-    Q_INVOKABLE static Artwork* getArtwork(const QUrl &artworkUrl, const QSize &size);
+    Q_INVOKABLE static Artwork* getArtwork(const QUrl &artworkUrl, const QSize &size, Session *session = 0, NetworkSettings::Priority priority = NetworkSettings::InteractivePriority);
 
     /**
      * Creates a MusicStream instance that performs streaming of the song specified by the stream URL.
@@ -228,10 +268,11 @@ public:
      *
      * \param streamUrl
      * \param localPath
+     * \param session The session whose credentials sign the request, or 0 for the default session.
      *
      * \return MusicStream*.
      */
-    Q_INVOKABLE static MusicStream* getMusicStream(const QUrl &streamUrl, const QString &localPath);
+    Q_INVOKABLE static MusicStream* getMusicStream(const QUrl &streamUrl, const QString &localPath, Session *session = 0);
 };
 
 }
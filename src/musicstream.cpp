@@ -80,6 +80,24 @@ void MusicStream::setFilePath(const QString &path) {
     d->setFilePath(path);
 }
 
+/**
+ * session
+ */
+Session* MusicStream::session() const {
+    Q_D(const MusicStream);
+
+    return d->session();
+}
+
+/**
+ * setSession
+ */
+void MusicStream::setSession(Session *session) {
+    Q_D(MusicStream);
+
+    d->setSession(session);
+}
+
 /**
  * streamSize
  */
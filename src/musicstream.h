@@ -29,6 +29,7 @@
 
 namespace QtUbuntuOne {
 
+class Session;
 class MusicStreamPrivate;
 
 /**
@@ -144,6 +145,22 @@ public:
      */
     void setFilePath(const QString &path);
 
+    /**
+     * Returns the session whose credentials sign the stream request,
+     * or 0 if the default session is used.
+     *
+     * \return Session*
+     */
+    Session* session() const;
+
+    /**
+     * Sets the session whose credentials sign the stream request.
+     * The session must outlive the stream. Pass 0 to use the default session.
+     *
+     * \param session
+     */
+    void setSession(Session *session);
+
     /**
      * Returns the size of the stream.
      *
@@ -16,8 +16,7 @@
  */
 
 #include "musicstream_p.h"
-#include "authentication.h"
-#include "networkaccessmanager.h"
+#include "requestbuilder.h"
 #include <QDir>
 #include <QDebug>
 
@@ -28,6 +27,7 @@ static const int BUFFER_SIZE = 1024 * 100;
 MusicStreamPrivate::MusicStreamPrivate(MusicStream *parent) :
     q_ptr(parent),
     m_reply(0),
+    m_session(0),
     m_size(0),
     m_resumePosition(0),
     m_transferredBytes(0),
@@ -43,6 +43,7 @@ MusicStreamPrivate::MusicStreamPrivate(const QUrl &url, const QString &filePath,
     m_reply(0),
     m_file(filePath),
     m_url(url),
+    m_session(0),
     m_size(0),
     m_resumePosition(0),
     m_transferredBytes(0),
@@ -84,6 +85,14 @@ void MusicStreamPrivate::setFilePath(const QString &path) {
     m_file.setFileName(path);
 }
 
+Session* MusicStreamPrivate::session() const {
+    return m_session;
+}
+
+void MusicStreamPrivate::setSession(Session *session) {
+    m_session = session;
+}
+
 qint64 MusicStreamPrivate::streamSize() const {
     return m_size;
 }
@@ -244,15 +253,14 @@ void MusicStreamPrivate::stop() {
 void MusicStreamPrivate::performDownload(const QUrl &url) {
     Q_Q(MusicStream);
 
-    QNetworkRequest request(url);
+    RequestBuilder builder(url, RequestBuilder::SignPath, m_session);
+    builder.setAcceptJson(false);
 
     if (this->resumePosition() > 0) {
-        request.setRawHeader("Range", QByteArray::number(this->resumePosition()) + "-");
+        builder.setRawHeader("Range", QByteArray::number(this->resumePosition()) + "-");
     }
 
-    request.setRawHeader("Authorization", Authentication::getOAuthHeader("GET", url.toString(QUrl::RemoveQuery), QMap<QString, QString>()));
-    request.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
-    m_reply = NetworkAccessManager::instance()->get(request);
+    m_reply = builder.get();
     q->connect(m_reply, SIGNAL(downloadProgress(qint64,qint64)), q, SLOT(_q_onProgressChanged(qint64,qint64)));
     q->connect(m_reply, SIGNAL(readyRead()), q, SLOT(_q_onReadyRead()));
     q->connect(m_reply, SIGNAL(finished()), q, SLOT(_q_onDownloadFinished()));
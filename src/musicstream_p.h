@@ -36,6 +36,9 @@ public:
 
     QString filePath() const;
 
+    Session* session() const;
+    void setSession(Session *session);
+
     qint64 streamSize() const;
 
     qint64 streamPosition() const;
@@ -95,6 +98,8 @@ private:
 
     QString m_filePath;
 
+    Session *m_session;
+
     qint64 m_size;
 
     qint64 m_resumePosition;
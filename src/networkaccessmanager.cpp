@@ -16,17 +16,48 @@
  */
 
 #include "networkaccessmanager.h"
+#include "queuedreply.h"
+#include "urls.h"
+#include <QAbstractNetworkCache>
+#include <QCryptographicHash>
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QLocale>
+#if QT_VERSION >= 0x050000
+#include <QUrlQuery>
+#endif
+
+// Below the 6 connections per host that QNetworkAccessManager opens itself, so that
+// waiting requests stay in our queues, where they are ordered by priority
+static const int MAX_CONNECTIONS_PER_HOST = 4;
+
+static const int MAX_RETRIES = 3;
+static const int RETRY_BASE_DELAY = 500;
+static const int RETRY_MAX_DELAY = 30000;
+
+// The retry budget is kept in tenths of a retry. Each request adds one
+// tenth, so that sustained retries stay below 10% of requests.
+static const int RETRY_TOKEN_COST = 10;
+static const int RETRY_TOKENS_MAX = 100;
 
 NetworkAccessManager* NetworkAccessManager::m_instance = 0;
 
 NetworkAccessManager::NetworkAccessManager() :
-    QNetworkAccessManager()
+    QNetworkAccessManager(),
+    m_maximumConnectionsPerHost(MAX_CONNECTIONS_PER_HOST),
+    m_maximumRetries(MAX_RETRIES),
+    m_retryTokens(RETRY_TOKENS_MAX),
+    m_jitter(quint32(QDateTime::currentMSecsSinceEpoch()) ^ quint32(QCoreApplication::applicationPid())),
+    m_responseCache(0)
 {
     if (!m_instance) {
         m_instance = this;
     }
 
+    m_clock.start();
+    m_rateLimitTimer.setSingleShot(true);
+    this->connect(&m_rateLimitTimer, SIGNAL(timeout()), this, SLOT(onRateLimitTimeout()));
+
     this->connect(QCoreApplication::instance(), SIGNAL(aboutToQuit()), this, SLOT(deleteLater()));
 }
 
@@ -35,3 +66,482 @@ NetworkAccessManager::~NetworkAccessManager() {}
 NetworkAccessManager* NetworkAccessManager::instance() {
     return !m_instance ? new NetworkAccessManager : m_instance;
 }
+
+int NetworkAccessManager::maximumConnectionsPerHost() const {
+    return m_maximumConnectionsPerHost;
+}
+
+void NetworkAccessManager::setMaximumConnectionsPerHost(int maximum) {
+    m_maximumConnectionsPerHost = maximum;
+
+    foreach (const QString &host, m_queues.keys()) {
+        this->dispatch(host);
+    }
+}
+
+int NetworkAccessManager::maximumConnections(const QString &host) const {
+    return m_maximumConnections.value(host, m_maximumConnectionsPerHost);
+}
+
+void NetworkAccessManager::setMaximumConnections(const QString &host, int maximum) {
+    m_maximumConnections[host] = maximum;
+    this->dispatch(host);
+}
+
+void NetworkAccessManager::resetMaximumConnections(const QString &host) {
+    m_maximumConnections.remove(host);
+    this->dispatch(host);
+}
+
+int NetworkAccessManager::activeConnections(const QString &host) const {
+    return m_activeConnections.value(host);
+}
+
+int NetworkAccessManager::queuedRequests(const QString &host) const {
+    int count = 0;
+
+    foreach (const QPointer<QueuedReply> &reply, m_queues.value(host)) {
+        if ((reply) && (!reply->isFinished())) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+int NetworkAccessManager::maximumRetries() const {
+    return m_maximumRetries;
+}
+
+void NetworkAccessManager::setMaximumRetries(int retries) {
+    m_maximumRetries = retries;
+}
+
+bool NetworkAccessManager::isTransientError(QNetworkReply::NetworkError error) {
+    switch (error) {
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyConnectionClosedError:
+    case QNetworkReply::ProxyTimeoutError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool NetworkAccessManager::isTransientStatus(int status) {
+    switch (status) {
+    case 408: // Request Timeout
+    case 429: // Too Many Requests
+    case 502: // Bad Gateway
+    case 503: // Service Unavailable
+    case 504: // Gateway Timeout
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * Returns a random delay between half of and the full exponential
+ * backoff for the given attempt, so that clients that failed together
+ * do not retry together.
+ */
+int NetworkAccessManager::backoffDelay(int attempt) {
+    const int delay = RETRY_BASE_DELAY << qBound(0, attempt, 6);
+    const int maximum = qMin(delay, RETRY_MAX_DELAY);
+
+    m_jitter = m_jitter * 1103515245 + 12345;
+
+    return maximum / 2 + int((m_jitter >> 8) % uint(maximum / 2 + 1));
+}
+
+bool NetworkAccessManager::takeRetryToken() {
+    if (m_retryTokens < RETRY_TOKEN_COST) {
+        return false;
+    }
+
+    m_retryTokens -= RETRY_TOKEN_COST;
+
+    return true;
+}
+
+/**
+ * Returns the delay in msecs before a failed request is sent again, or
+ * -1 if it should not be retried.
+ */
+int NetworkAccessManager::retryDelay(const QueuedReply *reply, const QNetworkReply *failed) {
+    switch (reply->operation()) {
+    case QNetworkAccessManager::GetOperation:
+    case QNetworkAccessManager::HeadOperation:
+    case QNetworkAccessManager::PutOperation:
+    case QNetworkAccessManager::DeleteOperation:
+        break;
+    default:
+        return -1;
+    }
+
+    if (reply->attempts() >= m_maximumRetries) {
+        return -1;
+    }
+
+    // The request body must be sent again from the start
+    if ((reply->outgoingData()) && (reply->outgoingData()->isSequential())) {
+        return -1;
+    }
+
+    int delay = -1;
+    const QByteArray retryAfter = failed->rawHeader("Retry-After").trimmed();
+
+    if (!retryAfter.isEmpty()) {
+        // Either a number of seconds or an HTTP date
+        bool ok;
+        qint64 seconds = retryAfter.toLongLong(&ok);
+
+        if (!ok) {
+            QDateTime date = QLocale::c().toDateTime(QString::fromLatin1(retryAfter), "ddd, dd MMM yyyy hh:mm:ss 'GMT'");
+
+            if (date.isValid()) {
+                date.setTimeSpec(Qt::UTC);
+                seconds = qMax(Q_INT64_C(0), QDateTime::currentDateTime().toUTC().secsTo(date));
+                ok = true;
+            }
+        }
+
+        if (ok) {
+            if (seconds * 1000 > RETRY_MAX_DELAY) {
+                return -1;
+            }
+
+            delay = int(seconds * 1000);
+        }
+    }
+
+    if (!this->takeRetryToken()) {
+        return -1;
+    }
+
+    return delay >= 0 ? delay : this->backoffDelay(reply->attempts());
+}
+
+QNetworkReply* NetworkAccessManager::createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData) {
+    if (m_retryTokens < RETRY_TOKENS_MAX) {
+        m_retryTokens++;
+    }
+
+    QueuedReply *reply = new QueuedReply(op, request, outgoingData, this);
+    this->schedule(reply);
+
+    return reply;
+}
+
+NetworkAccessManager::Endpoint NetworkAccessManager::endpoint(const QUrl &url) {
+    const QString urlString = url.toString();
+
+    if (urlString.startsWith(BASE_URL_FILES)) {
+        return FilesMetadataEndpoint;
+    }
+
+    if (urlString.startsWith(CONTENT_ROOT_FILES)) {
+        return FilesContentEndpoint;
+    }
+
+    if (urlString.startsWith(BASE_URL_MUSIC)) {
+        return MusicEndpoint;
+    }
+
+    if ((urlString.startsWith(BASE_URL_ACCOUNT)) || (urlString.startsWith(BASE_URL_QUOTA))) {
+        return AccountEndpoint;
+    }
+
+    return OtherEndpoint;
+}
+
+qreal NetworkAccessManager::rateLimit(Endpoint endpoint) const {
+    return m_rateLimits.value(endpoint).rate;
+}
+
+int NetworkAccessManager::rateLimitBurst(Endpoint endpoint) const {
+    return m_rateLimits.value(endpoint).burst;
+}
+
+void NetworkAccessManager::setRateLimit(Endpoint endpoint, qreal requestsPerSecond, int burst) {
+    RateLimit &limit = m_rateLimits[endpoint];
+    NetworkAccessManager::refill(limit, m_clock.elapsed());
+    // A new limit starts with a full bucket, and a changed limit keeps its tokens, up to the new burst
+    limit.tokens = limit.rate > 0 ? qMin(limit.tokens, qreal(qMax(1, burst))) : qMax(1, burst);
+    limit.rate = requestsPerSecond;
+    limit.burst = qMax(1, burst);
+
+    if (limit.rate <= 0) {
+        // Release anything that was waiting for the old limit
+        while (!limit.queue.isEmpty()) {
+            QPointer<QueuedReply> reply = limit.queue.takeFirst();
+
+            if ((reply) && (!reply->isFinished())) {
+                this->sendWhenConnected(reply);
+            }
+        }
+    }
+    else {
+        this->startRateLimitTimer();
+    }
+}
+
+int NetworkAccessManager::rateLimitedRequests(Endpoint endpoint) const {
+    return m_rateLimits.value(endpoint).limitedRequests;
+}
+
+/**
+ * Returns the total time in msecs that requests to the endpoint have
+ * spent waiting for the rate limit.
+ */
+qint64 NetworkAccessManager::rateLimitedTime(Endpoint endpoint) const {
+    return m_rateLimits.value(endpoint).limitedTime;
+}
+
+QAbstractNetworkCache* NetworkAccessManager::responseCache() const {
+    return m_responseCache;
+}
+
+void NetworkAccessManager::setResponseCache(QAbstractNetworkCache *cache) {
+    if (cache == m_responseCache) {
+        return;
+    }
+
+    if (m_responseCache) {
+        delete m_responseCache;
+    }
+
+    m_responseCache = cache;
+
+    if (m_responseCache) {
+        m_responseCache->setParent(this);
+    }
+}
+
+static QByteArray oauthParameter(const QByteArray &header, const QByteArray &name) {
+    const int start = header.indexOf(name + "=\"");
+
+    if (start < 0) {
+        return QByteArray();
+    }
+
+    const int valueStart = start + name.size() + 2;
+
+    return header.mid(valueStart, header.indexOf('"', valueStart) - valueStart);
+}
+
+/**
+ * Returns the URL under which the response to the request is cached.
+ *
+ * A __cred query item, which is never sent, identifies the credentials the
+ * request was signed with, so that sessions do not share entries. A query
+ * item is used rather than the fragment, which caches such as
+ * QNetworkDiskCache strip from the url.
+ */
+QUrl NetworkAccessManager::cacheKey(const QNetworkRequest &request) {
+    QUrl key = request.url();
+    key.setFragment(QString());
+    const QByteArray authorization = request.rawHeader("Authorization");
+
+    if (!authorization.isEmpty()) {
+        const QString credentials = QString::fromLatin1(QCryptographicHash::hash(oauthParameter(authorization, "oauth_consumer_key")
+                                                                                 + '&' + oauthParameter(authorization, "oauth_token"),
+                                                                                 QCryptographicHash::Sha1).toHex());
+#if QT_VERSION >= 0x050000
+        QUrlQuery query(key);
+        query.addQueryItem("__cred", credentials);
+        key.setQuery(query);
+#else
+        key.addQueryItem("__cred", credentials);
+#endif
+    }
+
+    return key;
+}
+
+void NetworkAccessManager::refill(RateLimit &limit, qint64 now) {
+    if (limit.rate > 0) {
+        limit.tokens = qMin(qreal(limit.burst), limit.tokens + (now - limit.updated) * limit.rate / 1000);
+    }
+
+    limit.updated = now;
+}
+
+bool NetworkAccessManager::takeRateToken(QueuedReply *reply) {
+    QHash<int, RateLimit>::iterator iterator = m_rateLimits.find(NetworkAccessManager::endpoint(reply->request().url()));
+
+    if ((iterator == m_rateLimits.end()) || (iterator.value().rate <= 0)) {
+        return true;
+    }
+
+    RateLimit &limit = iterator.value();
+    const qint64 now = m_clock.elapsed();
+    NetworkAccessManager::refill(limit, now);
+
+    if ((limit.queue.isEmpty()) && (limit.tokens >= 1)) {
+        limit.tokens -= 1;
+        return true;
+    }
+
+    reply->setQueuedAt(now);
+    NetworkAccessManager::enqueue(limit.queue, reply);
+    limit.limitedRequests++;
+    this->startRateLimitTimer();
+
+    return false;
+}
+
+void NetworkAccessManager::startRateLimitTimer() {
+    int msecs = -1;
+
+    for (QHash<int, RateLimit>::const_iterator iterator = m_rateLimits.constBegin(); iterator != m_rateLimits.constEnd(); ++iterator) {
+        const RateLimit &limit = iterator.value();
+
+        if ((!limit.queue.isEmpty()) && (limit.rate > 0)) {
+            const int wait = qMax(1, int((1 - limit.tokens) * 1000 / limit.rate + 1));
+            msecs = msecs < 0 ? wait : qMin(msecs, wait);
+        }
+    }
+
+    if (msecs >= 0) {
+        m_rateLimitTimer.start(msecs);
+    }
+}
+
+void NetworkAccessManager::onRateLimitTimeout() {
+    const qint64 now = m_clock.elapsed();
+
+    for (QHash<int, RateLimit>::iterator iterator = m_rateLimits.begin(); iterator != m_rateLimits.end(); ++iterator) {
+        RateLimit &limit = iterator.value();
+        NetworkAccessManager::refill(limit, now);
+
+        while ((!limit.queue.isEmpty()) && (limit.tokens >= 1)) {
+            QPointer<QueuedReply> reply = limit.queue.takeFirst();
+
+            // Skip requests that were aborted or deleted while waiting
+            if ((reply) && (!reply->isFinished())) {
+                limit.tokens -= 1;
+                limit.limitedTime += now - reply->queuedAt();
+                this->sendWhenConnected(reply);
+            }
+        }
+    }
+
+    this->startRateLimitTimer();
+}
+
+void NetworkAccessManager::schedule(QueuedReply *reply) {
+    if (this->takeRateToken(reply)) {
+        this->sendWhenConnected(reply);
+    }
+}
+
+void NetworkAccessManager::sendWhenConnected(QueuedReply *reply) {
+    const QString host = reply->request().url().host();
+    const int maximum = this->maximumConnections(host);
+
+    if ((maximum <= 0) || (m_activeConnections.value(host) < maximum)) {
+        this->send(host, reply);
+    }
+    else {
+        NetworkAccessManager::enqueue(m_queues[host], reply);
+    }
+}
+
+void NetworkAccessManager::send(const QString &host, QueuedReply *reply) {
+    QNetworkRequest request = reply->request();
+    QIODevice *outgoingData = reply->outgoingData();
+
+    if ((outgoingData) && (reply->attempts() > 0)) {
+        outgoingData->reset();
+    }
+
+    if (reply->signer()) {
+        const QByteArray authorization = reply->signer()->authorization();
+
+        if (!authorization.isEmpty()) {
+            request.setRawHeader("Authorization", authorization);
+        }
+    }
+
+    if ((m_responseCache) && (reply->operation() == QNetworkAccessManager::GetOperation)
+        && (request.attribute(QNetworkRequest::CacheSaveControlAttribute, false).toBool())) {
+        const QUrl key = NetworkAccessManager::cacheKey(request);
+
+        foreach (const QNetworkCacheMetaData::RawHeader &header, m_responseCache->metaData(key).rawHeaders()) {
+            if (header.first.toLower() == "etag") {
+                request.setRawHeader("If-None-Match", header.second);
+                break;
+            }
+        }
+
+        reply->setCache(m_responseCache, key);
+    }
+
+    QNetworkReply *networkReply = QNetworkAccessManager::createRequest(reply->operation(), request, outgoingData);
+    m_activeConnections[host]++;
+    m_activeReplies.insert(networkReply, host);
+    this->connect(networkReply, SIGNAL(finished()), this, SLOT(onReplyFinished()));
+    this->connect(networkReply, SIGNAL(destroyed(QObject*)), this, SLOT(onReplyDestroyed(QObject*)));
+    reply->setReply(networkReply);
+}
+
+void NetworkAccessManager::enqueue(QList< QPointer<QueuedReply> > &queue, QueuedReply *reply) {
+    const QNetworkRequest::Priority priority = reply->request().priority();
+    int i = queue.size();
+
+    // Higher priorities have lower values
+    while ((i > 0) && ((!queue.at(i - 1)) || (queue.at(i - 1)->request().priority() > priority))) {
+        i--;
+    }
+
+    queue.insert(i, reply);
+}
+
+void NetworkAccessManager::releaseConnection(QObject *reply) {
+    if (!m_activeReplies.contains(reply)) {
+        return;
+    }
+
+    const QString host = m_activeReplies.take(reply);
+
+    if (--m_activeConnections[host] <= 0) {
+        m_activeConnections.remove(host);
+    }
+
+    this->dispatch(host);
+}
+
+void NetworkAccessManager::dispatch(const QString &host) {
+    if (!m_queues.contains(host)) {
+        return;
+    }
+
+    QList< QPointer<QueuedReply> > &queue = m_queues[host];
+    const int maximum = this->maximumConnections(host);
+
+    while ((!queue.isEmpty()) && ((maximum <= 0) || (m_activeConnections.value(host) < maximum))) {
+        QPointer<QueuedReply> reply = queue.takeFirst();
+
+        // Skip requests that were aborted or deleted while queued
+        if ((reply) && (!reply->isFinished())) {
+            this->send(host, reply);
+        }
+    }
+
+    if (queue.isEmpty()) {
+        m_queues.remove(host);
+    }
+}
+
+void NetworkAccessManager::onReplyFinished() {
+    this->releaseConnection(this->sender());
+}
+
+void NetworkAccessManager::onReplyDestroyed(QObject *reply) {
+    this->releaseConnection(reply);
+}
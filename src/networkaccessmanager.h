@@ -19,19 +19,148 @@
 #define NETWORKACCESSMANAGER_H
 
 #include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QTimer>
 
+class QueuedReply;
+class QAbstractNetworkCache;
+
+/**
+ * The network access manager shared by all requests.
+ *
+ * The number of requests in flight to each host is limited. Requests
+ * over the limit are queued and sent as earlier requests to the same
+ * host finish, highest QNetworkRequest::priority() first and in order
+ * within each priority.
+ *
+ * Idempotent requests (GET, HEAD, PUT and DELETE) that fail with a
+ * transient error before any data is received are sent again after an
+ * exponential, jittered backoff, or after the delay given by the
+ * Retry-After header. Retries are drawn from a budget that grows with
+ * the number of requests made, so that a failing server is not flooded.
+ *
+ * Each endpoint family can also be given a token bucket rate limit.
+ * Requests over the limit wait, highest priority first, until a token
+ * is available, and the time they spend waiting is recorded.
+ *
+ * If a response cache is set, GET requests marked with
+ * QNetworkRequest::CacheSaveControlAttribute are revalidated with
+ * If-None-Match, and a 304 response is answered from the cache. Entries
+ * are keyed by URL and by the OAuth consumer and token keys.
+ */
 class NetworkAccessManager : public QNetworkAccessManager
 {
     Q_OBJECT
 
 public:
+    // The values match NetworkSettings::Endpoint
+    enum Endpoint {
+        OtherEndpoint = 0,
+        FilesMetadataEndpoint,
+        FilesContentEndpoint,
+        MusicEndpoint,
+        AccountEndpoint
+    };
+
     static NetworkAccessManager* instance();
 
+    // A limit of 0 or less means no limit
+    int maximumConnectionsPerHost() const;
+    void setMaximumConnectionsPerHost(int maximum);
+
+    int maximumConnections(const QString &host) const;
+    void setMaximumConnections(const QString &host, int maximum);
+    void resetMaximumConnections(const QString &host);
+
+    int activeConnections(const QString &host) const;
+    int queuedRequests(const QString &host) const;
+
+    int maximumRetries() const;
+    void setMaximumRetries(int retries);
+
+    static bool isTransientError(QNetworkReply::NetworkError error);
+    static bool isTransientStatus(int status);
+
+    int backoffDelay(int attempt);
+    bool takeRetryToken();
+
+    static Endpoint endpoint(const QUrl &url);
+
+    // A rate of 0 or less means no limit
+    qreal rateLimit(Endpoint endpoint) const;
+    int rateLimitBurst(Endpoint endpoint) const;
+    void setRateLimit(Endpoint endpoint, qreal requestsPerSecond, int burst = 1);
+
+    int rateLimitedRequests(Endpoint endpoint) const;
+    qint64 rateLimitedTime(Endpoint endpoint) const;
+
+    // The manager takes ownership of the cache. A null cache disables caching.
+    QAbstractNetworkCache* responseCache() const;
+    void setResponseCache(QAbstractNetworkCache *cache);
+
+    static QUrl cacheKey(const QNetworkRequest &request);
+
+protected:
+    QNetworkReply* createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData = 0);
+
+private slots:
+    void onReplyFinished();
+    void onReplyDestroyed(QObject *reply);
+    void onRateLimitTimeout();
+
 private:
     NetworkAccessManager();
     ~NetworkAccessManager();
 
+    struct RateLimit {
+        RateLimit() : rate(0), burst(1), tokens(1), updated(0), limitedRequests(0), limitedTime(0) {}
+
+        qreal rate;
+        int burst;
+        qreal tokens;
+        qint64 updated;
+        int limitedRequests;
+        qint64 limitedTime;
+        QList< QPointer<QueuedReply> > queue;
+    };
+
+    void schedule(QueuedReply *reply);
+    bool takeRateToken(QueuedReply *reply);
+    static void refill(RateLimit &limit, qint64 now);
+    void startRateLimitTimer();
+
+    void sendWhenConnected(QueuedReply *reply);
+    void send(const QString &host, QueuedReply *reply);
+    static void enqueue(QList< QPointer<QueuedReply> > &queue, QueuedReply *reply);
+    void releaseConnection(QObject *reply);
+    void dispatch(const QString &host);
+
+    int retryDelay(const QueuedReply *reply, const QNetworkReply *failed);
+
     static NetworkAccessManager* m_instance;
+
+    int m_maximumConnectionsPerHost;
+
+    QHash<QString, int> m_maximumConnections;
+    QHash<QString, int> m_activeConnections;
+    QHash<QObject*, QString> m_activeReplies;
+    QHash<QString, QList< QPointer<QueuedReply> > > m_queues;
+
+    int m_maximumRetries;
+    int m_retryTokens;
+    quint32 m_jitter;
+
+    QAbstractNetworkCache *m_responseCache;
+
+    QHash<int, RateLimit> m_rateLimits;
+    QElapsedTimer m_clock;
+    QTimer m_rateLimitTimer;
+
+    friend class QueuedReply;
 };
 
 #endif // NETWORKACCESSMANAGER_H
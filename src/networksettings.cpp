@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * \file networksettings.cpp
+ */
+
+#include "networksettings.h"
+#include "networkaccessmanager.h"
+
+namespace QtUbuntuOne {
+
+NetworkSettings::NetworkSettings(QObject *parent) :
+    QObject(parent)
+{
+}
+
+NetworkSettings::~NetworkSettings() {}
+
+/**
+ * maximumConnectionsPerHost
+ */
+int NetworkSettings::maximumConnectionsPerHost() {
+    return NetworkAccessManager::instance()->maximumConnectionsPerHost();
+}
+
+/**
+ * setMaximumConnectionsPerHost
+ */
+void NetworkSettings::setMaximumConnectionsPerHost(int maximum) {
+    NetworkAccessManager::instance()->setMaximumConnectionsPerHost(maximum);
+}
+
+/**
+ * maximumConnections
+ */
+int NetworkSettings::maximumConnections(const QString &host) {
+    return NetworkAccessManager::instance()->maximumConnections(host);
+}
+
+/**
+ * setMaximumConnections
+ */
+void NetworkSettings::setMaximumConnections(const QString &host, int maximum) {
+    NetworkAccessManager::instance()->setMaximumConnections(host, maximum);
+}
+
+/**
+ * resetMaximumConnections
+ */
+void NetworkSettings::resetMaximumConnections(const QString &host) {
+    NetworkAccessManager::instance()->resetMaximumConnections(host);
+}
+
+/**
+ * activeConnections
+ */
+int NetworkSettings::activeConnections(const QString &host) {
+    return NetworkAccessManager::instance()->activeConnections(host);
+}
+
+/**
+ * queuedRequests
+ */
+int NetworkSettings::queuedRequests(const QString &host) {
+    return NetworkAccessManager::instance()->queuedRequests(host);
+}
+
+/**
+ * maximumRetries
+ */
+int NetworkSettings::maximumRetries() {
+    return NetworkAccessManager::instance()->maximumRetries();
+}
+
+/**
+ * setMaximumRetries
+ */
+void NetworkSettings::setMaximumRetries(int retries) {
+    NetworkAccessManager::instance()->setMaximumRetries(retries);
+}
+
+
+/**
+ * rateLimit
+ */
+qreal NetworkSettings::rateLimit(Endpoint endpoint) {
+    return NetworkAccessManager::instance()->rateLimit(NetworkAccessManager::Endpoint(endpoint));
+}
+
+/**
+ * rateLimitBurst
+ */
+int NetworkSettings::rateLimitBurst(Endpoint endpoint) {
+    return NetworkAccessManager::instance()->rateLimitBurst(NetworkAccessManager::Endpoint(endpoint));
+}
+
+/**
+ * setRateLimit
+ */
+void NetworkSettings::setRateLimit(Endpoint endpoint, qreal requestsPerSecond, int burst) {
+    NetworkAccessManager::instance()->setRateLimit(NetworkAccessManager::Endpoint(endpoint), requestsPerSecond, burst);
+}
+
+/**
+ * rateLimitedRequests
+ */
+int NetworkSettings::rateLimitedRequests(Endpoint endpoint) {
+    return NetworkAccessManager::instance()->rateLimitedRequests(NetworkAccessManager::Endpoint(endpoint));
+}
+
+/**
+ * rateLimitedTime
+ */
+qint64 NetworkSettings::rateLimitedTime(Endpoint endpoint) {
+    return NetworkAccessManager::instance()->rateLimitedTime(NetworkAccessManager::Endpoint(endpoint));
+}
+
+
+/**
+ * responseCache
+ */
+QAbstractNetworkCache* NetworkSettings::responseCache() {
+    return NetworkAccessManager::instance()->responseCache();
+}
+
+/**
+ * setResponseCache
+ */
+void NetworkSettings::setResponseCache(QAbstractNetworkCache *cache) {
+    NetworkAccessManager::instance()->setResponseCache(cache);
+}
+
+}
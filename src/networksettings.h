@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * \file networksettings.h
+ */
+
+#ifndef NETWORKSETTINGS_H
+#define NETWORKSETTINGS_H
+
+#include "qubuntuone_global.h"
+#include <QObject>
+
+class QAbstractNetworkCache;
+
+namespace QtUbuntuOne {
+
+/**
+ * \class NetworkSettings
+ * \brief Configures how requests to the Ubuntu One API are sent.
+ *
+ * NetworkSettings configures the network access manager that is shared by
+ * all requests made by Files, Music and Account. The settings apply to
+ * requests that are made after they are changed.
+ */
+class QUBUNTUONESHARED_EXPORT NetworkSettings : public QObject
+{
+    Q_OBJECT
+
+    Q_ENUMS(Endpoint Priority)
+
+public:
+    /**
+     * \enum Endpoint
+     */
+    enum Endpoint {
+        OtherEndpoint = 0,
+        FilesMetadataEndpoint,
+        FilesContentEndpoint,
+        MusicEndpoint,
+        AccountEndpoint
+    };
+
+    /**
+     * \enum Priority
+     *
+     * When connections are saturated, queued requests are sent in order of priority.
+     * The values match QNetworkRequest::Priority.
+     */
+    enum Priority {
+        InteractivePriority = 1,
+        NormalPriority = 3,
+        BackgroundPriority = 5
+    };
+
+    NetworkSettings(QObject *parent = 0);
+    ~NetworkSettings();
+
+    /**
+     * Returns the maximum number of requests in flight to each host.
+     * Requests over the limit are queued, highest priority first. The default is 4.
+     *
+     * \return int
+     */
+    Q_INVOKABLE static int maximumConnectionsPerHost();
+
+    /**
+     * Sets the maximum number of requests in flight to each host.
+     * Pass 0 for no limit.
+     *
+     * \param maximum
+     */
+    Q_INVOKABLE static void setMaximumConnectionsPerHost(int maximum);
+
+    /**
+     * Returns the maximum number of requests in flight to the specified host.
+     *
+     * \param host
+     *
+     * \return int
+     */
+    Q_INVOKABLE static int maximumConnections(const QString &host);
+
+    /**
+     * Sets the maximum number of requests in flight to the specified host,
+     * overriding maximumConnectionsPerHost(). Pass 0 for no limit.
+     *
+     * \param host
+     * \param maximum
+     */
+    Q_INVOKABLE static void setMaximumConnections(const QString &host, int maximum);
+
+    /**
+     * Removes the limit set for the specified host, so that
+     * maximumConnectionsPerHost() applies.
+     *
+     * \param host
+     */
+    Q_INVOKABLE static void resetMaximumConnections(const QString &host);
+
+    /**
+     * Returns the number of requests in flight to the specified host.
+     *
+     * \param host
+     *
+     * \return int
+     */
+    Q_INVOKABLE static int activeConnections(const QString &host);
+
+    /**
+     * Returns the number of requests to the specified host that are
+     * waiting for a connection.
+     *
+     * \param host
+     *
+     * \return int
+     */
+    Q_INVOKABLE static int queuedRequests(const QString &host);
+
+    /**
+     * Returns the maximum number of times that a request is sent again after failing
+     * with a transient error, such as a timeout or a 503 response. The default is 3.
+     *
+     * Retries are made after an exponential backoff, or after the delay given by the
+     * Retry-After header, and are limited to roughly one in ten requests overall.
+     *
+     * \return int
+     */
+    Q_INVOKABLE static int maximumRetries();
+
+    /**
+     * Sets the maximum number of times that a request is sent again after failing
+     * with a transient error. Pass 0 to disable retries.
+     *
+     * \param retries
+     */
+    Q_INVOKABLE static void setMaximumRetries(int retries);
+
+    /**
+     * Returns the maximum rate, in requests per second, of requests to the specified endpoint.
+     * The default is 0, meaning no limit.
+     *
+     * \param endpoint
+     *
+     * \return qreal
+     */
+    Q_INVOKABLE static qreal rateLimit(Endpoint endpoint);
+
+    /**
+     * Returns the number of requests to the specified endpoint
+     * that can be sent at once before the rate limit applies.
+     *
+     * \param endpoint
+     *
+     * \return int
+     */
+    Q_INVOKABLE static int rateLimitBurst(Endpoint endpoint);
+
+    /**
+     * Sets the maximum rate, in requests per second, of requests to the specified endpoint,
+     * and the number of requests that can be sent at once before the rate applies.
+     * Requests over the limit wait, highest priority first. Pass a rate of 0 for no limit.
+     *
+     * \param endpoint
+     * \param requestsPerSecond
+     * \param burst
+     */
+    Q_INVOKABLE static void setRateLimit(Endpoint endpoint, qreal requestsPerSecond, int burst = 1);
+
+    /**
+     * Returns the number of requests to the specified endpoint that have waited for the rate limit.
+     *
+     * \param endpoint
+     *
+     * \return int
+     */
+    Q_INVOKABLE static int rateLimitedRequests(Endpoint endpoint);
+
+    /**
+     * Returns the total time in msecs that requests to the specified endpoint
+     * have spent waiting for the rate limit.
+     *
+     * \param endpoint
+     *
+     * \return qint64
+     */
+    Q_INVOKABLE static qint64 rateLimitedTime(Endpoint endpoint);
+
+    /**
+     * Returns the cache used to revalidate metadata responses, or 0 if no cache is used.
+     *
+     * \return QAbstractNetworkCache*
+     */
+    static QAbstractNetworkCache* responseCache();
+
+    /**
+     * Sets the cache used to revalidate metadata responses, such as the user, volume,
+     * artist, album, playlist and account requests. Cached responses are sent again
+     * with If-None-Match, and a 304 Not Modified response is answered from the cache.
+     * The default is 0, meaning no caching.
+     *
+     * Entries are cached under the request url plus a __cred query item identifying
+     * the credentials the request was signed with, so that sessions do not share entries.
+     *
+     * Ownership of the cache is taken, and any previous cache is deleted.
+     * Pass 0 to disable caching.
+     *
+     * \param cache For example, an instance of MemoryCache, or DiskCache to keep
+     * entries across application restarts.
+     */
+    static void setResponseCache(QAbstractNetworkCache *cache);
+};
+
+}
+
+Q_DECLARE_METATYPE(QtUbuntuOne::NetworkSettings::Endpoint)
+Q_DECLARE_METATYPE(QtUbuntuOne::NetworkSettings::Priority)
+
+#endif // NETWORKSETTINGS_H
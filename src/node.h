@@ -127,6 +127,8 @@ class QUBUNTUONESHARED_EXPORT Node : public QObject
 
     friend class Files;
     friend class NodeListPrivate;
+    friend class NodeCache;
+    friend class NodeIndexPrivate;
 
 public:
     /**
@@ -451,6 +453,7 @@ private:
     Q_DECLARE_PRIVATE(Node)
 
     Q_PRIVATE_SLOT(d_func(), void _q_onReplyFinished())
+    Q_PRIVATE_SLOT(d_func(), void _q_emitReady())
 };
 
 }
@@ -16,10 +16,76 @@
  */
 
 #include "node_p.h"
+#include "nodecache.h"
 #include "json.h"
+#include <QTimer>
 
 namespace QtUbuntuOne {
 
+static const char * const NODE_KEYS[] = {
+    "kind",
+    "path",
+    "resource_path",
+    "content_path",
+    "parent_path",
+    "volume_path",
+    "node_path",
+    "key",
+    "when_created",
+    "when_changed",
+    "generation",
+    "generation_created",
+    "hash",
+    "size",
+    "is_public",
+    "public_url",
+    "has_children",
+    "is_root"
+};
+
+enum NodeKeys {
+    KindKey = 0,
+    PathKey,
+    ResourcePathKey,
+    ContentPathKey,
+    ParentPathKey,
+    VolumePathKey,
+    NodePathKey,
+    KeyKey,
+    WhenCreatedKey,
+    WhenChangedKey,
+    GenerationKey,
+    GenerationCreatedKey,
+    HashKey,
+    SizeKey,
+    IsPublicKey,
+    PublicUrlKey,
+    HasChildrenKey,
+    IsRootKey,
+    NodeKeyCount
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(QtJson::JsonKeyTable, nodeKeyTable, (NODE_KEYS, NodeKeyCount))
+
+/**
+ * Binds the members of a single node response directly to the node
+ */
+class NodeReader : public QtJson::JsonObjectReader
+{
+
+public:
+    explicit NodeReader(NodePrivate *node) :
+        m_node(node)
+    {
+    }
+
+private:
+    void beginItem() { m_node->beginLoad(); }
+    void readItemValue(const QString &key, const QVariant &value) { m_node->loadProperty(key, value); }
+
+    NodePrivate *m_node;
+};
+
 NodePrivate::NodePrivate(Node *parent) :
     q_ptr(parent),
     m_reply(0),
@@ -98,6 +164,12 @@ NodePrivate::~NodePrivate() {
 void NodePrivate::loadNode(Node *otherNode) {
     Q_Q(Node);
 
+    this->copyNode(otherNode);
+
+    emit q->ready(q);
+}
+
+void NodePrivate::copyNode(Node *otherNode) {
     this->setNodeType(otherNode->nodeType());
     this->setPath(otherNode->path());
     this->setResourcePath(otherNode->resourcePath());
@@ -122,43 +194,136 @@ void NodePrivate::loadNode(Node *otherNode) {
     this->setErrorString(otherNode->errorString());
     this->setParentNode(otherNode->parentNode());
     this->setChildNodes(otherNode->childNodes());
+}
 
-    emit q->ready(q);
+/**
+ * Loads the node from the cache. The node is returned before anyone can
+ * connect to it, so ready() is emitted from the event loop.
+ */
+void NodePrivate::loadCachedNode(Node *cachedNode) {
+    Q_Q(Node);
+
+    this->copyNode(cachedNode);
+
+    QTimer::singleShot(0, q, SLOT(_q_emitReady()));
+}
+
+void NodePrivate::setCacheKey(const QString &key) {
+    m_cacheKey = key;
 }
 
 void NodePrivate::loadNode(const QVariantMap &node) {
-    Q_Q(Node);
+    this->beginLoad();
 
-    QString kind = node.value("kind").toString();
+    for (QVariantMap::const_iterator iterator = node.constBegin(); iterator != node.constEnd(); ++iterator) {
+        this->loadProperty(iterator.key(), iterator.value());
+    }
 
-    if (kind == "file") {
-        this->setNodeType(Node::File);
+    this->endLoad();
+}
+
+void NodePrivate::beginLoad() {
+    this->setPath(QString());
+    this->setResourcePath(QString());
+    this->setContentPath(QString());
+    this->setParentPath(QString());
+    this->setVolumePath(QString());
+    this->setNodePath(QString());
+    this->setKey(QString());
+    this->setWhenCreated(QDateTime());
+    this->setLastModified(QDateTime());
+    this->setGeneration(0);
+    this->setGenerationCreated(0);
+    this->setHash(QByteArray());
+    this->setSize(0);
+    this->setPublic(false);
+    this->setPublicUrl(QUrl());
+    this->setHasChildren(false);
+    this->setIsRoot(false);
+    this->setError(Node::NoError);
+    this->setErrorString(QString());
+}
+
+void NodePrivate::loadProperty(const QString &key, const QVariant &value) {
+    switch (nodeKeyTable()->indexOf(key)) {
+    case KindKey:
+    {
+        QString kind = value.toString();
+
+        if (kind == "file") {
+            this->setNodeType(Node::File);
+        }
+        else if (kind == "directory") {
+            this->setNodeType(Node::Directory);
+        }
+
+        break;
     }
-    else if (kind == "directory") {
-        this->setNodeType(Node::Directory);
+    case PathKey:
+        this->setPath(value.toString());
+        break;
+    case ResourcePathKey:
+        this->setResourcePath(value.toString());
+        break;
+    case ContentPathKey:
+        this->setContentPath(value.toString());
+        break;
+    case ParentPathKey:
+        this->setParentPath(value.toString());
+        break;
+    case VolumePathKey:
+        this->setVolumePath(value.toString());
+        break;
+    case NodePathKey:
+        this->setNodePath(value.toString());
+        break;
+    case KeyKey:
+        this->setKey(value.toString());
+        break;
+    case WhenCreatedKey:
+        this->setWhenCreated(QDateTime::fromString(value.toString(), Qt::ISODate));
+        break;
+    case WhenChangedKey:
+        this->setLastModified(QDateTime::fromString(value.toString(), Qt::ISODate));
+        break;
+    case GenerationKey:
+        this->setGeneration(value.toInt());
+        break;
+    case GenerationCreatedKey:
+        this->setGenerationCreated(value.toInt());
+        break;
+    case HashKey:
+        this->setHash(value.toByteArray());
+        break;
+    case SizeKey:
+        this->setSize(value.toLongLong());
+        break;
+    case IsPublicKey:
+        this->setPublic(value.toBool());
+        break;
+    case PublicUrlKey:
+        this->setPublicUrl(value.toUrl());
+        break;
+    case HasChildrenKey:
+        this->setHasChildren(value.toBool());
+        break;
+    case IsRootKey:
+        this->setIsRoot(value.toBool());
+        break;
+    default:
+        break;
     }
+}
+
+void NodePrivate::endLoad() {
+    Q_Q(Node);
 
-    this->setPath(node.value("path").toString());
-    this->setResourcePath(node.value("resource_path").toString());
-    this->setContentPath(node.value("content_path").toString());
-    this->setParentPath(node.value("parent_path").toString());
-    this->setVolumePath(node.value("volume_path").toString());
-    this->setNodePath(node.value("node_path").toString());
     this->setName(this->path().mid(this->path().lastIndexOf('/') + 1));
     this->setSuffix(this->name().contains('.') ? this->name().mid(this->name().lastIndexOf('.') + 1) : QString());
-    this->setKey(node.value("key").toString());
-    this->setWhenCreated(QDateTime::fromString(node.value("when_created").toString(), Qt::ISODate));
-    this->setLastModified(QDateTime::fromString(node.value("when_changed").toString(), Qt::ISODate));
-    this->setGeneration(node.value("generation").toInt());
-    this->setGenerationCreated(node.value("generation_created").toInt());
-    this->setHash(node.value("hash").toByteArray());
-    this->setSize(node.value("size").toLongLong());
-    this->setPublic(node.value("is_public").toBool());
-    this->setPublicUrl(node.value("public_url").toUrl());
-    this->setHasChildren(node.value("has_children").toBool());
-    this->setIsRoot(node.value("is_root").toBool());
-    this->setError(Node::NoError);
-    this->setErrorString(QString());
+
+    if (!m_cacheKey.isEmpty()) {
+        NodeCache::instance()->insert(m_cacheKey, q);
+    }
 
     emit q->ready(q);
 }
@@ -447,11 +612,12 @@ void NodePrivate::_q_onReplyFinished() {
             return;
         }
 
-        QString response(m_reply->readAll());
-        QVariantMap result = QtJson::Json::parse(response).toMap();
+        NodeReader reader(this);
+        QtJson::JsonStreamParser parser(&reader);
 
-        if (!result.isEmpty()) {
-            this->loadNode(result);
+        // endLoad() emits ready(), so it is only called once the whole response is valid
+        if ((parser.feed(m_reply->readAll())) && (parser.finish()) && (reader.isFound())) {
+            this->endLoad();
         }
         else {
             this->setError(Node::ParserError);
@@ -464,4 +630,10 @@ void NodePrivate::_q_onReplyFinished() {
     }
 }
 
+void NodePrivate::_q_emitReady() {
+    Q_Q(Node);
+
+    emit q->ready(q);
+}
+
 }
@@ -34,6 +34,15 @@ public:
     void loadNode(Node *otherNode);
     void loadNode(const QVariantMap &node);
 
+    void copyNode(Node *otherNode);
+    void loadCachedNode(Node *cachedNode);
+
+    void setCacheKey(const QString &key);
+
+    void beginLoad();
+    void loadProperty(const QString &key, const QVariant &value);
+    void endLoad();
+
     Node::NodeType nodeType() const;
 
     QString path() const;
@@ -144,6 +153,7 @@ private:
     void setChildNodes(const QList<Node*> &nodes);
 
     void _q_onReplyFinished();
+    void _q_emitReady();
 
     Node *q_ptr;
 
@@ -196,6 +206,8 @@ private:
 
     QList<Node*> m_childNodes;
 
+    QString m_cacheKey;
+
     Q_DECLARE_PUBLIC(Node)
 };
 
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "nodecache.h"
+#include "node.h"
+#include "node_p.h"
+#include "session.h"
+#include <QNetworkReply>
+
+namespace QtUbuntuOne {
+
+Q_GLOBAL_STATIC(NodeCache, nodeCacheInstance)
+
+NodeCache::NodeCache() :
+    m_timeToLive(0)
+{
+    m_clock.start();
+}
+
+NodeCache::~NodeCache() {
+    this->clear();
+}
+
+NodeCache* NodeCache::instance() {
+    return nodeCacheInstance();
+}
+
+int NodeCache::timeToLive() const {
+    QMutexLocker locker(&m_mutex);
+
+    return m_timeToLive;
+}
+
+void NodeCache::setTimeToLive(int msecs) {
+    QMutexLocker locker(&m_mutex);
+
+    m_timeToLive = msecs;
+
+    if (m_timeToLive <= 0) {
+        locker.unlock();
+        this->clear();
+    }
+}
+
+QString NodeCache::key(Session *session, const QString &resourcePath) {
+    return session->tokenKey() + '\n' + resourcePath;
+}
+
+/**
+ * Returns a new Node loaded from the cached metadata, or 0 if there is
+ * no fresh entry. The node emits ready() once control returns to the
+ * event loop.
+ */
+Node* NodeCache::node(const QString &key) {
+    QMutexLocker locker(&m_mutex);
+
+    if (m_timeToLive <= 0) {
+        return 0;
+    }
+
+    QHash<QString, Entry>::iterator iterator = m_entries.find(key);
+
+    if (iterator == m_entries.end()) {
+        return 0;
+    }
+
+    if (iterator.value().expires <= m_clock.elapsed()) {
+        delete iterator.value().node;
+        m_entries.erase(iterator);
+        return 0;
+    }
+
+    Node *node = new Node;
+    node->d_func()->loadCachedNode(iterator.value().node);
+
+    return node;
+}
+
+void NodeCache::insert(const QString &key, Node *node) {
+    QMutexLocker locker(&m_mutex);
+
+    if (m_timeToLive <= 0) {
+        return;
+    }
+
+    const qint64 now = m_clock.elapsed();
+    QHash<QString, Entry>::iterator iterator = m_entries.find(key);
+
+    if (iterator != m_entries.end()) {
+        // A response to an earlier request may arrive after a later one
+        if ((iterator.value().expires > now) && (iterator.value().node->generation() > node->generation())) {
+            return;
+        }
+
+        delete iterator.value().node;
+        m_entries.erase(iterator);
+    }
+
+    Entry entry;
+    entry.node = new Node;
+    entry.node->d_func()->copyNode(node);
+    entry.expires = now + m_timeToLive;
+    m_entries.insert(key, entry);
+}
+
+/**
+ * Removes the entry for the key, and the entries for any nodes below it.
+ */
+void NodeCache::remove(const QString &key) {
+    QMutexLocker locker(&m_mutex);
+
+    const QString prefix = key.endsWith('/') ? key : key + '/';
+    QHash<QString, Entry>::iterator iterator = m_entries.begin();
+
+    while (iterator != m_entries.end()) {
+        if ((iterator.key() == key) || (iterator.key().startsWith(prefix))) {
+            delete iterator.value().node;
+            iterator = m_entries.erase(iterator);
+        }
+        else {
+            ++iterator;
+        }
+    }
+}
+
+/**
+ * Removes the entries for the keys now, and again when the reply has finished.
+ */
+void NodeCache::remove(const QStringList &keys, QNetworkReply *reply) {
+    foreach (const QString &key, keys) {
+        this->remove(key);
+    }
+
+    if (reply) {
+        new NodeCacheInvalidator(keys, reply);
+    }
+}
+
+/**
+ * Removes the entry for the node's resource path when the node is ready.
+ */
+void NodeCache::removeWhenReady(Session *session, Node *node) {
+    new NodeCacheInvalidator(session, node);
+}
+
+void NodeCache::clear() {
+    QMutexLocker locker(&m_mutex);
+
+    foreach (const Entry &entry, m_entries) {
+        delete entry.node;
+    }
+
+    m_entries.clear();
+}
+
+NodeCacheInvalidator::NodeCacheInvalidator(const QStringList &keys, QNetworkReply *reply) :
+    QObject(reply),
+    m_keys(keys)
+{
+    this->connect(reply, SIGNAL(finished()), this, SLOT(invalidate()));
+}
+
+NodeCacheInvalidator::NodeCacheInvalidator(Session *session, Node *node) :
+    QObject(node),
+    m_sessionKey(NodeCache::key(session, QString()))
+{
+    this->connect(node, SIGNAL(ready(Node*)), this, SLOT(invalidateNode(Node*)));
+}
+
+void NodeCacheInvalidator::invalidate() {
+    foreach (const QString &key, m_keys) {
+        NodeCache::instance()->remove(key);
+    }
+}
+
+void NodeCacheInvalidator::invalidateNode(Node *node) {
+    // A failed request has no resource path, and the key would match every entry
+    if (!node->resourcePath().isEmpty()) {
+        NodeCache::instance()->remove(m_sessionKey + node->resourcePath());
+    }
+}
+
+}
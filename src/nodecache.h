@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef NODECACHE_H
+#define NODECACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include <QElapsedTimer>
+
+class QNetworkReply;
+
+namespace QtUbuntuOne {
+
+class Node;
+class Session;
+
+/**
+ * Keeps the metadata of recently requested nodes, so that Files::getNode()
+ * can be answered without a request while it is fresh.
+ *
+ * Entries are keyed by session and resource path, expire after
+ * timeToLive() msecs, and are never replaced by an older generation of
+ * the same node. Changes made through the library remove the affected
+ * entries.
+ */
+class NodeCache
+{
+
+public:
+    NodeCache();
+    ~NodeCache();
+
+    static NodeCache* instance();
+
+    // A time to live of 0 or less disables the cache
+    int timeToLive() const;
+    void setTimeToLive(int msecs);
+
+    static QString key(Session *session, const QString &resourcePath);
+
+    Node* node(const QString &key);
+
+    void insert(const QString &key, Node *node);
+    void remove(const QString &key);
+    void remove(const QStringList &keys, QNetworkReply *reply);
+    void removeWhenReady(Session *session, Node *node);
+    void clear();
+
+private:
+    struct Entry {
+        Node *node;
+        qint64 expires;
+    };
+
+    mutable QMutex m_mutex;
+
+    int m_timeToLive;
+
+    QHash<QString, Entry> m_entries;
+
+    QElapsedTimer m_clock;
+};
+
+/**
+ * Removes cache entries when a reply has finished, or the entry for a node
+ * when it is ready, so that metadata fetched while a change was in progress
+ * is not kept.
+ */
+class NodeCacheInvalidator : public QObject
+{
+    Q_OBJECT
+
+public:
+    NodeCacheInvalidator(const QStringList &keys, QNetworkReply *reply);
+    NodeCacheInvalidator(Session *session, Node *node);
+
+private slots:
+    void invalidate();
+    void invalidateNode(Node *node);
+
+private:
+    QStringList m_keys;
+    QString m_sessionKey;
+};
+
+}
+
+#endif // NODECACHE_H
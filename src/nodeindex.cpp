@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * \file nodeindex.cpp
+ */
+
+#include "nodeindex.h"
+#include "nodeindex_p.h"
+
+namespace QtUbuntuOne {
+
+NodeIndex::NodeIndex(QObject *parent) :
+    QObject(parent),
+    d_ptr(new NodeIndexPrivate(this))
+{
+}
+
+NodeIndex::NodeIndex(const QString &fileName, QObject *parent) :
+    QObject(parent),
+    d_ptr(new NodeIndexPrivate(fileName, this))
+{
+}
+
+NodeIndex::NodeIndex(NodeIndexPrivate &d, QObject *parent) :
+    QObject(parent),
+    d_ptr(&d)
+{
+}
+
+NodeIndex::~NodeIndex() {}
+
+/**
+ * fileName
+ */
+QString NodeIndex::fileName() const {
+    Q_D(const NodeIndex);
+
+    return d->fileName();
+}
+
+/**
+ * setFileName
+ */
+void NodeIndex::setFileName(const QString &fileName) {
+    Q_D(NodeIndex);
+
+    d->setFileName(fileName);
+}
+
+/**
+ * volumePath
+ */
+QString NodeIndex::volumePath() const {
+    Q_D(const NodeIndex);
+
+    return d->volumePath();
+}
+
+/**
+ * setVolumePath
+ */
+void NodeIndex::setVolumePath(const QString &path) {
+    Q_D(NodeIndex);
+
+    d->setVolumePath(path);
+}
+
+/**
+ * tokenKey
+ */
+QString NodeIndex::tokenKey() const {
+    Q_D(const NodeIndex);
+
+    return d->tokenKey();
+}
+
+/**
+ * setTokenKey
+ */
+void NodeIndex::setTokenKey(const QString &key) {
+    Q_D(NodeIndex);
+
+    d->setTokenKey(key);
+}
+
+/**
+ * generation
+ */
+int NodeIndex::generation() const {
+    Q_D(const NodeIndex);
+
+    return d->generation();
+}
+
+/**
+ * setGeneration
+ */
+void NodeIndex::setGeneration(int generation) {
+    Q_D(NodeIndex);
+
+    d->setGeneration(generation);
+}
+
+/**
+ * count
+ */
+int NodeIndex::count() const {
+    Q_D(const NodeIndex);
+
+    return d->count();
+}
+
+/**
+ * resourcePaths
+ */
+QStringList NodeIndex::resourcePaths() const {
+    Q_D(const NodeIndex);
+
+    return d->resourcePaths();
+}
+
+/**
+ * contains
+ */
+bool NodeIndex::contains(const QString &resourcePath) const {
+    Q_D(const NodeIndex);
+
+    return d->contains(resourcePath);
+}
+
+/**
+ * nodeType
+ */
+Node::NodeType NodeIndex::nodeType(const QString &resourcePath) const {
+    Q_D(const NodeIndex);
+
+    return d->nodeType(resourcePath);
+}
+
+/**
+ * hash
+ */
+QByteArray NodeIndex::hash(const QString &resourcePath) const {
+    Q_D(const NodeIndex);
+
+    return d->hash(resourcePath);
+}
+
+/**
+ * size
+ */
+qint64 NodeIndex::size(const QString &resourcePath) const {
+    Q_D(const NodeIndex);
+
+    return d->size(resourcePath);
+}
+
+/**
+ * generation
+ */
+int NodeIndex::generation(const QString &resourcePath) const {
+    Q_D(const NodeIndex);
+
+    return d->generation(resourcePath);
+}
+
+/**
+ * lastModified
+ */
+QDateTime NodeIndex::lastModified(const QString &resourcePath) const {
+    Q_D(const NodeIndex);
+
+    return d->lastModified(resourcePath);
+}
+
+/**
+ * node
+ */
+Node* NodeIndex::node(const QString &resourcePath) const {
+    Q_D(const NodeIndex);
+
+    return d->node(resourcePath);
+}
+
+/**
+ * insert
+ */
+void NodeIndex::insert(Node *node) {
+    Q_D(NodeIndex);
+
+    d->insert(node);
+}
+
+/**
+ * remove
+ */
+void NodeIndex::remove(const QString &resourcePath) {
+    Q_D(NodeIndex);
+
+    d->remove(resourcePath);
+}
+
+/**
+ * load
+ */
+bool NodeIndex::load() {
+    Q_D(NodeIndex);
+
+    return d->load();
+}
+
+/**
+ * save
+ */
+bool NodeIndex::save() {
+    Q_D(NodeIndex);
+
+    return d->save();
+}
+
+/**
+ * clear
+ */
+void NodeIndex::clear() {
+    Q_D(NodeIndex);
+
+    d->clear();
+}
+
+#include "moc_nodeindex.cpp"
+
+}
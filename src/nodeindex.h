@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * \file nodeindex.h
+ */
+
+#ifndef NODEINDEX_H
+#define NODEINDEX_H
+
+#include "qubuntuone_global.h"
+#include "node.h"
+#include <QStringList>
+
+namespace QtUbuntuOne {
+
+class NodeIndexPrivate;
+
+/**
+ * \class NodeIndex
+ * \brief Stores node metadata on disk.
+ *
+ * NodeIndex keeps the type, paths, hash, size, generation and modified time
+ * of each indexed node, keyed by resource path. Changes are appended to the
+ * index file as they are made, and the whole index is read back by load(),
+ * so that node metadata is available at startup without listing the volume.
+ *
+ * The volume path and token key that the nodes were indexed for are stored
+ * in the index file, so that an index is not used for another volume or account.
+ *
+ * A NodeIndex without a file name is kept in memory only.
+ *
+ * \sa SyncEngine::setNodeIndex()
+ */
+class QUBUNTUONESHARED_EXPORT NodeIndex : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QString fileName
+               READ fileName
+               WRITE setFileName)
+    Q_PROPERTY(QString volumePath
+               READ volumePath
+               WRITE setVolumePath)
+    Q_PROPERTY(QString tokenKey
+               READ tokenKey
+               WRITE setTokenKey)
+    Q_PROPERTY(int generation
+               READ generation
+               WRITE setGeneration)
+    Q_PROPERTY(int count
+               READ count)
+
+public:
+    explicit NodeIndex(QObject *parent = 0);
+    explicit NodeIndex(const QString &fileName, QObject *parent = 0);
+    ~NodeIndex();
+
+    /**
+     * Returns the name of the index file.
+     *
+     * \return QString
+     */
+    QString fileName() const;
+
+    /**
+     * Sets the name of the index file. The file is not read until load() is called.
+     *
+     * \param QString
+     */
+    void setFileName(const QString &fileName);
+
+    /**
+     * Returns the resource path of the volume that the nodes are indexed for.
+     *
+     * \return QString
+     */
+    QString volumePath() const;
+
+    /**
+     * Sets the resource path of the volume that the nodes are indexed for.
+     * If a different volume path was set or loaded, the indexed nodes are
+     * discarded. The index file is not removed, but is replaced once the
+     * index is next written.
+     *
+     * \param QString
+     */
+    void setVolumePath(const QString &path);
+
+    /**
+     * Returns the token key of the account that the nodes are indexed for.
+     *
+     * \return QString
+     */
+    QString tokenKey() const;
+
+    /**
+     * Sets the token key of the account that the nodes are indexed for.
+     * If a different token key was set or loaded, the indexed nodes are
+     * discarded. The index file is not removed, but is replaced once the
+     * index is next written.
+     *
+     * \param QString
+     */
+    void setTokenKey(const QString &key);
+
+    /**
+     * Returns the volume generation that the index is up to date with,
+     * or 0 if the generation is unknown.
+     *
+     * \return int
+     */
+    int generation() const;
+
+    /**
+     * Sets the volume generation that the index is up to date with.
+     * Pending changes are written to the index file, and the file is
+     * rewritten if it contains many superseded changes.
+     *
+     * \param int
+     */
+    void setGeneration(int generation);
+
+    /**
+     * Returns the number of indexed nodes.
+     *
+     * \return int
+     */
+    int count() const;
+
+    /**
+     * Returns the resource paths of the indexed nodes.
+     *
+     * \return QStringList
+     */
+    Q_INVOKABLE QStringList resourcePaths() const;
+
+    /**
+     * Returns true if the node with the specified resource path is indexed.
+     *
+     * \param resourcePath
+     *
+     * \return bool
+     */
+    Q_INVOKABLE bool contains(const QString &resourcePath) const;
+
+    /**
+     * Returns the node type of the specified node.
+     *
+     * \param resourcePath
+     *
+     * \return Node::NodeType
+     */
+    Q_INVOKABLE Node::NodeType nodeType(const QString &resourcePath) const;
+
+    /**
+     * Returns the hash of the specified node.
+     *
+     * \param resourcePath
+     *
+     * \return QByteArray
+     */
+    Q_INVOKABLE QByteArray hash(const QString &resourcePath) const;
+
+    /**
+     * Returns the size of the specified node.
+     *
+     * \param resourcePath
+     *
+     * \return qint64
+     */
+    Q_INVOKABLE qint64 size(const QString &resourcePath) const;
+
+    /**
+     * Returns the generation of the specified node, or -1 if the node is not indexed.
+     *
+     * \param resourcePath
+     *
+     * \return int
+     */
+    Q_INVOKABLE int generation(const QString &resourcePath) const;
+
+    /**
+     * Returns the last modified date of the specified node.
+     *
+     * \param resourcePath
+     *
+     * \return QDateTime
+     */
+    Q_INVOKABLE QDateTime lastModified(const QString &resourcePath) const;
+
+    /**
+     * Returns a new Node instance containing the indexed metadata of the specified node,
+     * or 0 if the node is not indexed. No request is made, and the caller takes ownership.
+     *
+     * \param resourcePath
+     *
+     * \return Node*
+     */
+    Q_INVOKABLE Node* node(const QString &resourcePath) const;
+
+    /**
+     * Adds the metadata of the specified node to the index,
+     * replacing any existing entry with the same resource path.
+     *
+     * \param node
+     */
+    Q_INVOKABLE void insert(Node *node);
+
+    /**
+     * Removes the specified node from the index.
+     *
+     * \param resourcePath
+     */
+    Q_INVOKABLE void remove(const QString &resourcePath);
+
+    /**
+     * Reads the index file, replacing the contents of the index.
+     * A partially written change at the end of the file is discarded.
+     * If the file is not an index file, it is left unchanged and is not
+     * written to until save() is called.
+     *
+     * If the volume path or token key is set and the file was written for
+     * a different one, the contents of the file are not read, and the file is
+     * replaced once the index is next written. Otherwise, a volume path or
+     * token key that is not set is read from the file.
+     *
+     * \return bool Whether the index file could be read.
+     */
+    Q_INVOKABLE bool load();
+
+    /**
+     * Rewrites the index file so that it contains only the current entries.
+     * This is done automatically by load() and setGeneration() when the
+     * file contains many superseded changes.
+     *
+     * \return bool Whether the index file could be written.
+     */
+    Q_INVOKABLE bool save();
+
+public slots:
+    /**
+     * Removes all nodes from the index and deletes the index file.
+     */
+    void clear();
+
+private:
+    explicit NodeIndex(NodeIndexPrivate &d, QObject *parent = 0);
+
+    QScopedPointer<NodeIndexPrivate> d_ptr;
+
+    Q_DECLARE_PRIVATE(NodeIndex)
+};
+
+}
+
+#endif // NODEINDEX_H
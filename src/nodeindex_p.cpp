@@ -0,0 +1,507 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "nodeindex_p.h"
+#include "node_p.h"
+
+namespace QtUbuntuOne {
+
+static const quint32 INDEX_MAGIC = 0x55314e49; // "U1NI"
+static const quint16 INDEX_VERSION = 2;
+
+// Version 1 files have no volume path or token key in the header
+static const quint16 INDEX_VERSION_NO_IDENTITY = 1;
+
+// The index file is rewritten once it holds this many superseded records
+static const int COMPACT_THRESHOLD = 1024;
+
+NodeIndexPrivate::NodeIndexPrivate(NodeIndex *parent) :
+    q_ptr(parent),
+    m_generation(0),
+    m_records(0),
+    m_rejected(false),
+    m_stale(false)
+{
+}
+
+NodeIndexPrivate::NodeIndexPrivate(const QString &fileName, NodeIndex *parent) :
+    q_ptr(parent),
+    m_fileName(fileName),
+    m_generation(0),
+    m_records(0),
+    m_rejected(false),
+    m_stale(false)
+{
+}
+
+NodeIndexPrivate::~NodeIndexPrivate() {
+    this->closeLog();
+}
+
+QString NodeIndexPrivate::fileName() const {
+    return m_fileName;
+}
+
+void NodeIndexPrivate::setFileName(const QString &fileName) {
+    if (fileName != this->fileName()) {
+        this->closeLog();
+        m_fileName = fileName;
+        m_records = 0;
+        m_rejected = false;
+        m_stale = false;
+    }
+}
+
+QString NodeIndexPrivate::volumePath() const {
+    return m_volumePath;
+}
+
+void NodeIndexPrivate::setVolumePath(const QString &path) {
+    this->setIdentity(path, this->tokenKey());
+}
+
+QString NodeIndexPrivate::tokenKey() const {
+    return m_tokenKey;
+}
+
+void NodeIndexPrivate::setTokenKey(const QString &key) {
+    this->setIdentity(this->volumePath(), key);
+}
+
+int NodeIndexPrivate::generation() const {
+    return m_generation;
+}
+
+void NodeIndexPrivate::setGeneration(int generation) {
+    if (generation != this->generation()) {
+        m_generation = generation;
+
+        if (this->openLog()) {
+            m_stream << quint8(GenerationRecord) << qint32(generation);
+            m_records++;
+        }
+    }
+
+    // The generation is recorded once a set of changes is complete, so pending changes are written out
+    if (m_records > m_entries.size() + COMPACT_THRESHOLD) {
+        this->save();
+    }
+    else if (m_file.isOpen()) {
+        m_file.flush();
+    }
+}
+
+int NodeIndexPrivate::count() const {
+    return m_entries.size();
+}
+
+QStringList NodeIndexPrivate::resourcePaths() const {
+    return m_entries.keys();
+}
+
+bool NodeIndexPrivate::contains(const QString &resourcePath) const {
+    return m_entries.contains(resourcePath);
+}
+
+Node::NodeType NodeIndexPrivate::nodeType(const QString &resourcePath) const {
+    QHash<QString, Entry>::const_iterator entry = m_entries.constFind(resourcePath);
+
+    return entry != m_entries.constEnd() ? entry.value().nodeType : Node::File;
+}
+
+QByteArray NodeIndexPrivate::hash(const QString &resourcePath) const {
+    QHash<QString, Entry>::const_iterator entry = m_entries.constFind(resourcePath);
+
+    return entry != m_entries.constEnd() ? entry.value().hash : QByteArray();
+}
+
+qint64 NodeIndexPrivate::size(const QString &resourcePath) const {
+    QHash<QString, Entry>::const_iterator entry = m_entries.constFind(resourcePath);
+
+    return entry != m_entries.constEnd() ? entry.value().size : 0;
+}
+
+int NodeIndexPrivate::generation(const QString &resourcePath) const {
+    QHash<QString, Entry>::const_iterator entry = m_entries.constFind(resourcePath);
+
+    return entry != m_entries.constEnd() ? entry.value().generation : -1;
+}
+
+QDateTime NodeIndexPrivate::lastModified(const QString &resourcePath) const {
+    QHash<QString, Entry>::const_iterator entry = m_entries.constFind(resourcePath);
+
+    return entry != m_entries.constEnd() ? entry.value().lastModified : QDateTime();
+}
+
+Node* NodeIndexPrivate::node(const QString &resourcePath) const {
+    QHash<QString, Entry>::const_iterator entry = m_entries.constFind(resourcePath);
+
+    if (entry == m_entries.constEnd()) {
+        return 0;
+    }
+
+    QVariantMap map;
+    map.insert("kind", QString(entry.value().nodeType == Node::Directory ? "directory" : "file"));
+    map.insert("resource_path", resourcePath);
+    map.insert("path", entry.value().path);
+    map.insert("content_path", entry.value().contentPath);
+    map.insert("parent_path", entry.value().parentPath);
+    map.insert("hash", entry.value().hash);
+    map.insert("size", entry.value().size);
+    map.insert("generation", entry.value().generation);
+    map.insert("when_changed", entry.value().lastModified.toString(Qt::ISODate));
+
+    Node *node = new Node;
+    node->d_func()->loadNode(map);
+
+    return node;
+}
+
+void NodeIndexPrivate::insert(Node *node) {
+    if (!node) {
+        return;
+    }
+
+    Entry entry;
+    entry.nodeType = node->nodeType();
+    entry.path = node->path();
+    entry.contentPath = node->contentPath();
+    entry.parentPath = node->parentPath();
+    entry.hash = node->hash();
+    entry.size = node->size();
+    entry.generation = node->generation();
+    entry.lastModified = node->lastModified();
+
+    const QString resourcePath = node->resourcePath();
+    QHash<QString, Entry>::iterator existing = m_entries.find(resourcePath);
+
+    if (existing != m_entries.end()) {
+        // Skip unchanged nodes to keep the index file from growing
+        if ((existing.value().generation == entry.generation)
+            && (existing.value().nodeType == entry.nodeType)
+            && (existing.value().hash == entry.hash)) {
+            return;
+        }
+
+        existing.value() = entry;
+    }
+    else {
+        m_entries.insert(resourcePath, entry);
+    }
+
+    if (this->openLog()) {
+        m_stream << quint8(InsertRecord);
+        writeEntry(m_stream, resourcePath, entry);
+        m_records++;
+    }
+}
+
+void NodeIndexPrivate::remove(const QString &resourcePath) {
+    if (m_entries.remove(resourcePath) > 0) {
+        if (this->openLog()) {
+            m_stream << quint8(RemoveRecord) << resourcePath;
+            m_records++;
+        }
+    }
+}
+
+bool NodeIndexPrivate::load() {
+    this->closeLog();
+    m_entries.clear();
+    m_generation = 0;
+    m_records = 0;
+    m_rejected = false;
+    m_stale = false;
+
+    if (this->fileName().isEmpty()) {
+        return false;
+    }
+
+    QFile file(this->fileName());
+
+    if (!file.exists()) {
+        // save() removes the old file before renaming the new one, so a complete copy may be left here
+        const QString tempFileName = this->fileName() + ".tmp";
+
+        if ((!QFile::exists(tempFileName)) || (!QFile::rename(tempFileName, this->fileName()))) {
+            return true;
+        }
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_7);
+
+    quint32 magic;
+    quint16 version;
+    stream >> magic >> version;
+
+    if ((stream.status() != QDataStream::Ok) || (magic != INDEX_MAGIC)
+        || ((version != INDEX_VERSION) && (version != INDEX_VERSION_NO_IDENTITY))) {
+        // Leave files that are not index files untouched, unless save() is called
+        m_rejected = true;
+        return false;
+    }
+
+    QString volumePath;
+    QString tokenKey;
+
+    if (version == INDEX_VERSION) {
+        stream >> volumePath >> tokenKey;
+
+        if (stream.status() != QDataStream::Ok) {
+            m_rejected = true;
+            return false;
+        }
+    }
+
+    if (((!this->volumePath().isEmpty()) && (volumePath != this->volumePath()))
+        || ((!this->tokenKey().isEmpty()) && (tokenKey != this->tokenKey()))) {
+        // The file indexes another volume or account, and is replaced once the index is written
+        m_stale = true;
+        return true;
+    }
+
+    if (this->volumePath().isEmpty()) {
+        m_volumePath = volumePath;
+    }
+
+    if (this->tokenKey().isEmpty()) {
+        m_tokenKey = tokenKey;
+    }
+
+    // Rewrite the header once the index is written if it lacks the volume path or token key
+    m_stale = (volumePath != this->volumePath()) || (tokenKey != this->tokenKey());
+
+    qint64 end = file.pos();
+
+    while (!stream.atEnd()) {
+        quint8 record;
+        stream >> record;
+
+        if (record == InsertRecord) {
+            QString resourcePath;
+            Entry entry;
+            stream >> resourcePath;
+
+            if (!readEntry(stream, entry)) {
+                break;
+            }
+
+            m_entries.insert(resourcePath, entry);
+        }
+        else if (record == RemoveRecord) {
+            QString resourcePath;
+            stream >> resourcePath;
+
+            if (stream.status() != QDataStream::Ok) {
+                break;
+            }
+
+            m_entries.remove(resourcePath);
+        }
+        else if (record == GenerationRecord) {
+            qint32 generation;
+            stream >> generation;
+
+            if (stream.status() != QDataStream::Ok) {
+                break;
+            }
+
+            m_generation = generation;
+        }
+        else {
+            break;
+        }
+
+        m_records++;
+        end = file.pos();
+    }
+
+    const bool truncated = end < file.size();
+    file.close();
+
+    if (m_records > m_entries.size() + COMPACT_THRESHOLD) {
+        return this->save();
+    }
+
+    if (truncated) {
+        // Drop the partially written record left by an interrupted write
+        return QFile::resize(this->fileName(), end);
+    }
+
+    return true;
+}
+
+bool NodeIndexPrivate::save() {
+    this->closeLog();
+
+    if (this->fileName().isEmpty()) {
+        return false;
+    }
+
+    const QString tempFileName = this->fileName() + ".tmp";
+    QFile file(tempFileName);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_7);
+    writeHeader(stream);
+    stream << quint8(GenerationRecord) << qint32(this->generation());
+
+    for (QHash<QString, Entry>::const_iterator iterator = m_entries.constBegin(); iterator != m_entries.constEnd(); ++iterator) {
+        stream << quint8(InsertRecord);
+        writeEntry(stream, iterator.key(), iterator.value());
+    }
+
+    file.close();
+
+    if (file.error() != QFile::NoError) {
+        file.remove();
+        return false;
+    }
+
+    QFile::remove(this->fileName());
+
+    if (!QFile::rename(tempFileName, this->fileName())) {
+        return false;
+    }
+
+    m_records = m_entries.size() + 1;
+    m_rejected = false;
+    m_stale = false;
+
+    return true;
+}
+
+void NodeIndexPrivate::clear() {
+    this->closeLog();
+    m_entries.clear();
+    m_generation = 0;
+    m_records = 0;
+    m_rejected = false;
+    m_stale = false;
+
+    if (!this->fileName().isEmpty()) {
+        QFile::remove(this->fileName());
+    }
+}
+
+void NodeIndexPrivate::setIdentity(const QString &volumePath, const QString &tokenKey) {
+    if ((volumePath == this->volumePath()) && (tokenKey == this->tokenKey())) {
+        return;
+    }
+
+    // Nodes indexed for another volume or account are discarded. The index file is
+    // left in place, and is replaced once the index is written.
+    if (((!this->volumePath().isEmpty()) && (volumePath != this->volumePath()))
+        || ((!this->tokenKey().isEmpty()) && (tokenKey != this->tokenKey()))) {
+        this->closeLog();
+        m_entries.clear();
+        m_generation = 0;
+        m_stale = true;
+    }
+    else if (m_records > 0) {
+        // The header of the index file is rewritten to record the new values
+        this->closeLog();
+        m_stale = true;
+    }
+
+    m_volumePath = volumePath;
+    m_tokenKey = tokenKey;
+}
+
+void NodeIndexPrivate::writeHeader(QDataStream &stream) const {
+    stream << INDEX_MAGIC << INDEX_VERSION << this->volumePath() << this->tokenKey();
+}
+
+void NodeIndexPrivate::writeEntry(QDataStream &stream, const QString &resourcePath, const Entry &entry) {
+    stream << resourcePath
+           << quint8(entry.nodeType)
+           << entry.path
+           << entry.contentPath
+           << entry.parentPath
+           << entry.hash
+           << qint64(entry.size)
+           << qint32(entry.generation)
+           << entry.lastModified;
+}
+
+bool NodeIndexPrivate::readEntry(QDataStream &stream, Entry &entry) {
+    quint8 nodeType;
+    qint64 size;
+    qint32 generation;
+
+    stream >> nodeType
+           >> entry.path
+           >> entry.contentPath
+           >> entry.parentPath
+           >> entry.hash
+           >> size
+           >> generation
+           >> entry.lastModified;
+
+    entry.nodeType = Node::NodeType(nodeType);
+    entry.size = size;
+    entry.generation = generation;
+
+    return stream.status() == QDataStream::Ok;
+}
+
+bool NodeIndexPrivate::openLog() {
+    if (m_file.isOpen()) {
+        return true;
+    }
+
+    if ((this->fileName().isEmpty()) || (m_rejected)) {
+        return false;
+    }
+
+    if ((m_stale) && (!this->save())) {
+        return false;
+    }
+
+    m_file.setFileName(this->fileName());
+
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(QDataStream::Qt_4_7);
+
+    if (m_file.size() == 0) {
+        writeHeader(m_stream);
+    }
+
+    return true;
+}
+
+void NodeIndexPrivate::closeLog() {
+    if (m_file.isOpen()) {
+        m_stream.setDevice(0);
+        m_file.close();
+    }
+}
+
+}
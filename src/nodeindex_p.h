@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef NODEINDEX_P_H
+#define NODEINDEX_P_H
+
+#include "nodeindex.h"
+#include <QFile>
+#include <QDataStream>
+#include <QHash>
+
+namespace QtUbuntuOne {
+
+class NodeIndexPrivate
+{
+
+public:
+    NodeIndexPrivate(NodeIndex *parent);
+    NodeIndexPrivate(const QString &fileName, NodeIndex *parent);
+    virtual ~NodeIndexPrivate();
+
+    QString fileName() const;
+    void setFileName(const QString &fileName);
+
+    QString volumePath() const;
+    void setVolumePath(const QString &path);
+
+    QString tokenKey() const;
+    void setTokenKey(const QString &key);
+
+    int generation() const;
+    void setGeneration(int generation);
+
+    int count() const;
+
+    QStringList resourcePaths() const;
+
+    bool contains(const QString &resourcePath) const;
+
+    Node::NodeType nodeType(const QString &resourcePath) const;
+
+    QByteArray hash(const QString &resourcePath) const;
+
+    qint64 size(const QString &resourcePath) const;
+
+    int generation(const QString &resourcePath) const;
+
+    QDateTime lastModified(const QString &resourcePath) const;
+
+    Node* node(const QString &resourcePath) const;
+
+    void insert(Node *node);
+    void remove(const QString &resourcePath);
+
+    bool load();
+    bool save();
+
+    void clear();
+
+private:
+    enum Record {
+        InsertRecord = 1,
+        RemoveRecord,
+        GenerationRecord
+    };
+
+    struct Entry {
+        Node::NodeType nodeType;
+        QString path;
+        QString contentPath;
+        QString parentPath;
+        QByteArray hash;
+        qint64 size;
+        int generation;
+        QDateTime lastModified;
+    };
+
+    void setIdentity(const QString &volumePath, const QString &tokenKey);
+
+    void writeHeader(QDataStream &stream) const;
+    static void writeEntry(QDataStream &stream, const QString &resourcePath, const Entry &entry);
+    static bool readEntry(QDataStream &stream, Entry &entry);
+
+    bool openLog();
+    void closeLog();
+
+    NodeIndex *q_ptr;
+
+    QString m_fileName;
+
+    QString m_volumePath;
+    QString m_tokenKey;
+
+    int m_generation;
+
+    QHash<QString, Entry> m_entries;
+
+    // Records in the index file, including superseded ones
+    int m_records;
+
+    // Set when the file is not an index file, so that it is not appended to
+    bool m_rejected;
+
+    // Set when the header of the index file does not match the volume path and token key,
+    // so that the file is rewritten rather than appended to
+    bool m_stale;
+
+    QFile m_file;
+
+    QDataStream m_stream;
+
+    Q_DECLARE_PUBLIC(NodeIndex)
+};
+
+}
+
+#endif // NODEINDEX_P_H
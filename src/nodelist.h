@@ -79,6 +79,11 @@ public:
         ContentAccessDenied = QNetworkReply::ContentAccessDenied,
         ContentOperationNotPermittedError = QNetworkReply::ContentOperationNotPermittedError,
         ContentNotFoundError = QNetworkReply::ContentNotFoundError,
+#if QT_VERSION >= 0x050300
+        ContentGoneError = QNetworkReply::ContentGoneError,
+#else
+        ContentGoneError = 207,
+#endif
         AuthenticationRequiredError = QNetworkReply::AuthenticationRequiredError,
         ContentReSendError = QNetworkReply::ContentReSendError,
         ProtocolUnknownError = QNetworkReply::ProtocolUnknownError,
@@ -134,6 +139,17 @@ signals:
      */
     void ready(NodeList *list);
 
+    /**
+     * Emitted when new nodes have been parsed from the response, before the request is completed.
+     *
+     * The nodes from index \a first to index \a last (inclusive) are available via nodes().
+     *
+     * \param list The NodeList object.
+     * \param first The index of the first new item.
+     * \param last The index of the last new item.
+     */
+    void itemsAvailable(NodeList *list, int first, int last);
+
     /**
      * Emitted when the request is cancelled.
      *
@@ -149,6 +165,7 @@ private:
 
     Q_DECLARE_PRIVATE(NodeList)
 
+    Q_PRIVATE_SLOT(d_func(), void _q_onReplyReadyRead())
     Q_PRIVATE_SLOT(d_func(), void _q_onReplyFinished())
 };
 
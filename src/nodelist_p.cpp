@@ -17,18 +17,22 @@
 
 #include "nodelist_p.h"
 #include "node_p.h"
-#include "json.h"
 
 namespace QtUbuntuOne {
 
 NodeListPrivate::NodeListPrivate(QNetworkReply *reply, NodeList *parent) :
+    QtJson::JsonArrayReader(QStringList("children")),
     q_ptr(parent),
     m_reply(reply),
+    m_parser(this),
+    m_currentNode(0),
+    m_reported(0),
     m_error(NodeList::NoError)
 {
     Q_Q(NodeList);
 
     if (m_reply) {
+        q->connect(m_reply, SIGNAL(readyRead()), q, SLOT(_q_onReplyReadyRead()));
         q->connect(m_reply, SIGNAL(finished()), q, SLOT(_q_onReplyFinished()));
     }
 }
@@ -38,6 +42,11 @@ NodeListPrivate::~NodeListPrivate() {
         delete m_reply;
         m_reply = 0;
     }
+
+    if (m_currentNode) {
+        delete m_currentNode;
+        m_currentNode = 0;
+    }
 }
 
 int NodeListPrivate::count() const {
@@ -64,16 +73,35 @@ void NodeListPrivate::setErrorString(const QString &errorstring) {
     m_errorString = errorstring;
 }
 
-void NodeListPrivate::loadNodes(const QVariantList &nodes) {
+void NodeListPrivate::readItem(const QVariant &item) {
+    Node *n = new Node;
+    n->d_func()->loadNode(item.toMap());
+    m_nodes.append(n);
+}
+
+void NodeListPrivate::beginItem() {
+    m_currentNode = new Node;
+    m_currentNode->d_func()->beginLoad();
+}
+
+void NodeListPrivate::readItemValue(const QString &key, const QVariant &value) {
+    m_currentNode->d_func()->loadProperty(key, value);
+}
+
+void NodeListPrivate::endItem() {
+    m_currentNode->d_func()->endLoad();
+    m_nodes.append(m_currentNode);
+    m_currentNode = 0;
+}
+
+void NodeListPrivate::reportItems() {
     Q_Q(NodeList);
 
-    foreach (QVariant node, nodes) {
-        Node *n = new Node;
-        n->d_func()->loadNode(node.toMap());
-        m_nodes.append(n);
+    if (m_nodes.size() > m_reported) {
+        int first = m_reported;
+        m_reported = m_nodes.size();
+        emit q->itemsAvailable(q, first, m_reported - 1);
     }
-
-    emit q->ready(q);
 }
 
 void NodeListPrivate::cancel() {
@@ -82,6 +110,18 @@ void NodeListPrivate::cancel() {
     }
 }
 
+void NodeListPrivate::_q_onReplyReadyRead() {
+    if ((m_reply) && (!m_parser.hasError())) {
+        int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+        // Parse successful responses as they arrive
+        if ((status >= 200) && (status < 300)) {
+            m_parser.feed(m_reply->readAll());
+            this->reportItems();
+        }
+    }
+}
+
 void NodeListPrivate::_q_onReplyFinished() {
     Q_Q(NodeList);
 
@@ -93,29 +133,30 @@ void NodeListPrivate::_q_onReplyFinished() {
             emit q->cancelled(q);
             return;
         default:
-            this->setError(NodeList::Error(m_reply->error()));
+            // Before Qt 5.3, 410 Gone is reported as UnknownContentError
+            if (m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 410) {
+                this->setError(NodeList::ContentGoneError);
+            }
+            else {
+                this->setError(NodeList::Error(m_reply->error()));
+            }
+
             this->setErrorString(m_reply->errorString());
             emit q->ready(q);
             return;
         }
 
-        QString response(m_reply->readAll());
-        QVariant result = QtJson::Json::parse(response);
+        m_parser.feed(m_reply->readAll());
 
-        switch (result.type()) {
-        case QVariant::Map:
-            this->loadNodes(result.toMap().value("children").toList());
-            break;
-        case QVariant::List:
-            this->loadNodes(result.toList());
-            break;
-        default:
+        if ((!m_parser.finish()) || (!this->isValid())) {
             this->setError(NodeList::ParserError);
             this->setErrorString(QObject::tr("Cannot parse server response"));
-            emit q->ready(q);
-            break;
         }
 
+        this->reportItems();
+
+        emit q->ready(q);
+
         m_reply->deleteLater();
         m_reply = 0;
     }
@@ -19,10 +19,11 @@
 #define NODELIST_P_H
 
 #include "nodelist.h"
+#include "json.h"
 
 namespace QtUbuntuOne {
 
-class NodeListPrivate
+class NodeListPrivate : public QtJson::JsonArrayReader
 {
 
 public:
@@ -42,15 +43,24 @@ private:
     void setError(NodeList::Error error);
     void setErrorString(const QString &errorstring);
 
-    void loadNodes(const QVariantList &nodes);
+    void readItem(const QVariant &item);
+    void beginItem();
+    void readItemValue(const QString &key, const QVariant &value);
+    void endItem();
+    void reportItems();
 
+    void _q_onReplyReadyRead();
     void _q_onReplyFinished();
 
     NodeList *q_ptr;
 
     QNetworkReply *m_reply;
 
+    QtJson::JsonStreamParser m_parser;
+
     QList<Node*> m_nodes;
+    Node *m_currentNode;
+    int m_reported;
 
     NodeList::Error m_error;
     QString m_errorString;
@@ -18,104 +18,502 @@
 #include "oauth.h"
 #include <QDateTime>
 #include <QCryptographicHash>
+#include <QCoreApplication>
+#include <QThreadStorage>
+#include <QAtomicInt>
+#include <QStringList>
+#include <string.h>
 
 namespace QtOAuth {
 
-QString OAuth::getTimeStamp() {
-    return QString::number(QDateTime::currentMSecsSinceEpoch() / 1000);
+static const int SHA1_BLOCK_SIZE = 64;
+static const int SHA1_DIGEST_SIZE = 20;
+
+static inline quint32 rotateLeft(quint32 value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
 }
 
-QString OAuth::getNonce() {
-    qsrand(QDateTime::currentMSecsSinceEpoch());
+// Absorbs one 64 byte block into the five word SHA-1 state
+static void sha1Block(quint32 *state, const uchar *block) {
+    quint32 w[80];
+
+    for (int i = 0; i < 16; i++) {
+        w[i] = (quint32(block[i * 4]) << 24) | (quint32(block[i * 4 + 1]) << 16)
+               | (quint32(block[i * 4 + 2]) << 8) | quint32(block[i * 4 + 3]);
+    }
+
+    for (int i = 16; i < 80; i++) {
+        w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    quint32 a = state[0];
+    quint32 b = state[1];
+    quint32 c = state[2];
+    quint32 d = state[3];
+    quint32 e = state[4];
+
+    for (int i = 0; i < 80; i++) {
+        quint32 f;
+        quint32 k;
+
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5a827999;
+        }
+        else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ed9eba1;
+        }
+        else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8f1bbcdc;
+        }
+        else {
+            f = b ^ c ^ d;
+            k = 0xca62c1d6;
+        }
+
+        const quint32 temp = rotateLeft(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotateLeft(b, 30);
+        b = a;
+        a = temp;
+    }
 
-    return QString::number(qrand());
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
 }
 
-QByteArray OAuth::createSignature(QByteArray key, QByteArray baseString) {
-    int blockSize = 64; // HMAC-SHA-1 block size, defined in SHA-1 standard
-    if (key.length() > blockSize) { // if key is longer than block size (64), reduce key length with SHA-1 compression
-        key = QCryptographicHash::hash(key, QCryptographicHash::Sha1);
+// Hashes length bytes of data on top of a state that has already absorbed one key block,
+// writing the final digest to digest
+static void sha1Finish(const quint32 *keyState, const uchar *data, int length, uchar *digest) {
+    quint32 state[5];
+    memcpy(state, keyState, sizeof(state));
+
+    int offset = 0;
+
+    for (; offset + SHA1_BLOCK_SIZE <= length; offset += SHA1_BLOCK_SIZE) {
+        sha1Block(state, data + offset);
+    }
+
+    // Pad with 0x80, zeros and the message length in bits, including the key block
+    uchar tail[SHA1_BLOCK_SIZE * 2];
+    const int remaining = length - offset;
+    const int tailLength = (remaining < SHA1_BLOCK_SIZE - 8) ? SHA1_BLOCK_SIZE : SHA1_BLOCK_SIZE * 2;
+    const quint64 bits = quint64(SHA1_BLOCK_SIZE + length) * 8;
+
+    memset(tail, 0, tailLength);
+    memcpy(tail, data + offset, remaining);
+    tail[remaining] = 0x80;
+
+    for (int i = 0; i < 8; i++) {
+        tail[tailLength - 1 - i] = uchar(bits >> (i * 8));
+    }
+
+    for (int i = 0; i < tailLength; i += SHA1_BLOCK_SIZE) {
+        sha1Block(state, tail + i);
+    }
+
+    for (int i = 0; i < 5; i++) {
+        digest[i * 4] = uchar(state[i] >> 24);
+        digest[i * 4 + 1] = uchar(state[i] >> 16);
+        digest[i * 4 + 2] = uchar(state[i] >> 8);
+        digest[i * 4 + 3] = uchar(state[i]);
+    }
+}
+
+Signer::Signer() {
+    this->setKey(QByteArray());
+}
+
+Signer::Signer(const QByteArray &key) {
+    this->setKey(key);
+}
+
+QByteArray Signer::key() const {
+    return m_key;
+}
+
+void Signer::setKey(const QByteArray &key) {
+    m_key = key;
+
+    QByteArray blockKey(key);
+
+    if (blockKey.length() > SHA1_BLOCK_SIZE) { // if key is longer than block size (64), reduce key length with SHA-1 compression
+        blockKey = QCryptographicHash::hash(blockKey, QCryptographicHash::Sha1);
     }
 
-    QByteArray innerPadding(blockSize, char(0x36)); // initialize inner padding with char "6"
-    QByteArray outerPadding(blockSize, char(0x5c)); // initialize outer padding with char "\"
     // ascii characters 0x36 ("6") and 0x5c ("\") are selected because they have large
     // Hamming distance (http://en.wikipedia.org/wiki/Hamming_distance)
+    uchar innerPadding[SHA1_BLOCK_SIZE];
+    uchar outerPadding[SHA1_BLOCK_SIZE];
+    memset(innerPadding, 0x36, SHA1_BLOCK_SIZE);
+    memset(outerPadding, 0x5c, SHA1_BLOCK_SIZE);
 
-    for (int i = 0; i < key.length(); i++) {
-        innerPadding[i] = innerPadding[i] ^ key.at(i); // XOR operation between every byte in key and innerpadding, of key length
-        outerPadding[i] = outerPadding[i] ^ key.at(i); // XOR operation between every byte in key and outerpadding, of key length
+    for (int i = 0; i < blockKey.length(); i++) {
+        innerPadding[i] ^= uchar(blockKey.at(i));
+        outerPadding[i] ^= uchar(blockKey.at(i));
     }
 
-    // result = hash ( outerPadding CONCAT hash ( innerPadding CONCAT baseString ) ).toBase64
-    QByteArray total = outerPadding;
-    QByteArray part = innerPadding;
-    part.append(baseString);
-    total.append(QCryptographicHash::hash(part, QCryptographicHash::Sha1));
-    QByteArray hashed = QCryptographicHash::hash(total, QCryptographicHash::Sha1);
+    static const quint32 initialState[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+    memcpy(m_innerState, initialState, sizeof(m_innerState));
+    memcpy(m_outerState, initialState, sizeof(m_outerState));
+    sha1Block(m_innerState, innerPadding);
+    sha1Block(m_outerState, outerPadding);
+}
 
-    return hashed.toBase64();
+QByteArray Signer::sign(const QByteArray &message) const {
+    return this->sign(message.constData(), message.length());
 }
 
-QByteArray OAuth::createOAuthHeader(const QString &method, const QString &url, QMap<QString, QString> params) {
-    QString baseString;
-    baseString.append(method.toUpper() + "&" + url.toUtf8().toPercentEncoding() + "&");
+QByteArray Signer::sign(const char *message, int length) const {
+    // result = hash ( outerPadding CONCAT hash ( innerPadding CONCAT message ) ).toBase64
+    uchar innerDigest[SHA1_DIGEST_SIZE];
+    uchar digest[SHA1_DIGEST_SIZE];
+    sha1Finish(m_innerState, reinterpret_cast<const uchar*>(message), length, innerDigest);
+    sha1Finish(m_outerState, innerDigest, SHA1_DIGEST_SIZE, digest);
+
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(digest), SHA1_DIGEST_SIZE).toBase64();
+}
+
+qint64 OAuth::getTimeStamp() {
+    return QDateTime::currentMSecsSinceEpoch() / 1000;
+}
+
+// The splitmix64 finaliser: a bijection, so distinct inputs always give distinct outputs
+static inline quint64 mix(quint64 value) {
+    value += Q_UINT64_C(0x9e3779b97f4a7c15);
+    value = (value ^ (value >> 30)) * Q_UINT64_C(0xbf58476d1ce4e5b9);
+    value = (value ^ (value >> 27)) * Q_UINT64_C(0x94d049bb133111eb);
+
+    return value ^ (value >> 31);
+}
+
+// Identifies the calling thread and counts the nonces it has issued
+struct NonceSource {
+    quint64 thread;
+    quint32 count;
+};
+
+// The per-process state of getNonce(), built on first use
+struct NonceGenerator {
+    NonceGenerator() :
+        key(mix((quint64(QDateTime::currentMSecsSinceEpoch()) << 20) ^ quint64(QCoreApplication::applicationPid()))),
+        threads(0)
+    {
+    }
+
+    const quint64 key;
+    QAtomicInt threads;
+    QThreadStorage<NonceSource*> sources;
+};
+
+Q_GLOBAL_STATIC(NonceGenerator, nonceGenerator)
+
+quint64 OAuth::getNonce() {
+    // Each nonce scrambles a distinct (thread, count) pair with a per-process key, so nonces
+    // never repeat within a process, and are unlikely to collide between processes or restarts
+    NonceGenerator *generator = nonceGenerator();
+
+    if (!generator->sources.hasLocalData()) {
+        NonceSource *source = new NonceSource;
+        source->thread = quint64(quint32(generator->threads.fetchAndAddRelaxed(1)));
+        source->count = 0;
+        generator->sources.setLocalData(source);
+    }
+
+    NonceSource *source = generator->sources.localData();
 
-    QString nonce(OAuth::getNonce());
-    QString timeStamp(OAuth::getTimeStamp());
+    return mix(generator->key ^ ((source->thread << 32) | source->count++));
+}
+
+static inline bool isUnreserved(uchar c) {
+    return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9'))
+           || (c == '-') || (c == '.') || (c == '_') || (c == '~');
+}
 
-    params.insert("oauth_nonce", nonce);
-    params.insert("oauth_timestamp", timeStamp);
-    params.insert("oauth_signature_method", "HMAC-SHA1");
-    params.insert("oauth_version", "1.0");
+// Appends c percent-encoded once, or twice if twice is true ("%" itself becoming "%25")
+template <typename Buffer>
+static inline void appendEncoded(Buffer &out, uchar c, bool twice) {
+    static const char hex[] = "0123456789ABCDEF";
 
-    QMapIterator<QString, QString> iterator(params);
-    iterator.next();
-    baseString.append(QString(iterator.key() + "=" + iterator.value().toUtf8().toPercentEncoding()).toUtf8().toPercentEncoding());
+    if (isUnreserved(c)) {
+        out.append(char(c));
+        return;
+    }
+
+    out.append('%');
+
+    if (twice) {
+        out.append('2');
+        out.append('5');
+    }
 
-    while (iterator.hasNext()) {
-        iterator.next();
-        QString key(iterator.key());
+    out.append(hex[c >> 4]);
+    out.append(hex[c & 0xf]);
+}
+
+template <typename Buffer>
+static void appendEncoded(Buffer &out, const char *data, int length, bool twice) {
+    for (int i = 0; i < length; i++) {
+        appendEncoded(out, uchar(data[i]), twice);
+    }
+}
+
+// Percent-encodes the UTF-8 form of value without converting it to a QByteArray first
+template <typename Buffer>
+static void appendEncoded(Buffer &out, const QString &value, bool twice) {
+    const ushort *data = value.utf16();
+    const int length = value.length();
+
+    for (int i = 0; i < length; i++) {
+        uint c = data[i];
+
+        if (c < 0x80) {
+            appendEncoded(out, uchar(c), twice);
+            continue;
+        }
 
-        if ((key != "oauth_consumer_secret") && (key != "oauth_token_secret")) {
-            if (iterator.hasPrevious()) {
-                baseString.append(QString("&" + key + "=" + iterator.value()).toUtf8().toPercentEncoding());
+        if ((c >= 0xd800) && (c < 0xe000)) {
+            if ((c < 0xdc00) && (i + 1 < length) && (data[i + 1] >= 0xdc00) && (data[i + 1] < 0xe000)) {
+                c = 0x10000 + ((c - 0xd800) << 10) + (data[++i] - 0xdc00);
+            }
+            else { // unpaired surrogate, as QString::toUtf8()
+                appendEncoded(out, uchar('?'), twice);
+                continue;
+            }
+        }
+
+        if (c < 0x800) {
+            appendEncoded(out, uchar(0xc0 | (c >> 6)), twice);
+        }
+        else {
+            if (c < 0x10000) {
+                appendEncoded(out, uchar(0xe0 | (c >> 12)), twice);
             }
             else {
-                baseString.append(QString(key + "=" + iterator.value()).toUtf8().toPercentEncoding());
+                appendEncoded(out, uchar(0xf0 | (c >> 18)), twice);
+                appendEncoded(out, uchar(0x80 | ((c >> 12) & 0x3f)), twice);
             }
+
+            appendEncoded(out, uchar(0x80 | ((c >> 6) & 0x3f)), twice);
         }
+
+        appendEncoded(out, uchar(0x80 | (c & 0x3f)), twice);
     }
+}
 
-    QByteArray key(params.value("oauth_consumer_secret").toUtf8().toPercentEncoding() + "&" + params.value("oauth_token_secret").toUtf8().toPercentEncoding());
-    QByteArray signature(OAuth::createSignature(key, baseString.toUtf8()));
-    QByteArray header("OAuth ");
+// Compares a request parameter name with a fixed oauth_* name in QMap (UTF-16) order
+static int compareKey(const QString &key, const char *fixed) {
+    const ushort *data = key.utf16();
+    const int length = key.length();
 
-    params.insert("oauth_signature", QString(signature));
-    params.remove("oauth_consumer_secret");
-    params.remove("oauth_token_secret");
+    for (int i = 0; i < length; i++) {
+        const ushort c = uchar(fixed[i]);
 
-    foreach (QString key, params.keys()) {
-        if (!key.startsWith("oauth_")) {
-            params.remove(key);
+        if (c == 0) {
+            return 1;
         }
+
+        if (data[i] != c) {
+            return data[i] < c ? -1 : 1;
+        }
+    }
+
+    return fixed[length] == 0 ? 0 : -1;
+}
+
+// Writes the decimal digits of value to buffer, returning the number of digits
+static int formatNumber(char *buffer, qulonglong value) {
+    char digits[20];
+    int length = 0;
+
+    do {
+        digits[length++] = char('0' + (value % 10));
+        value /= 10;
+    } while (value > 0);
+
+    for (int i = 0; i < length; i++) {
+        buffer[i] = digits[length - 1 - i];
+    }
+
+    return length;
+}
+
+struct Parameter {
+    const char *key;
+    const char *value;
+    int length;
+};
+
+HeaderBuilder::HeaderBuilder() :
+    m_signer("&")
+{
+}
+
+void HeaderBuilder::setCredentials(const QString &consumerKey, const QString &consumerSecret,
+                                   const QString &tokenKey, const QString &tokenSecret) {
+
+    if ((consumerKey == m_consumerKey) && (consumerSecret == m_consumerSecret)
+        && (tokenKey == m_tokenKey) && (tokenSecret == m_tokenSecret)) {
+        return;
+    }
+
+    m_consumerKey = consumerKey;
+    m_consumerSecret = consumerSecret;
+    m_tokenKey = tokenKey;
+    m_tokenSecret = tokenSecret;
+    m_consumerKeyUtf8 = consumerKey.toUtf8();
+    m_tokenKeyUtf8 = tokenKey.toUtf8();
+    m_signer.setKey(consumerSecret.toUtf8().toPercentEncoding() + "&" + tokenSecret.toUtf8().toPercentEncoding());
+}
+
+QByteArray HeaderBuilder::build(const QString &method, const QString &url, const QMap<QString, QString> &params) {
+    char nonce[20];
+    char timeStamp[20];
+    const int nonceLength = formatNumber(nonce, OAuth::getNonce());
+    const int timeStampLength = formatNumber(timeStamp, OAuth::getTimeStamp());
+
+    return this->build(method, url, params, nonce, nonceLength, timeStamp, timeStampLength);
+}
+
+QByteArray HeaderBuilder::build(const QString &method, const QString &url, const QMap<QString, QString> &params,
+                                const QByteArray &nonce, const QByteArray &timeStamp) {
+
+    return this->build(method, url, params, nonce.constData(), nonce.length(), timeStamp.constData(), timeStamp.length());
+}
+
+QList<QByteArray> HeaderBuilder::buildBatch(const QString &method, const QStringList &urls, const QMap<QString, QString> &params) {
+    // One timestamp serves the whole batch; each header still gets its own nonce
+    char timeStamp[20];
+    const int timeStampLength = formatNumber(timeStamp, OAuth::getTimeStamp());
+    QList<QByteArray> headers;
+    headers.reserve(urls.size());
+
+    foreach (const QString &url, urls) {
+        char nonce[20];
+        const int nonceLength = formatNumber(nonce, OAuth::getNonce());
+        headers.append(this->build(method, url, params, nonce, nonceLength, timeStamp, timeStampLength));
+    }
+
+    return headers;
+}
+
+QByteArray HeaderBuilder::build(const QString &method, const QString &url, const QMap<QString, QString> &params,
+                                const char *nonce, int nonceLength, const char *timeStamp, int timeStampLength) {
+
+    // The signed oauth_* parameters, in sorted order
+    const Parameter fixed[] = {
+        { "oauth_consumer_key", m_consumerKeyUtf8.constData(), m_consumerKeyUtf8.length() },
+        { "oauth_nonce", nonce, nonceLength },
+        { "oauth_signature_method", "HMAC-SHA1", 9 },
+        { "oauth_timestamp", timeStamp, timeStampLength },
+        { "oauth_token", m_tokenKeyUtf8.constData(), m_tokenKeyUtf8.length() },
+        { "oauth_version", "1.0", 3 }
+    };
+    const int fixedCount = int(sizeof(fixed) / sizeof(fixed[0]));
+
+    // baseString = METHOD&encode(url)&encode(key=value&key=value...)
+    m_baseString.clear();
+
+    for (int i = 0; i < method.length(); i++) {
+        const ushort c = method.utf16()[i];
+        m_baseString.append(char(((c >= 'a') && (c <= 'z')) ? c - 'a' + 'A' : c));
     }
 
-    QMapIterator<QString, QString> headerIterator(params);
-    headerIterator.toFront();
+    m_baseString.append('&');
+    appendEncoded(m_baseString, url, false);
+    m_baseString.append('&');
 
-    while (headerIterator.hasNext()) {
-        headerIterator.next();
+    QMap<QString, QString>::const_iterator iterator = params.constBegin();
+    int slot = 0;
+    bool first = true;
+
+    while ((iterator != params.constEnd()) || (slot < fixedCount)) {
+        const int order = (iterator == params.constEnd()) ? 1
+                          : (slot == fixedCount) ? -1 : compareKey(iterator.key(), fixed[slot].key);
+
+        if (order == 0) { // the oauth_* value takes precedence
+            ++iterator;
+            continue;
+        }
+
+        // The first value has always been encoded on its own before the pair is encoded,
+        // so it is encoded twice
+        const bool twice = first;
+
+        if (first) {
+            first = false;
+        }
+        else {
+            m_baseString.append("%26", 3);
+        }
 
-        if (headerIterator.hasNext()) {
-            header.append(headerIterator.key().toUtf8() + "=\"" + headerIterator.value().toUtf8().toPercentEncoding() + "\", ");
+        if (order < 0) {
+            appendEncoded(m_baseString, iterator.key(), false);
+            m_baseString.append("%3D", 3);
+            appendEncoded(m_baseString, iterator.value(), twice);
+            ++iterator;
         }
         else {
-            header.append(headerIterator.key().toUtf8() + "=\"" + headerIterator.value().toUtf8().toPercentEncoding() + "\"");
+            appendEncoded(m_baseString, fixed[slot].key, int(strlen(fixed[slot].key)), false);
+            m_baseString.append("%3D", 3);
+            appendEncoded(m_baseString, fixed[slot].value, fixed[slot].length, twice);
+            ++slot;
         }
     }
 
+    const QByteArray signature = m_signer.sign(m_baseString.constData(), m_baseString.size());
+
+    // The header lists the oauth_* parameters and the signature, in sorted order
+    QByteArray header;
+    header.reserve(256 + 3 * (m_consumerKeyUtf8.length() + m_tokenKeyUtf8.length()));
+    header.append("OAuth ");
+
+    for (int i = 0; i < fixedCount; i++) {
+        if (i == 2) {
+            header.append("oauth_signature=\"");
+            appendEncoded(header, signature.constData(), signature.length(), false);
+            header.append("\", ");
+        }
+
+        header.append(fixed[i].key);
+        header.append("=\"");
+        appendEncoded(header, fixed[i].value, fixed[i].length, false);
+        header.append(i + 1 < fixedCount ? "\", " : "\"");
+    }
+
     return header;
 }
 
+QByteArray OAuth::createOAuthHeader(const QString &method, const QString &url, QMap<QString, QString> params) {
+    const QString consumerKey = params.take("oauth_consumer_key");
+    const QString consumerSecret = params.take("oauth_consumer_secret");
+    const QString tokenKey = params.take("oauth_token");
+    const QString tokenSecret = params.take("oauth_token_secret");
+
+    return OAuth::createOAuthHeader(method, url, params, consumerKey, consumerSecret, tokenKey, tokenSecret);
+}
+
+QByteArray OAuth::createOAuthHeader(const QString &method, const QString &url, const QMap<QString, QString> &params,
+                                    const QString &consumerKey, const QString &consumerSecret,
+                                    const QString &tokenKey, const QString &tokenSecret) {
+
+    // Each thread keeps a builder for the last credentials it signed with
+    static QThreadStorage<HeaderBuilder*> builders;
+
+    if (!builders.hasLocalData()) {
+        builders.setLocalData(new HeaderBuilder);
+    }
+
+    HeaderBuilder *builder = builders.localData();
+    builder->setCredentials(consumerKey, consumerSecret, tokenKey, tokenSecret);
+
+    return builder->build(method, url, params);
+}
+
 }
@@ -20,20 +20,88 @@
 
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
 #include <QMap>
+#include <QList>
 #include <QUrl>
+#include <QVarLengthArray>
 
 namespace QtOAuth {
 
+/**
+ * Computes HMAC-SHA1 signatures for a fixed key.
+ *
+ * The SHA-1 states after absorbing the inner and outer padded key blocks
+ * are computed once in setKey(), so each call to sign() only hashes the
+ * message and the inner digest.
+ */
+class Signer {
+
+public:
+    Signer();
+    explicit Signer(const QByteArray &key);
+
+    QByteArray key() const;
+    void setKey(const QByteArray &key);
+
+    QByteArray sign(const QByteArray &message) const;
+    QByteArray sign(const char *message, int length) const;
+
+private:
+    QByteArray m_key;
+    quint32 m_innerState[5];
+    quint32 m_outerState[5];
+};
+
+/**
+ * Builds OAuth 1.0 HMAC-SHA1 Authorization headers for one set of credentials.
+ *
+ * The credentials are converted and the signing key prepared once in setCredentials().
+ * build() writes the signature base string into a buffer that is reused between calls,
+ * percent-encoding each parameter in a single pass, and merges the request parameters
+ * with the fixed oauth_* parameters in sorted order without copying the map.
+ * buildBatch() signs one request per URL, sharing a single timestamp.
+ */
+class HeaderBuilder {
+
+public:
+    HeaderBuilder();
+
+    void setCredentials(const QString &consumerKey, const QString &consumerSecret,
+                        const QString &tokenKey, const QString &tokenSecret);
+
+    QByteArray build(const QString &method, const QString &url, const QMap<QString, QString> &params);
+    QByteArray build(const QString &method, const QString &url, const QMap<QString, QString> &params,
+                     const QByteArray &nonce, const QByteArray &timeStamp);
+    QList<QByteArray> buildBatch(const QString &method, const QStringList &urls, const QMap<QString, QString> &params);
+
+private:
+    QByteArray build(const QString &method, const QString &url, const QMap<QString, QString> &params,
+                     const char *nonce, int nonceLength, const char *timeStamp, int timeStampLength);
+
+    QString m_consumerKey;
+    QString m_consumerSecret;
+    QString m_tokenKey;
+    QString m_tokenSecret;
+    QByteArray m_consumerKeyUtf8;
+    QByteArray m_tokenKeyUtf8;
+    Signer m_signer;
+    QVarLengthArray<char, 1024> m_baseString;
+};
+
 class OAuth {
 
 public:
     static QByteArray createOAuthHeader(const QString &method, const QString &url, QMap<QString, QString> params);
+    static QByteArray createOAuthHeader(const QString &method, const QString &url, const QMap<QString, QString> &params,
+                                        const QString &consumerKey, const QString &consumerSecret,
+                                        const QString &tokenKey, const QString &tokenSecret);
 
 private:
-    static QString getTimeStamp();
-    static QString getNonce();
-    static QByteArray createSignature(QByteArray key, QByteArray baseString);
+    static qint64 getTimeStamp();
+    static quint64 getNonce();
+
+    friend class HeaderBuilder;
 };
 
 }
@@ -21,6 +21,43 @@
 
 namespace QtUbuntuOne {
 
+static const char * const PLAYLIST_KEYS[] = {
+    "id",
+    "name",
+    "playlist_url",
+    "song_count"
+};
+
+enum PlaylistKeys {
+    IdKey = 0,
+    NameKey,
+    PlaylistUrlKey,
+    SongCountKey,
+    PlaylistKeyCount
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(QtJson::JsonKeyTable, playlistKeyTable, (PLAYLIST_KEYS, PlaylistKeyCount))
+
+/**
+ * Binds the members of a single playlist response directly to the playlist
+ */
+class PlaylistReader : public QtJson::JsonObjectReader
+{
+
+public:
+    explicit PlaylistReader(PlaylistPrivate *playlist) :
+        QtJson::JsonObjectReader(QStringList("response")),
+        m_playlist(playlist)
+    {
+    }
+
+private:
+    void beginItem() { m_playlist->beginLoad(); }
+    void readItemValue(const QString &key, const QVariant &value) { m_playlist->loadProperty(key, value); }
+
+    PlaylistPrivate *m_playlist;
+};
+
 PlaylistPrivate::PlaylistPrivate(Playlist *parent) :
     q_ptr(parent),
     m_reply(0),
@@ -76,12 +113,43 @@ void PlaylistPrivate::loadPlaylist(Playlist *otherPlaylist) {
 }
 
 void PlaylistPrivate::loadPlaylist(const QVariantMap &playlist) {
-    Q_Q(Playlist);
+    this->beginLoad();
+
+    for (QVariantMap::const_iterator iterator = playlist.constBegin(); iterator != playlist.constEnd(); ++iterator) {
+        this->loadProperty(iterator.key(), iterator.value());
+    }
 
-    this->setId(playlist.value("id").toString());
-    this->setName(playlist.value("name").toString());
-    this->setUrl(playlist.value("playlist_url").toUrl());
-    this->setSongCount(playlist.value("song_count").toInt());
+    this->endLoad();
+}
+
+void PlaylistPrivate::beginLoad() {
+    this->setId(QString());
+    this->setName(QString());
+    this->setUrl(QUrl());
+    this->setSongCount(0);
+}
+
+void PlaylistPrivate::loadProperty(const QString &key, const QVariant &value) {
+    switch (playlistKeyTable()->indexOf(key)) {
+    case IdKey:
+        this->setId(value.toString());
+        break;
+    case NameKey:
+        this->setName(value.toString());
+        break;
+    case PlaylistUrlKey:
+        this->setUrl(value.toUrl());
+        break;
+    case SongCountKey:
+        this->setSongCount(value.toInt());
+        break;
+    default:
+        break;
+    }
+}
+
+void PlaylistPrivate::endLoad() {
+    Q_Q(Playlist);
 
     emit q->ready(q);
 }
@@ -157,11 +225,12 @@ void PlaylistPrivate::_q_onReplyFinished() {
             return;
         }
 
-        QString response(m_reply->readAll());
-        QVariantMap result = QtJson::Json::parse(response).toMap();
+        PlaylistReader reader(this);
+        QtJson::JsonStreamParser parser(&reader);
 
-        if (!result.isEmpty()) {
-            this->loadPlaylist(result.value("response").toMap());
+        // endLoad() emits ready(), so it is only called once the whole response is valid
+        if ((parser.feed(m_reply->readAll())) && (parser.finish()) && (reader.isFound())) {
+            this->endLoad();
         }
         else {
             this->setError(Playlist::ParserError);
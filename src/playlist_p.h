@@ -34,6 +34,10 @@ public:
     void loadPlaylist(Playlist *otherPlaylist);
     void loadPlaylist(const QVariantMap &playlist);
 
+    void beginLoad();
+    void loadProperty(const QString &key, const QVariant &value);
+    void endLoad();
+
     QString id() const;
 
     QString name() const;
@@ -151,6 +151,7 @@ private:
 
     Q_DECLARE_PRIVATE(PlaylistList)
 
+    Q_PRIVATE_SLOT(d_func(), void _q_onReplyReadyRead())
     Q_PRIVATE_SLOT(d_func(), void _q_onReplyFinished())
 };
 
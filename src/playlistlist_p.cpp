@@ -17,18 +17,21 @@
 
 #include "playlistlist_p.h"
 #include "playlist_p.h"
-#include "json.h"
 
 namespace QtUbuntuOne {
 
 PlaylistListPrivate::PlaylistListPrivate(QNetworkReply *reply, PlaylistList *parent) :
+    QtJson::JsonArrayReader(QStringList() << "response" << "playlists"),
     q_ptr(parent),
     m_reply(reply),
+    m_parser(this),
+    m_currentPlaylist(0),
     m_error(PlaylistList::NoError)
 {
     Q_Q(PlaylistList);
 
     if (m_reply) {
+        q->connect(m_reply, SIGNAL(readyRead()), q, SLOT(_q_onReplyReadyRead()));
         q->connect(m_reply, SIGNAL(finished()), q, SLOT(_q_onReplyFinished()));
     }
 }
@@ -38,6 +41,11 @@ PlaylistListPrivate::~PlaylistListPrivate() {
         delete m_reply;
         m_reply = 0;
     }
+
+    if (m_currentPlaylist) {
+        delete m_currentPlaylist;
+        m_currentPlaylist = 0;
+    }
 }
 
 int PlaylistListPrivate::count() const {
@@ -64,16 +72,25 @@ void PlaylistListPrivate::setErrorString(const QString &errorstring) {
     m_errorString = errorstring;
 }
 
-void PlaylistListPrivate::loadPlaylists(const QVariantList &playlists) {
-    Q_Q(PlaylistList);
+void PlaylistListPrivate::readItem(const QVariant &item) {
+    Playlist *p = new Playlist;
+    p->d_func()->loadPlaylist(item.toMap());
+    m_playlists.append(p);
+}
 
-    foreach (QVariant playlist, playlists) {
-        Playlist *p = new Playlist;
-        p->d_func()->loadPlaylist(playlist.toMap());
-        m_playlists.append(p);
-    }
+void PlaylistListPrivate::beginItem() {
+    m_currentPlaylist = new Playlist;
+    m_currentPlaylist->d_func()->beginLoad();
+}
+
+void PlaylistListPrivate::readItemValue(const QString &key, const QVariant &value) {
+    m_currentPlaylist->d_func()->loadProperty(key, value);
+}
 
-    emit q->ready(q);
+void PlaylistListPrivate::endItem() {
+    m_currentPlaylist->d_func()->endLoad();
+    m_playlists.append(m_currentPlaylist);
+    m_currentPlaylist = 0;
 }
 
 void PlaylistListPrivate::cancel() {
@@ -82,6 +99,17 @@ void PlaylistListPrivate::cancel() {
     }
 }
 
+void PlaylistListPrivate::_q_onReplyReadyRead() {
+    if ((m_reply) && (!m_parser.hasError())) {
+        int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+        // Parse successful responses as they arrive
+        if ((status >= 200) && (status < 300)) {
+            m_parser.feed(m_reply->readAll());
+        }
+    }
+}
+
 void PlaylistListPrivate::_q_onReplyFinished() {
     Q_Q(PlaylistList);
 
@@ -99,23 +127,15 @@ void PlaylistListPrivate::_q_onReplyFinished() {
             return;
         }
 
-        QString response(m_reply->readAll());
-        QVariant result = QtJson::Json::parse(response);
+        m_parser.feed(m_reply->readAll());
 
-        switch (result.type()) {
-        case QVariant::Map:
-            this->loadPlaylists(result.toMap().value("response").toMap().value("playlists").toList());
-            break;
-        case QVariant::List:
-            this->loadPlaylists(result.toList());
-            break;
-        default:
+        if ((!m_parser.finish()) || (!this->isValid())) {
             this->setError(PlaylistList::ParserError);
             this->setErrorString(QObject::tr("Cannot parse server response"));
-            emit q->ready(q);
-            break;
         }
 
+        emit q->ready(q);
+
         m_reply->deleteLater();
         m_reply = 0;
     }
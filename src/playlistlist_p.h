@@ -19,10 +19,11 @@
 #define PLAYLISTLIST_P_H
 
 #include "playlistlist.h"
+#include "json.h"
 
 namespace QtUbuntuOne {
 
-class PlaylistListPrivate
+class PlaylistListPrivate : public QtJson::JsonArrayReader
 {
 
 public:
@@ -42,15 +43,22 @@ private:
     void setError(PlaylistList::Error error);
     void setErrorString(const QString &errorstring);
 
-    void loadPlaylists(const QVariantList &playlists);
+    void readItem(const QVariant &item);
+    void beginItem();
+    void readItemValue(const QString &key, const QVariant &value);
+    void endItem();
 
+    void _q_onReplyReadyRead();
     void _q_onReplyFinished();
 
     PlaylistList *q_ptr;
 
     QNetworkReply *m_reply;
 
+    QtJson::JsonStreamParser m_parser;
+
     QList<Playlist*> m_playlists;
+    Playlist *m_currentPlaylist;
 
     PlaylistList::Error m_error;
     QString m_errorString;
@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "queuedreply.h"
+#include "networkaccessmanager.h"
+#include "diskcache.h"
+#include "memorycache.h"
+#include <QTimer>
+
+QueuedReply::QueuedReply(QNetworkAccessManager::Operation operation, const QNetworkRequest &request,
+                         QIODevice *outgoingData, NetworkAccessManager *manager) :
+    QNetworkReply(manager),
+    m_manager(manager),
+    m_outgoingData(outgoingData),
+    m_reply(0),
+    m_attempts(0),
+    m_queuedAt(0),
+    m_retryDelay(-1),
+    m_dataDelivered(false),
+    m_cachedData(0)
+{
+    this->setOperation(operation);
+    this->setRequest(request);
+    this->setUrl(request.url());
+    this->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+QueuedReply::~QueuedReply() {
+    this->discardCache();
+}
+
+QIODevice* QueuedReply::outgoingData() const {
+    return m_outgoingData;
+}
+
+int QueuedReply::attempts() const {
+    return m_attempts;
+}
+
+qint64 QueuedReply::queuedAt() const {
+    return m_queuedAt;
+}
+
+void QueuedReply::setQueuedAt(qint64 msecs) {
+    m_queuedAt = msecs;
+}
+
+QNetworkReply* QueuedReply::reply() const {
+    return m_reply;
+}
+
+void QueuedReply::setReply(QNetworkReply *reply) {
+    m_reply = reply;
+    m_reply->setParent(this);
+
+    this->connect(m_reply, SIGNAL(metaDataChanged()), this, SLOT(onMetaDataChanged()));
+    this->connect(m_reply, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+    this->connect(m_reply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(onDownloadProgress(qint64,qint64)));
+    this->connect(m_reply, SIGNAL(uploadProgress(qint64,qint64)), this, SLOT(onUploadProgress(qint64,qint64)));
+#if QT_VERSION >= 0x050f00
+    this->connect(m_reply, SIGNAL(errorOccurred(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
+#else
+    this->connect(m_reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(onError(QNetworkReply::NetworkError)));
+#endif
+    this->connect(m_reply, SIGNAL(finished()), this, SLOT(onFinished()));
+}
+
+void QueuedReply::setCache(QAbstractNetworkCache *cache, const QUrl &key) {
+    m_cache = cache;
+    m_cacheKey = key;
+}
+
+RequestSigner* QueuedReply::signer() const {
+    return m_signer.data();
+}
+
+// Takes ownership of the signer
+void QueuedReply::setSigner(RequestSigner *signer) {
+    m_signer.reset(signer);
+}
+
+qint64 QueuedReply::bytesAvailable() const {
+    if (m_cachedData) {
+        return QNetworkReply::bytesAvailable() + m_cachedData->bytesAvailable();
+    }
+
+    return QNetworkReply::bytesAvailable() + ((m_reply) && (m_retryDelay < 0) ? m_reply->bytesAvailable() : 0);
+}
+
+void QueuedReply::abort() {
+    if (m_reply) {
+        m_retryDelay = -1;
+        m_reply->abort();
+        return;
+    }
+
+    if (this->isFinished()) {
+        return;
+    }
+
+    // Not sent yet, or waiting to be sent again, so finish in the same way as an aborted request
+    this->setError(QNetworkReply::OperationCanceledError, tr("Operation canceled"));
+#if QT_VERSION >= 0x050f00
+    emit errorOccurred(QNetworkReply::OperationCanceledError);
+#else
+    emit error(QNetworkReply::OperationCanceledError);
+#endif
+    this->setFinished(true);
+    emit finished();
+}
+
+qint64 QueuedReply::readData(char *data, qint64 maxSize) {
+    if (m_cachedData) {
+        return m_cachedData->read(data, maxSize);
+    }
+
+    if ((!m_reply) || (m_retryDelay >= 0)) {
+        return this->isFinished() ? -1 : 0;
+    }
+
+    const qint64 read = m_reply->read(data, maxSize);
+
+    if ((read > 0) && (m_cacheDevice)) {
+        m_cacheDevice->write(data, read);
+    }
+
+    return read;
+}
+
+void QueuedReply::copyMetaData() {
+    static const QNetworkRequest::Attribute attributes[] = {
+        QNetworkRequest::HttpStatusCodeAttribute,
+        QNetworkRequest::HttpReasonPhraseAttribute,
+        QNetworkRequest::RedirectionTargetAttribute,
+        QNetworkRequest::ConnectionEncryptedAttribute,
+        QNetworkRequest::SourceIsFromCacheAttribute
+    };
+
+    this->setUrl(m_reply->url());
+
+    foreach (const QNetworkReply::RawHeaderPair &header, m_reply->rawHeaderPairs()) {
+        this->setRawHeader(header.first, header.second);
+    }
+
+    for (uint i = 0; i < sizeof(attributes) / sizeof(attributes[0]); i++) {
+        this->setAttribute(attributes[i], m_reply->attribute(attributes[i]));
+    }
+}
+
+bool QueuedReply::loadFromCache() {
+    const QNetworkCacheMetaData metaData = m_cache->metaData(m_cacheKey);
+    m_cachedData = metaData.isValid() ? m_cache->data(m_cacheKey) : 0;
+
+    if (!m_cachedData) {
+        return false;
+    }
+
+    m_cachedData->setParent(this);
+    this->setUrl(m_reply->url());
+
+    foreach (const QNetworkCacheMetaData::RawHeader &header, metaData.rawHeaders()) {
+        this->setRawHeader(header.first, header.second);
+    }
+
+    QHashIterator<QNetworkRequest::Attribute, QVariant> iterator(metaData.attributes());
+
+    while (iterator.hasNext()) {
+        iterator.next();
+        this->setAttribute(iterator.key(), iterator.value());
+    }
+
+    this->setAttribute(QNetworkRequest::SourceIsFromCacheAttribute, true);
+
+    return true;
+}
+
+void QueuedReply::prepareCache() {
+    this->discardCache();
+
+    if (m_reply->rawHeader("ETag").isEmpty()) {
+        // Nothing to revalidate with, so do not keep an older version
+        m_cache->remove(m_cacheKey);
+        return;
+    }
+
+    QNetworkCacheMetaData::AttributesMap attributes;
+    attributes.insert(QNetworkRequest::HttpStatusCodeAttribute, 200);
+    attributes.insert(QNetworkRequest::HttpReasonPhraseAttribute, m_reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute));
+
+    QNetworkCacheMetaData metaData;
+    metaData.setUrl(m_cacheKey);
+    metaData.setRawHeaders(m_reply->rawHeaderPairs());
+    metaData.setAttributes(attributes);
+    metaData.setSaveToDisk(true);
+    m_cacheDevice = m_cache->prepare(metaData);
+}
+
+void QueuedReply::finishCache() {
+    if ((!m_cache) || (!m_cacheDevice)) {
+        return;
+    }
+
+    if (m_reply->error() == QNetworkReply::NoError) {
+        // Add whatever the caller has not read yet
+        m_cacheDevice->write(m_reply->peek(m_reply->bytesAvailable()));
+        m_cache->insert(m_cacheDevice);
+        m_cacheDevice = 0;
+    }
+    else {
+        this->discardCache();
+    }
+}
+
+void QueuedReply::discardCache() {
+    if ((!m_cache) || (!m_cacheDevice)) {
+        return;
+    }
+
+    if (QtUbuntuOne::MemoryCache *cache = qobject_cast<QtUbuntuOne::MemoryCache*>(m_cache)) {
+        cache->discard(m_cacheDevice);
+    }
+    else if (QtUbuntuOne::DiskCache *cache = qobject_cast<QtUbuntuOne::DiskCache*>(m_cache)) {
+        cache->discard(m_cacheDevice);
+    }
+    else {
+        // QAbstractNetworkCache can only drop prepared data along with the cached entry
+        m_cache->remove(m_cacheKey);
+    }
+
+    m_cacheDevice = 0;
+}
+
+void QueuedReply::onMetaDataChanged() {
+    const int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    if ((m_retryDelay < 0) && (!m_dataDelivered) && (NetworkAccessManager::isTransientStatus(status))) {
+        m_retryDelay = m_manager->retryDelay(this, m_reply);
+    }
+
+    if (m_retryDelay >= 0) {
+        return;
+    }
+
+    if (m_cache) {
+        if (status == 304) {
+            if (!this->loadFromCache()) {
+                // The cached data has gone, so ask again without If-None-Match
+                m_cache->remove(m_cacheKey);
+                m_retryDelay = 0;
+                return;
+            }
+
+            emit metaDataChanged();
+            return;
+        }
+
+        if (status == 200) {
+            this->prepareCache();
+        }
+    }
+
+    this->copyMetaData();
+    emit metaDataChanged();
+}
+
+void QueuedReply::onReadyRead() {
+    if (m_retryDelay < 0) {
+        m_dataDelivered = true;
+        emit readyRead();
+    }
+}
+
+void QueuedReply::onDownloadProgress(qint64 received, qint64 total) {
+    if (m_retryDelay < 0) {
+        emit downloadProgress(received, total);
+    }
+}
+
+void QueuedReply::onUploadProgress(qint64 sent, qint64 total) {
+    if (m_retryDelay < 0) {
+        emit uploadProgress(sent, total);
+    }
+}
+
+void QueuedReply::onError(QNetworkReply::NetworkError code) {
+    if ((m_retryDelay < 0) && (!m_dataDelivered) && (NetworkAccessManager::isTransientError(code))) {
+        m_retryDelay = m_manager->retryDelay(this, m_reply);
+    }
+
+    if (m_retryDelay < 0) {
+        this->setError(code, m_reply->errorString());
+#if QT_VERSION >= 0x050f00
+        emit errorOccurred(code);
+#else
+        emit error(code);
+#endif
+    }
+}
+
+void QueuedReply::onFinished() {
+    if (m_retryDelay >= 0) {
+        this->discardCache();
+        m_attempts++;
+        m_reply->disconnect(this);
+        m_reply->deleteLater();
+        m_reply = 0;
+        QTimer::singleShot(m_retryDelay, this, SLOT(retry()));
+        return;
+    }
+
+    if (m_cachedData) {
+        if (m_cachedData->bytesAvailable() > 0) {
+            emit readyRead();
+        }
+    }
+    else {
+        this->finishCache();
+        this->copyMetaData();
+    }
+
+    this->setFinished(true);
+    emit finished();
+}
+
+void QueuedReply::retry() {
+    m_retryDelay = -1;
+
+    // Aborted while waiting
+    if (!this->isFinished()) {
+        m_manager->schedule(this);
+    }
+}
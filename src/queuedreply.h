@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef QUEUEDREPLY_H
+#define QUEUEDREPLY_H
+
+#include <QNetworkReply>
+#include <QPointer>
+#include <QScopedPointer>
+#include <QAbstractNetworkCache>
+
+class NetworkAccessManager;
+
+/**
+ * Produces the Authorization header of a request.
+ *
+ * OAuth headers carry a nonce and a timestamp, so a request that is sent
+ * again, or that waited in a queue, is signed again before it is sent.
+ */
+class RequestSigner
+{
+
+public:
+    virtual ~RequestSigner() {}
+
+    // Returns an empty header if the request can no longer be signed
+    virtual QByteArray authorization() const = 0;
+};
+
+/**
+ * The reply returned for every request made through NetworkAccessManager.
+ *
+ * Callers get a QueuedReply straight away and use it like any other
+ * reply. When the request is sent, the real reply is attached and its
+ * data, metadata and signals are passed through. If the request fails
+ * in a way that is worth retrying before any data has been passed on,
+ * the failure is held back and the request is sent again.
+ *
+ * If a cache is set, successful responses that carry an ETag are
+ * stored in it, and a 304 Not Modified response is answered with the
+ * stored response.
+ */
+class QueuedReply : public QNetworkReply
+{
+    Q_OBJECT
+
+public:
+    QueuedReply(QNetworkAccessManager::Operation operation, const QNetworkRequest &request, QIODevice *outgoingData,
+                NetworkAccessManager *manager);
+    ~QueuedReply();
+
+    QIODevice* outgoingData() const;
+
+    int attempts() const;
+
+    qint64 queuedAt() const;
+    void setQueuedAt(qint64 msecs);
+
+    QNetworkReply* reply() const;
+    void setReply(QNetworkReply *reply);
+
+    void setCache(QAbstractNetworkCache *cache, const QUrl &key);
+
+    RequestSigner* signer() const;
+    void setSigner(RequestSigner *signer);
+
+    qint64 bytesAvailable() const;
+
+public slots:
+    void abort();
+
+protected:
+    qint64 readData(char *data, qint64 maxSize);
+
+private slots:
+    void onMetaDataChanged();
+    void onReadyRead();
+    void onDownloadProgress(qint64 received, qint64 total);
+    void onUploadProgress(qint64 sent, qint64 total);
+    void onError(QNetworkReply::NetworkError error);
+    void onFinished();
+    void retry();
+
+private:
+    void copyMetaData();
+
+    bool loadFromCache();
+    void prepareCache();
+    void finishCache();
+    void discardCache();
+
+    NetworkAccessManager *m_manager;
+    QPointer<QIODevice> m_outgoingData;
+    QNetworkReply *m_reply;
+    int m_attempts;
+    qint64 m_queuedAt;
+    int m_retryDelay;
+    bool m_dataDelivered;
+    QPointer<QAbstractNetworkCache> m_cache;
+    QUrl m_cacheKey;
+    QPointer<QIODevice> m_cacheDevice;
+    QIODevice *m_cachedData;
+    QScopedPointer<RequestSigner> m_signer;
+};
+
+#endif // QUEUEDREPLY_H
@@ -46,7 +46,14 @@ public:
         }
     }
 
-    inline QVariant result() const { return m_result; }
+    inline QVariant result() const {
+        // The document is only converted when the result is first requested
+        if ((!m_result.isValid()) && (!m_document.isNull())) {
+            m_result = m_document.toVariant();
+        }
+
+        return m_result;
+    }
 
     inline Reply::Error error() const { return m_error; }
     inline QString errorString() const { return m_errorString; }
@@ -59,6 +66,7 @@ public:
 
 private:
     inline void setResult(const QVariant &result) { m_result = result; }
+    inline void setDocument(const QtJson::JsonDocument &document) { m_document = document; m_result = QVariant(); }
 
     inline void setError(Reply::Error error) { m_error = error; }
     inline void setErrorString(const QString &errorString) { m_errorString = errorString; }
@@ -81,14 +89,14 @@ private:
             }
 
             bool ok;
-            QString response(m_reply->readAll());
-            QVariant result = QtJson::Json::parse(response, ok);
+            QByteArray response(m_reply->readAll());
+            QtJson::JsonDocument document = QtJson::JsonDocument::fromJson(response, ok);
 
             if (ok) {
-                this->setResult(result);
+                this->setDocument(document);
             }
             else {
-                this->setResult(response);
+                this->setResult(QString::fromUtf8(response));
                 this->setError(Reply::ParserError);
                 this->setErrorString(QObject::tr("Cannot parse server response"));
             }
@@ -101,7 +109,8 @@ private:
 
     QNetworkReply *m_reply;
 
-    QVariant m_result;
+    QtJson::JsonDocument m_document;
+    mutable QVariant m_result;
 
     Reply::Error m_error;
     QString m_errorString;
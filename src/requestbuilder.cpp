@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "requestbuilder.h"
+#include "session_p.h"
+#include "networkaccessmanager.h"
+#include "queuedreply.h"
+#include <QNetworkReply>
+#if QT_VERSION >= 0x050000
+#include <QUrlQuery>
+#endif
+
+namespace QtUbuntuOne {
+
+/**
+ * The constant headers, set up once and shared by every request.
+ */
+struct RequestTemplates {
+    RequestTemplates() {
+        data.setRawHeader("User-Agent", "QUbuntuOne (Qt)");
+        json = data;
+        json.setRawHeader("Accept", "application/json");
+    }
+
+    QNetworkRequest data;
+    QNetworkRequest json;
+};
+
+Q_GLOBAL_STATIC(RequestTemplates, requestTemplates)
+
+/**
+ * Signs a request again each time that it is sent.
+ */
+class OAuthSigner : public RequestSigner
+{
+
+public:
+    OAuthSigner(Session *session, const QByteArray &verb, const QString &url, const QMap<QString, QString> &params) :
+        m_session(session),
+        m_verb(verb),
+        m_url(url),
+        m_params(params)
+    {
+    }
+
+    QByteArray authorization() const {
+        return m_session ? m_session->getOAuthHeader(m_verb, m_url, m_params) : QByteArray();
+    }
+
+private:
+    QPointer<Session> m_session;
+    QByteArray m_verb;
+    QString m_url;
+    QMap<QString, QString> m_params;
+};
+
+RequestBuilder::RequestBuilder(const QUrl &url, Signing signing, Session *session) :
+    m_url(url),
+    m_signing(signing),
+    m_session(session),
+    m_acceptJson(true),
+    m_priority(Normal),
+    m_cacheable(false)
+{
+}
+
+/**
+ * addQueryItem
+ */
+RequestBuilder& RequestBuilder::addQueryItem(const QString &key, const QString &value) {
+    // Query items are signed as OAuth parameters
+    m_query.append(qMakePair(key, value));
+    m_params.insert(key, value);
+
+    return *this;
+}
+
+/**
+ * setHeader
+ */
+RequestBuilder& RequestBuilder::setHeader(QNetworkRequest::KnownHeaders header, const QVariant &value) {
+    m_headers.insert(header, value);
+
+    return *this;
+}
+
+/**
+ * setRawHeader
+ */
+RequestBuilder& RequestBuilder::setRawHeader(const QByteArray &name, const QByteArray &value) {
+    m_rawHeaders.append(qMakePair(name, value));
+
+    return *this;
+}
+
+/**
+ * setAcceptJson
+ */
+RequestBuilder& RequestBuilder::setAcceptJson(bool accept) {
+    m_acceptJson = accept;
+
+    return *this;
+}
+
+/**
+ * setPriority
+ */
+RequestBuilder& RequestBuilder::setPriority(Priority priority) {
+    m_priority = priority;
+
+    return *this;
+}
+
+/**
+ * setCacheable
+ */
+RequestBuilder& RequestBuilder::setCacheable(bool cacheable) {
+    m_cacheable = cacheable;
+
+    return *this;
+}
+
+/**
+ * get
+ */
+QNetworkReply* RequestBuilder::get() {
+    return this->send("GET", QByteArray(), 0);
+}
+
+/**
+ * put
+ */
+QNetworkReply* RequestBuilder::put(const QByteArray &data) {
+    return this->send("PUT", data, 0);
+}
+
+/**
+ * put
+ */
+QNetworkReply* RequestBuilder::put(QIODevice *device) {
+    return this->send("PUT", QByteArray(), device);
+}
+
+/**
+ * putJson
+ */
+QNetworkReply* RequestBuilder::putJson(const QByteArray &json) {
+    m_headers.insert(QNetworkRequest::ContentTypeHeader, "application/json");
+
+    return this->send("PUT", json, 0);
+}
+
+/**
+ * postJson
+ */
+QNetworkReply* RequestBuilder::postJson(const QByteArray &json) {
+    m_headers.insert(QNetworkRequest::ContentTypeHeader, "application/json");
+
+    return this->send("POST", json, 0);
+}
+
+/**
+ * deleteResource
+ */
+QNetworkReply* RequestBuilder::deleteResource() {
+    return this->send("DELETE", QByteArray(), 0);
+}
+
+QNetworkRequest RequestBuilder::prepare(const QByteArray &verb) {
+    if (!m_query.isEmpty()) {
+#if QT_VERSION >= 0x050000
+        QUrlQuery query(m_url);
+
+        for (int i = 0; i < m_query.size(); i++) {
+            query.addQueryItem(m_query.at(i).first, m_query.at(i).second);
+        }
+
+        m_url.setQuery(query);
+#else
+        for (int i = 0; i < m_query.size(); i++) {
+            m_url.addQueryItem(m_query.at(i).first, m_query.at(i).second);
+        }
+#endif
+        m_query.clear();
+    }
+
+    QNetworkRequest request(m_acceptJson ? requestTemplates()->json : requestTemplates()->data);
+    request.setUrl(m_url);
+    request.setPriority(QNetworkRequest::Priority(m_priority));
+
+    if (m_cacheable) {
+        request.setAttribute(QNetworkRequest::CacheSaveControlAttribute, true);
+    }
+
+    QMapIterator<int, QVariant> iterator(m_headers);
+
+    while (iterator.hasNext()) {
+        iterator.next();
+        request.setHeader(QNetworkRequest::KnownHeaders(iterator.key()), iterator.value());
+    }
+
+    for (int i = 0; i < m_rawHeaders.size(); i++) {
+        request.setRawHeader(m_rawHeaders.at(i).first, m_rawHeaders.at(i).second);
+    }
+
+    if (m_signing != Unsigned) {
+        request.setRawHeader("Authorization", effectiveSession(m_session)->getOAuthHeader(verb, this->signedUrl(), m_params));
+    }
+
+    return request;
+}
+
+/**
+ * Returns the URL as it is passed to the OAuth signer.
+ */
+QString RequestBuilder::signedUrl() const {
+    switch (m_signing) {
+    case SignPath:
+        return m_url.toString(QUrl::RemoveQuery);
+    case SignEncodedPath:
+        return QString::fromLatin1(m_url.toString(QUrl::RemoveQuery).toUtf8().toPercentEncoding(":/~_?="));
+    case SignUrl:
+        return m_url.toString();
+    default:
+        return QString();
+    }
+}
+
+/**
+ * Every request made by the library is sent from here.
+ */
+QNetworkReply* RequestBuilder::send(const QByteArray &verb, const QByteArray &data, QIODevice *device) {
+    const QNetworkRequest request = this->prepare(verb);
+    NetworkAccessManager *manager = NetworkAccessManager::instance();
+    QNetworkReply *reply;
+
+    if (verb == "GET") {
+        reply = manager->get(request);
+    }
+    else if (verb == "DELETE") {
+        reply = manager->deleteResource(request);
+    }
+    else if (verb == "POST") {
+        reply = device ? manager->post(request, device) : manager->post(request, data);
+    }
+    else {
+        reply = device ? manager->put(request, device) : manager->put(request, data);
+    }
+
+    // Retries, and requests that wait for a connection or a rate limit, need a new nonce and timestamp
+    if (m_signing != Unsigned) {
+        if (QueuedReply *queuedReply = qobject_cast<QueuedReply*>(reply)) {
+            queuedReply->setSigner(new OAuthSigner(effectiveSession(m_session), verb, this->signedUrl(), m_params));
+        }
+    }
+
+    return reply;
+}
+
+}
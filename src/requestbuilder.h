@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef REQUESTBUILDER_H
+#define REQUESTBUILDER_H
+
+#include <QNetworkRequest>
+#include <QMap>
+#include <QList>
+#include <QPair>
+
+class QNetworkReply;
+class QIODevice;
+
+namespace QtUbuntuOne {
+
+class Session;
+
+/**
+ * Prepares, signs and sends the requests made by the library.
+ *
+ * Each request starts from a shared template that already carries the
+ * constant headers, and is signed once, when it is sent. Every request
+ * goes out through send(), so timing, caching and scheduling only need
+ * to be added in one place.
+ */
+class RequestBuilder
+{
+
+public:
+    /**
+     * The order in which requests are sent when a host is busy.
+     * The values match NetworkSettings::Priority.
+     */
+    enum Priority {
+        Interactive = QNetworkRequest::HighPriority,   // Results the user is waiting to see
+        Normal = QNetworkRequest::NormalPriority,
+        Background = QNetworkRequest::LowPriority      // Transfers and other bulk work
+    };
+
+    /**
+     * How the request URL is passed to the OAuth signer.
+     */
+    enum Signing {
+        Unsigned = 0,
+        SignPath,        // The URL without the query, as is (music and account APIs)
+        SignEncodedPath, // The URL without the query, percent-encoded (file storage API)
+        SignUrl          // The whole URL, as is (artwork)
+    };
+
+    explicit RequestBuilder(const QUrl &url, Signing signing = SignPath, Session *session = 0);
+
+    RequestBuilder& addQueryItem(const QString &key, const QString &value);
+
+    RequestBuilder& setHeader(QNetworkRequest::KnownHeaders header, const QVariant &value);
+    RequestBuilder& setRawHeader(const QByteArray &name, const QByteArray &value);
+
+    // Requests whose replies are not JSON do not send Accept: application/json
+    RequestBuilder& setAcceptJson(bool accept);
+
+    RequestBuilder& setPriority(Priority priority);
+
+    // Cacheable GET responses are kept in the response cache and revalidated using their ETag
+    RequestBuilder& setCacheable(bool cacheable);
+
+    QNetworkReply* get();
+    QNetworkReply* put(const QByteArray &data = QByteArray());
+    QNetworkReply* put(QIODevice *device);
+    QNetworkReply* putJson(const QByteArray &json);
+    QNetworkReply* postJson(const QByteArray &json);
+    QNetworkReply* deleteResource();
+
+private:
+    QNetworkRequest prepare(const QByteArray &verb);
+
+    QString signedUrl() const;
+
+    QNetworkReply* send(const QByteArray &verb, const QByteArray &data, QIODevice *device);
+
+    QUrl m_url;
+    Signing m_signing;
+    Session *m_session;
+    bool m_acceptJson;
+    Priority m_priority;
+    bool m_cacheable;
+    QList<QPair<QString, QString> > m_query;
+    QMap<QString, QString> m_params;
+    QList<QPair<QByteArray, QByteArray> > m_rawHeaders;
+    QMap<int, QVariant> m_headers;
+};
+
+}
+
+#endif // REQUESTBUILDER_H
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * \file session.cpp
+ */
+
+#include "session.h"
+#include "session_p.h"
+
+namespace QtUbuntuOne {
+
+Q_GLOBAL_STATIC(Session, defaultSessionInstance)
+
+Session::Session(QObject *parent) :
+    QObject(parent),
+    d_ptr(new SessionPrivate(this))
+{
+}
+
+Session::Session(const QString &consumerKey,
+                 const QString &consumerSecret,
+                 const QString &tokenKey,
+                 const QString &tokenSecret,
+                 QObject *parent) :
+    QObject(parent),
+    d_ptr(new SessionPrivate(this))
+{
+    this->setCredentials(consumerKey, consumerSecret, tokenKey, tokenSecret);
+}
+
+Session::~Session() {}
+
+/**
+ * defaultSession
+ */
+Session* Session::defaultSession() {
+    return defaultSessionInstance();
+}
+
+/**
+ * consumerKey
+ */
+QString Session::consumerKey() const {
+    Q_D(const Session);
+    QMutexLocker locker(&d->m_mutex);
+
+    return d->m_consumerKey;
+}
+
+/**
+ * setConsumerKey
+ */
+void Session::setConsumerKey(const QString &key) {
+    Q_D(Session);
+    QMutexLocker locker(&d->m_mutex);
+    d->m_consumerKey = key;
+    d->updateBuilder();
+}
+
+/**
+ * consumerSecret
+ */
+QString Session::consumerSecret() const {
+    Q_D(const Session);
+    QMutexLocker locker(&d->m_mutex);
+
+    return d->m_consumerSecret;
+}
+
+/**
+ * setConsumerSecret
+ */
+void Session::setConsumerSecret(const QString &secret) {
+    Q_D(Session);
+    QMutexLocker locker(&d->m_mutex);
+    d->m_consumerSecret = secret;
+    d->updateBuilder();
+}
+
+/**
+ * tokenKey
+ */
+QString Session::tokenKey() const {
+    Q_D(const Session);
+    QMutexLocker locker(&d->m_mutex);
+
+    return d->m_tokenKey;
+}
+
+/**
+ * setTokenKey
+ */
+void Session::setTokenKey(const QString &key) {
+    Q_D(Session);
+    QMutexLocker locker(&d->m_mutex);
+    d->m_tokenKey = key;
+    d->updateBuilder();
+}
+
+/**
+ * tokenSecret
+ */
+QString Session::tokenSecret() const {
+    Q_D(const Session);
+    QMutexLocker locker(&d->m_mutex);
+
+    return d->m_tokenSecret;
+}
+
+/**
+ * setTokenSecret
+ */
+void Session::setTokenSecret(const QString &secret) {
+    Q_D(Session);
+    QMutexLocker locker(&d->m_mutex);
+    d->m_tokenSecret = secret;
+    d->updateBuilder();
+}
+
+/**
+ * setCredentials
+ */
+void Session::setCredentials(const QString &consumerKey,
+                             const QString &consumerSecret,
+                             const QString &tokenKey,
+                             const QString &tokenSecret) {
+
+    Q_D(Session);
+    QMutexLocker locker(&d->m_mutex);
+    d->m_consumerKey = consumerKey;
+    d->m_consumerSecret = consumerSecret;
+    d->m_tokenKey = tokenKey;
+    d->m_tokenSecret = tokenSecret;
+    d->updateBuilder();
+}
+
+/**
+ * clearCredentials
+ */
+void Session::clearCredentials() {
+    this->setCredentials(QString(), QString(), QString(), QString());
+}
+
+/**
+ * getOAuthHeader
+ */
+QByteArray Session::getOAuthHeader(const QString &method, const QString &url, const QMap<QString, QString> &params) const {
+    Q_D(const Session);
+    QMutexLocker locker(&d->m_mutex);
+
+    return d->m_builder.build(method, url, params);
+}
+
+/**
+ * getOAuthHeaders
+ */
+QList<QByteArray> Session::getOAuthHeaders(const QString &method, const QStringList &urls, const QMap<QString, QString> &params) const {
+    Q_D(const Session);
+    QMutexLocker locker(&d->m_mutex);
+
+    return d->m_builder.buildBatch(method, urls, params);
+}
+
+}
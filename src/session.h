@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * \file session.h
+ */
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "qubuntuone_global.h"
+#include <QObject>
+#include <QMap>
+#include <QStringList>
+
+namespace QtUbuntuOne {
+
+class SessionPrivate;
+
+/**
+ * \class Session
+ * \brief Holds the OAuth credentials of one Ubuntu One account.
+ *
+ * Session holds the OAuth credentials used for signing requests on behalf of one account,
+ * so that a single process can make requests for several accounts at once.
+ * Each of the request methods of Files, Music and Account takes an optional Session.
+ * If no session is given, the default session is used. The credentials set using
+ * the static methods of Authentication are those of the default session.
+ *
+ * The methods of Session are thread-safe.
+ */
+class QUBUNTUONESHARED_EXPORT Session : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QString consumerKey
+               READ consumerKey
+               WRITE setConsumerKey)
+    Q_PROPERTY(QString consumerSecret
+               READ consumerSecret
+               WRITE setConsumerSecret)
+    Q_PROPERTY(QString tokenKey
+               READ tokenKey
+               WRITE setTokenKey)
+    Q_PROPERTY(QString tokenSecret
+               READ tokenSecret
+               WRITE setTokenSecret)
+
+public:
+    explicit Session(QObject *parent = 0);
+    explicit Session(const QString &consumerKey,
+                     const QString &consumerSecret,
+                     const QString &tokenKey,
+                     const QString &tokenSecret,
+                     QObject *parent = 0);
+    ~Session();
+
+    /**
+     * Returns the default session, used when no session is passed to a request method.
+     *
+     * \return Session* The default session.
+     */
+    static Session* defaultSession();
+
+    /**
+     * Returns the OAuth consumer key used for signing requests to the Ubuntu One API.
+     *
+     * \return QString The consumer key.
+     */
+    QString consumerKey() const;
+
+    /**
+     * Sets the OAuth consumer key used for signing requests to the Ubuntu One API.
+     *
+     * \param key The consumer key.
+     */
+    void setConsumerKey(const QString &key);
+
+    /**
+     * Returns the OAuth consumer secret used for signing requests to the Ubuntu One API.
+     *
+     * \return QString The consumer secret.
+     */
+    QString consumerSecret() const;
+
+    /**
+     * Sets the OAuth consumer secret used for signing requests to the Ubuntu One API.
+     *
+     * \param secret The consumer secret.
+     */
+    void setConsumerSecret(const QString &secret);
+
+    /**
+     * Returns the OAuth token key used for signing requests to the Ubuntu One API.
+     *
+     * \return QString The token key.
+     */
+    QString tokenKey() const;
+
+    /**
+     * Sets the OAuth token key used for signing requests to the Ubuntu One API.
+     *
+     * \param key The token key.
+     */
+    void setTokenKey(const QString &key);
+
+    /**
+     * Returns the OAuth token secret used for signing requests to the Ubuntu One API.
+     *
+     * \return QString The token secret.
+     */
+    QString tokenSecret() const;
+
+    /**
+     * Sets the OAuth token secret used for signing requests to the Ubuntu One API.
+     *
+     * \param secret The token secret.
+     */
+    void setTokenSecret(const QString &secret);
+
+    /**
+     * A convenience method that sets the OAuth credentials used for signing requests to the Ubuntu One API.
+     *
+     * \param consumerKey The consumer key.
+     * \param consumerSecret The consumer secret.
+     * \param tokenKey The token key.
+     * \param tokenSecret The token secret.
+     */
+    Q_INVOKABLE void setCredentials(const QString &consumerKey,
+                                    const QString &consumerSecret,
+                                    const QString &tokenKey,
+                                    const QString &tokenSecret);
+
+    /**
+     * A convenience method that sets each of the OAuth credentials to an empty string.
+     */
+    Q_INVOKABLE void clearCredentials();
+
+    /**
+     * Returns an OAuth Authorization header, signed with the credentials of this session.
+     *
+     * \param method The HTTP method to be used for the request.
+     * \param url The URL to be used for the request.
+     * \param params A map of the paramaters to be used for the request.
+     *
+     * \return QByteArray The OAuth Authorization header.
+     */
+    Q_INVOKABLE QByteArray getOAuthHeader(const QString &method, const QString &url, const QMap<QString, QString> &params) const;
+
+    /**
+     * Returns one OAuth Authorization header for each of the URLs, signed with the credentials of this session.
+     * This is cheaper than calling getOAuthHeader() for each URL when issuing many requests at once.
+     *
+     * \param method The HTTP method to be used for the requests.
+     * \param urls The URLs to be used for the requests.
+     * \param params A map of the paramaters to be used for every request.
+     *
+     * \return QList<QByteArray> The OAuth Authorization headers, in the order of the URLs.
+     */
+    Q_INVOKABLE QList<QByteArray> getOAuthHeaders(const QString &method, const QStringList &urls, const QMap<QString, QString> &params) const;
+
+private:
+    QScopedPointer<SessionPrivate> d_ptr;
+
+    Q_DECLARE_PRIVATE(Session)
+};
+
+}
+
+#endif // SESSION_H
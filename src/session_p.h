@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SESSION_P_H
+#define SESSION_P_H
+
+#include "session.h"
+#include "oauth.h"
+#include <QMutex>
+
+namespace QtUbuntuOne {
+
+class SessionPrivate
+{
+
+public:
+    SessionPrivate(Session *parent) :
+        q_ptr(parent)
+    {
+    }
+
+    virtual ~SessionPrivate() {}
+
+    // Callers hold m_mutex
+    inline void updateBuilder() { m_builder.setCredentials(m_consumerKey, m_consumerSecret, m_tokenKey, m_tokenSecret); }
+
+    Session *q_ptr;
+
+    mutable QMutex m_mutex;
+
+    QString m_consumerKey;
+    QString m_consumerSecret;
+    QString m_tokenKey;
+    QString m_tokenSecret;
+
+    mutable QtOAuth::HeaderBuilder m_builder;
+
+    Q_DECLARE_PUBLIC(Session)
+};
+
+// Returns session, or the default session if session is 0
+inline Session* effectiveSession(Session *session) { return session ? session : Session::defaultSession(); }
+
+}
+
+#endif // SESSION_P_H
@@ -20,6 +20,55 @@
 
 namespace QtUbuntuOne {
 
+static const char * const SONG_KEYS[] = {
+    "id",
+    "title",
+    "artist",
+    "artist_id",
+    "album",
+    "album_artist",
+    "album_id",
+    "genre",
+    "path",
+    "suffix",
+    "content_type",
+    "song_url",
+    "song_art_url",
+    "song_stream_url",
+    "year",
+    "track",
+    "disc_number",
+    "bit_rate",
+    "duration",
+    "size"
+};
+
+enum SongKeys {
+    IdKey = 0,
+    TitleKey,
+    ArtistKey,
+    ArtistIdKey,
+    AlbumKey,
+    AlbumArtistKey,
+    AlbumIdKey,
+    GenreKey,
+    PathKey,
+    SuffixKey,
+    ContentTypeKey,
+    SongUrlKey,
+    SongArtUrlKey,
+    SongStreamUrlKey,
+    YearKey,
+    TrackKey,
+    DiscNumberKey,
+    BitRateKey,
+    DurationKey,
+    SizeKey,
+    SongKeyCount
+};
+
+Q_GLOBAL_STATIC_WITH_ARGS(QtJson::JsonKeyTable, songKeyTable, (SONG_KEYS, SongKeyCount))
+
 SongPrivate::SongPrivate(Song *parent) :
     q_ptr(parent),
     m_year(1970),
@@ -89,29 +138,108 @@ void SongPrivate::loadSong(Song *otherSong) {
 }
 
 void SongPrivate::loadSong(const QVariantMap &song) {
+    this->beginLoad();
+
+    for (QVariantMap::const_iterator iterator = song.constBegin(); iterator != song.constEnd(); ++iterator) {
+        this->loadProperty(iterator.key(), iterator.value());
+    }
+
+    this->endLoad();
+}
+
+void SongPrivate::beginLoad() {
+    this->setId(QString());
+    this->setTitle(QString());
+    this->setArtist(QString());
+    this->setArtistId(QString());
+    this->setAlbumTitle(QString());
+    this->setAlbumArtist(QString());
+    this->setAlbumId(QString());
+    this->setGenre(QString());
+    this->setFilePath(QString());
+    this->setFileSuffix(QString());
+    this->setMimeType(QString());
+    this->setUrl(QUrl());
+    this->setArtworkUrl(QUrl());
+    this->setStreamUrl(QUrl());
+    this->setYear(0);
+    this->setTrackNumber(0);
+    this->setDiscNumber(0);
+    this->setBitRate(0);
+    this->setDuration(0);
+    this->setSize(0);
+}
+
+void SongPrivate::loadProperty(const QString &key, const QVariant &value) {
+    switch (songKeyTable()->indexOf(key)) {
+    case IdKey:
+        this->setId(value.toString());
+        break;
+    case TitleKey:
+        this->setTitle(value.toString());
+        break;
+    case ArtistKey:
+        this->setArtist(value.toString());
+        break;
+    case ArtistIdKey:
+        this->setArtistId(value.toString());
+        break;
+    case AlbumKey:
+        this->setAlbumTitle(value.toString());
+        break;
+    case AlbumArtistKey:
+        this->setAlbumArtist(value.toString());
+        break;
+    case AlbumIdKey:
+        this->setAlbumId(value.toString());
+        break;
+    case GenreKey:
+        this->setGenre(value.toString());
+        break;
+    case PathKey:
+        this->setFilePath(value.toString());
+        break;
+    case SuffixKey:
+        this->setFileSuffix(value.toString());
+        break;
+    case ContentTypeKey:
+        this->setMimeType(value.toString());
+        break;
+    case SongUrlKey:
+        this->setUrl(value.toUrl());
+        break;
+    case SongArtUrlKey:
+        this->setArtworkUrl(value.toUrl());
+        break;
+    case SongStreamUrlKey:
+        this->setStreamUrl(value.toUrl());
+        break;
+    case YearKey:
+        this->setYear(value.toInt());
+        break;
+    case TrackKey:
+        this->setTrackNumber(value.toInt());
+        break;
+    case DiscNumberKey:
+        this->setDiscNumber(value.toInt());
+        break;
+    case BitRateKey:
+        this->setBitRate(value.toInt());
+        break;
+    case DurationKey:
+        this->setDuration(value.toLongLong());
+        break;
+    case SizeKey:
+        this->setSize(value.toLongLong());
+        break;
+    default:
+        break;
+    }
+}
+
+void SongPrivate::endLoad() {
     Q_Q(Song);
 
-    this->setId(song.value("id").toString());
-    this->setTitle(song.value("title").toString());
-    this->setArtist(song.value("artist").toString());
-    this->setArtistId(song.value("artist_id").toString());
-    this->setAlbumTitle(song.value("album").toString());
-    this->setAlbumArtist(song.value("album_artist").toString());
-    this->setAlbumId(song.value("album_id").toString());
-    this->setGenre(song.value("genre").toString());
-    this->setFilePath(song.value("path").toString());
-    this->setFileSuffix(song.value("suffix").toString());
-    this->setMimeType(song.value("content_type").toString());
-    this->setUrl(song.value("song_url").toUrl());
-    this->setArtworkUrl(song.value("song_art_url").toUrl());
-    this->setStreamUrl(song.value("song_stream_url").toUrl());
-    this->setYear(song.value("year").toInt());
-    this->setTrackNumber(song.value("track").toInt());
-    this->setDiscNumber(song.value("disc_number").toInt());
-    this->setBitRate(song.value("bit_rate").toInt());
-    this->setDuration(song.value("duration").toLongLong());
-    this->setSize(song.value("size").toLongLong());
-
     emit q->ready(q);
 }
 
@@ -33,6 +33,10 @@ public:
     void loadSong(Song *otherSong);
     void loadSong(const QVariantMap &song);
 
+    void beginLoad();
+    void loadProperty(const QString &key, const QVariant &value);
+    void endLoad();
+
     QString id() const;
 
     QString title() const;
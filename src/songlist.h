@@ -137,6 +137,17 @@ signals:
      */
     void ready(SongList *list);
 
+    /**
+     * Emitted when new songs have been parsed from the response, before the request is completed.
+     *
+     * The songs from index \a first to index \a last (inclusive) are available via songs().
+     *
+     * \param list The SongList object.
+     * \param first The index of the first new item.
+     * \param last The index of the last new item.
+     */
+    void itemsAvailable(SongList *list, int first, int last);
+
     /**
      * Emitted when the request is cancelled.
      *
@@ -152,6 +163,7 @@ private:
 
     Q_DECLARE_PRIVATE(SongList)
 
+    Q_PRIVATE_SLOT(d_func(), void _q_onReplyReadyRead())
     Q_PRIVATE_SLOT(d_func(), void _q_onReplyFinished())
 };
 
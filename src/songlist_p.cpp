@@ -17,18 +17,22 @@
 
 #include "songlist_p.h"
 #include "song_p.h"
-#include "json.h"
 
 namespace QtUbuntuOne {
 
 SongListPrivate::SongListPrivate(QNetworkReply *reply, SongList *parent) :
+    QtJson::JsonArrayReader(QStringList() << "response" << "songs"),
     q_ptr(parent),
     m_reply(reply),
+    m_parser(this),
+    m_currentSong(0),
+    m_reported(0),
     m_error(SongList::NoError)
 {
     Q_Q(SongList);
 
     if (m_reply) {
+        q->connect(m_reply, SIGNAL(readyRead()), q, SLOT(_q_onReplyReadyRead()));
         q->connect(m_reply, SIGNAL(finished()), q, SLOT(_q_onReplyFinished()));
     }
 }
@@ -38,6 +42,11 @@ SongListPrivate::~SongListPrivate() {
         delete m_reply;
         m_reply = 0;
     }
+
+    if (m_currentSong) {
+        delete m_currentSong;
+        m_currentSong = 0;
+    }
 }
 
 int SongListPrivate::count() const {
@@ -64,16 +73,35 @@ void SongListPrivate::setErrorString(const QString &errorstring) {
     m_errorString = errorstring;
 }
 
-void SongListPrivate::loadSongs(const QVariantList &songs) {
+void SongListPrivate::readItem(const QVariant &item) {
+    Song *s = new Song;
+    s->d_func()->loadSong(item.toMap());
+    m_songs.append(s);
+}
+
+void SongListPrivate::beginItem() {
+    m_currentSong = new Song;
+    m_currentSong->d_func()->beginLoad();
+}
+
+void SongListPrivate::readItemValue(const QString &key, const QVariant &value) {
+    m_currentSong->d_func()->loadProperty(key, value);
+}
+
+void SongListPrivate::endItem() {
+    m_currentSong->d_func()->endLoad();
+    m_songs.append(m_currentSong);
+    m_currentSong = 0;
+}
+
+void SongListPrivate::reportItems() {
     Q_Q(SongList);
 
-    foreach (QVariant song, songs) {
-        Song *s = new Song;
-        s->d_func()->loadSong(song.toMap());
-        m_songs.append(s);
+    if (m_songs.size() > m_reported) {
+        int first = m_reported;
+        m_reported = m_songs.size();
+        emit q->itemsAvailable(q, first, m_reported - 1);
     }
-
-    emit q->ready(q);
 }
 
 void SongListPrivate::cancel() {
@@ -82,6 +110,18 @@ void SongListPrivate::cancel() {
     }
 }
 
+void SongListPrivate::_q_onReplyReadyRead() {
+    if ((m_reply) && (!m_parser.hasError())) {
+        int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+        // Parse successful responses as they arrive
+        if ((status >= 200) && (status < 300)) {
+            m_parser.feed(m_reply->readAll());
+            this->reportItems();
+        }
+    }
+}
+
 void SongListPrivate::_q_onReplyFinished() {
     Q_Q(SongList);
 
@@ -99,23 +139,17 @@ void SongListPrivate::_q_onReplyFinished() {
             return;
         }
 
-        QString response(m_reply->readAll());
-        QVariant result = QtJson::Json::parse(response);
+        m_parser.feed(m_reply->readAll());
 
-        switch (result.type()) {
-        case QVariant::Map:
-            this->loadSongs(result.toMap().value("response").toMap().value("songs").toList());
-            break;
-        case QVariant::List:
-            this->loadSongs(result.toList());
-            break;
-        default:
+        if ((!m_parser.finish()) || (!this->isValid())) {
             this->setError(SongList::ParserError);
             this->setErrorString(QObject::tr("Cannot parse server response"));
-            emit q->ready(q);
-            break;
         }
 
+        this->reportItems();
+
+        emit q->ready(q);
+
         m_reply->deleteLater();
         m_reply = 0;
     }
@@ -19,10 +19,11 @@
 #define SONGLIST_P_H
 
 #include "songlist.h"
+#include "json.h"
 
 namespace QtUbuntuOne {
 
-class SongListPrivate
+class SongListPrivate : public QtJson::JsonArrayReader
 {
 
 public:
@@ -42,15 +43,24 @@ private:
     void setError(SongList::Error error);
     void setErrorString(const QString &errorstring);
 
-    void loadSongs(const QVariantList &songs);
+    void readItem(const QVariant &item);
+    void beginItem();
+    void readItemValue(const QString &key, const QVariant &value);
+    void endItem();
+    void reportItems();
 
+    void _q_onReplyReadyRead();
     void _q_onReplyFinished();
 
     SongList *q_ptr;
 
     QNetworkReply *m_reply;
 
+    QtJson::JsonStreamParser m_parser;
+
     QList<Song*> m_songs;
+    Song *m_currentSong;
+    int m_reported;
 
     SongList::Error m_error;
     QString m_errorString;
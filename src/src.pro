@@ -30,16 +30,24 @@ SOURCES += \
     artwork.cpp \
     artwork_p.cpp \
     authentication.cpp \
+    directorywalker.cpp \
+    directorywalker_p.cpp \
+    diskcache.cpp \
     files.cpp \
     filetransfer.cpp \
     filetransfer_p.cpp \
     json.cpp \
+    memorycache.cpp \
     music.cpp \
     musicstream.cpp \
     musicstream_p.cpp \
     networkaccessmanager.cpp \
+    networksettings.cpp \
     node.cpp \
     node_p.cpp \
+    nodecache.cpp \
+    nodeindex.cpp \
+    nodeindex_p.cpp \
     nodelist.cpp \
     nodelist_p.cpp \
     oauth.cpp \
@@ -47,12 +55,17 @@ SOURCES += \
     playlist_p.cpp \
     playlistlist.cpp \
     playlistlist_p.cpp \
+    queuedreply.cpp \
     reply.cpp \
+    requestbuilder.cpp \
+    session.cpp \
     song.cpp \
     song_p.cpp \
     songlist.cpp \
     songlist_p.cpp \
     storagequota.cpp \
+    syncengine.cpp \
+    syncengine_p.cpp \
     token.cpp \
     user.cpp \
     user_p.cpp \
@@ -72,17 +85,24 @@ HEADERS += \
     artwork.h \
     artwork_p.h \
     authentication.h \
-    authentication_p.h \
+    directorywalker.h \
+    directorywalker_p.h \
+    diskcache.h \
     files.h \
     filetransfer.h \
     filetransfer_p.h \
     json.h \
+    memorycache.h \
     music.h \
     musicstream.h \
     musicstream_p.h \
     networkaccessmanager.h \
+    networksettings.h \
     node.h \
     node_p.h \
+    nodecache.h \
+    nodeindex.h \
+    nodeindex_p.h \
     nodelist.h \
     nodelist_p.h \
     oauth.h \
@@ -90,15 +110,21 @@ HEADERS += \
     playlist_p.h \
     playlistlist.h \
     playlistlist_p.h \
+    queuedreply.h \
     qubuntuone_global.h \
     reply.h \
     reply_p.h \
+    requestbuilder.h \
+    session.h \
+    session_p.h \
     song.h \
     song_p.h \
     songlist.h \
     songlist_p.h \
     storagequota.h \
     storagequota_p.h \
+    syncengine.h \
+    syncengine_p.h \
     token.h \
     token_p.h \
     urls.h \
@@ -115,20 +141,27 @@ headers.files = \
     artistlist.h \
     artwork.h \
     authentication.h \
+    directorywalker.h \
+    diskcache.h \
     files.h \
     filetransfer.h \
+    memorycache.h \
     music.h \
     musicstream.h \
+    networksettings.h \
     node.h \
+    nodeindex.h \
     nodelist.h \
     playlist.h \
     playlistlist.h \
     qubuntuone_global.h \
     reply.h \
     replyerror.h \
+    session.h \
     song.h \
     songlist.h \
     storagequota.h \
+    syncengine.h \
     token.h \
     user.h \
     useraccount.h
@@ -85,7 +85,7 @@ private:
             }
 
             bool ok;
-            QString response(m_reply->readAll());
+            QByteArray response(m_reply->readAll());
             QVariantMap result = QtJson::Json::parse(response, ok).toMap();
 
             if (ok) {
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * \file syncengine.cpp
+ */
+
+#include "syncengine.h"
+#include "syncengine_p.h"
+
+namespace QtUbuntuOne {
+
+SyncEngine::SyncEngine(QObject *parent) :
+    QObject(parent),
+    d_ptr(new SyncEnginePrivate(this))
+{
+}
+
+SyncEngine::SyncEngine(const QString &volumePath, QObject *parent) :
+    QObject(parent),
+    d_ptr(new SyncEnginePrivate(volumePath, this))
+{
+}
+
+SyncEngine::SyncEngine(SyncEnginePrivate &d, QObject *parent) :
+    QObject(parent),
+    d_ptr(&d)
+{
+}
+
+SyncEngine::~SyncEngine() {}
+
+/**
+ * volumePath
+ */
+QString SyncEngine::volumePath() const {
+    Q_D(const SyncEngine);
+
+    return d->volumePath();
+}
+
+/**
+ * setVolumePath
+ */
+void SyncEngine::setVolumePath(const QString &path) {
+    Q_D(SyncEngine);
+
+    d->setVolumePath(path);
+}
+
+/**
+ * generation
+ */
+int SyncEngine::generation() const {
+    Q_D(const SyncEngine);
+
+    return d->generation();
+}
+
+/**
+ * nodeIndex
+ */
+NodeIndex* SyncEngine::nodeIndex() const {
+    Q_D(const SyncEngine);
+
+    return d->nodeIndex();
+}
+
+/**
+ * setNodeIndex
+ */
+void SyncEngine::setNodeIndex(NodeIndex *index) {
+    Q_D(SyncEngine);
+
+    d->setNodeIndex(index);
+}
+
+/**
+ * count
+ */
+int SyncEngine::count() const {
+    Q_D(const SyncEngine);
+
+    return d->count();
+}
+
+/**
+ * maximumConcurrentRequests
+ */
+int SyncEngine::maximumConcurrentRequests() const {
+    Q_D(const SyncEngine);
+
+    return d->maximumConcurrentRequests();
+}
+
+/**
+ * setMaximumConcurrentRequests
+ */
+void SyncEngine::setMaximumConcurrentRequests(int maximum) {
+    Q_D(SyncEngine);
+
+    d->setMaximumConcurrentRequests(maximum);
+}
+
+/**
+ * session
+ */
+Session* SyncEngine::session() const {
+    Q_D(const SyncEngine);
+
+    return d->session();
+}
+
+/**
+ * setSession
+ */
+void SyncEngine::setSession(Session *session) {
+    Q_D(SyncEngine);
+
+    d->setSession(session);
+}
+
+/**
+ * status
+ */
+SyncEngine::Status SyncEngine::status() const {
+    Q_D(const SyncEngine);
+
+    return d->status();
+}
+
+/**
+ * errorString
+ */
+QString SyncEngine::errorString() const {
+    Q_D(const SyncEngine);
+
+    return d->errorString();
+}
+
+/**
+ * sync
+ */
+void SyncEngine::sync() {
+    Q_D(SyncEngine);
+
+    d->sync();
+}
+
+/**
+ * cancel
+ */
+void SyncEngine::cancel() {
+    Q_D(SyncEngine);
+
+    d->cancel();
+}
+
+/**
+ * reset
+ */
+void SyncEngine::reset() {
+    Q_D(SyncEngine);
+
+    d->reset();
+}
+
+#include "moc_syncengine.cpp"
+
+}
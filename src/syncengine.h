@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/**
+ * \file syncengine.h
+ */
+
+#ifndef SYNCENGINE_H
+#define SYNCENGINE_H
+
+#include "qubuntuone_global.h"
+#include <QObject>
+
+namespace QtUbuntuOne {
+
+class Node;
+class NodeIndex;
+class Session;
+class SyncEnginePrivate;
+
+/**
+ * \class SyncEngine
+ * \brief Detects changes to the contents of a volume.
+ *
+ * SyncEngine keeps an index of the generation of each node in a volume,
+ * and reports the nodes that have been added, changed or removed since
+ * the last call to sync().
+ *
+ * The volume generation is requested first, so a sync of an unchanged
+ * volume costs a single request. Otherwise, the directories of the volume
+ * are walked by a DirectoryWalker and the generation of each node is
+ * compared with the indexed generation.
+ */
+class QUBUNTUONESHARED_EXPORT SyncEngine : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QString volumePath
+               READ volumePath
+               WRITE setVolumePath)
+    Q_PROPERTY(int generation
+               READ generation)
+    Q_PROPERTY(int count
+               READ count)
+    Q_PROPERTY(int maximumConcurrentRequests
+               READ maximumConcurrentRequests
+               WRITE setMaximumConcurrentRequests)
+    Q_PROPERTY(Status status
+               READ status
+               NOTIFY statusChanged)
+    Q_PROPERTY(QString errorString
+               READ errorString
+               NOTIFY statusChanged)
+
+    Q_ENUMS(Status)
+
+public:
+    /**
+     * \enum Status
+     */
+    enum Status {
+        Idle = 0,
+        Syncing,
+        Completed,
+        Cancelled,
+        Failed
+    };
+
+    explicit SyncEngine(QObject *parent = 0);
+    explicit SyncEngine(const QString &volumePath, QObject *parent = 0);
+    ~SyncEngine();
+
+    /**
+     * Returns the resource path of the volume to be synced.
+     *
+     * \return QString
+     */
+    QString volumePath() const;
+
+    /**
+     * Sets the resource path of the volume to be synced, e.g. '/volumes/~/Ubuntu One'.
+     * Changing the volume path cancels any sync in progress. Nodes indexed for
+     * another volume are discarded from the index.
+     *
+     * \param QString
+     */
+    void setVolumePath(const QString &path);
+
+    /**
+     * Returns the volume generation at the last completed sync,
+     * or 0 if the volume has not been synced.
+     *
+     * \return int
+     */
+    int generation() const;
+
+    /**
+     * Returns the index of node generations. By default, the index
+     * is kept in memory and belongs to the SyncEngine.
+     *
+     * \return NodeIndex*
+     */
+    NodeIndex* nodeIndex() const;
+
+    /**
+     * Sets the index of node generations. The index must outlive the SyncEngine.
+     * Pass 0 to use an index kept in memory.
+     *
+     * A NodeIndex that has been loaded from disk lets the first sync after a restart
+     * report only the changes since the index was last written. The volume path and the
+     * token key of the session are recorded in the index, and an index written for another
+     * volume or account is not used.
+     *
+     * \param NodeIndex*
+     */
+    void setNodeIndex(NodeIndex *index);
+
+    /**
+     * Returns the number of indexed nodes.
+     *
+     * \return int
+     */
+    int count() const;
+
+    /**
+     * Returns the maximum number of directory listings
+     * that are requested concurrently. The default is 4.
+     *
+     * \return int
+     */
+    int maximumConcurrentRequests() const;
+
+    /**
+     * Sets the maximum number of directory listings
+     * that are requested concurrently.
+     *
+     * \param int
+     */
+    void setMaximumConcurrentRequests(int maximum);
+
+    /**
+     * Returns the session whose credentials sign the sync requests,
+     * or 0 if the default session is used.
+     *
+     * \return Session*
+     */
+    Session* session() const;
+
+    /**
+     * Sets the session whose credentials sign the sync requests.
+     * The session must outlive the sync. Pass 0 to use the default session.
+     * Changing the session cancels any sync in progress. Nodes indexed for
+     * another account are discarded from the index.
+     *
+     * \param Session*
+     */
+    void setSession(Session *session);
+
+    /**
+     * Returns the current status of the sync.
+     *
+     * \return Status
+     */
+    Status status() const;
+
+    /**
+     * Returns the error string resulting from the sync.
+     *
+     * \return QString
+     */
+    QString errorString() const;
+
+public slots:
+    /**
+     * Starts a sync of the volume. The first sync reports
+     * every node in the volume as added.
+     */
+    void sync();
+
+    /**
+     * Cancels the sync. Changes that have already
+     * been reported remain in the index.
+     */
+    void cancel();
+
+    /**
+     * Cancels any sync in progress and clears the index.
+     */
+    void reset();
+
+signals:
+    /**
+     * Emitted when a node that is not in the index is found.
+     *
+     * The node is owned by the SyncEngine and may be deleted once control
+     * returns to the event loop, so it should be copied if it is needed later.
+     *
+     * \param node The Node object.
+     */
+    void nodeAdded(Node *node);
+
+    /**
+     * Emitted when a node with a newer generation than the indexed generation is found.
+     *
+     * The node is owned by the SyncEngine and may be deleted once control
+     * returns to the event loop, so it should be copied if it is needed later.
+     *
+     * \param node The Node object.
+     */
+    void nodeChanged(Node *node);
+
+    /**
+     * Emitted when an indexed node is no longer found in the volume.
+     *
+     * \param resourcePath The resource path of the removed node.
+     */
+    void nodeRemoved(const QString &resourcePath);
+
+    void statusChanged(SyncEngine::Status status);
+
+private:
+    explicit SyncEngine(SyncEnginePrivate &d, QObject *parent = 0);
+
+    QScopedPointer<SyncEnginePrivate> d_ptr;
+
+    Q_DECLARE_PRIVATE(SyncEngine)
+
+    Q_PRIVATE_SLOT(d_func(), void _q_onVolumeReady(Node* node))
+    Q_PRIVATE_SLOT(d_func(), void _q_onNodeFound(Node* node))
+    Q_PRIVATE_SLOT(d_func(), void _q_onWalkerStatusChanged())
+};
+
+}
+
+Q_DECLARE_METATYPE(QtUbuntuOne::SyncEngine::Status)
+
+#endif // SYNCENGINE_H
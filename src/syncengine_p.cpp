@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "syncengine_p.h"
+#include "files.h"
+#include "node.h"
+#include "nodeindex.h"
+#include "session_p.h"
+
+namespace QtUbuntuOne {
+
+SyncEnginePrivate::SyncEnginePrivate(SyncEngine *parent) :
+    q_ptr(parent),
+    m_volumeGeneration(0),
+    m_session(0),
+    m_status(SyncEngine::Idle),
+    m_index(new NodeIndex(parent)),
+    m_walker(new DirectoryWalker(parent))
+{
+    Q_Q(SyncEngine);
+
+    q->connect(m_walker, SIGNAL(nodeFound(Node*,int)), q, SLOT(_q_onNodeFound(Node*)));
+    q->connect(m_walker, SIGNAL(statusChanged(DirectoryWalker::Status)), q, SLOT(_q_onWalkerStatusChanged()));
+}
+
+SyncEnginePrivate::SyncEnginePrivate(const QString &volumePath, SyncEngine *parent) :
+    q_ptr(parent),
+    m_volumePath(volumePath),
+    m_volumeGeneration(0),
+    m_session(0),
+    m_status(SyncEngine::Idle),
+    m_index(new NodeIndex(parent)),
+    m_walker(new DirectoryWalker(parent))
+{
+    Q_Q(SyncEngine);
+
+    q->connect(m_walker, SIGNAL(nodeFound(Node*,int)), q, SLOT(_q_onNodeFound(Node*)));
+    q->connect(m_walker, SIGNAL(statusChanged(DirectoryWalker::Status)), q, SLOT(_q_onWalkerStatusChanged()));
+
+    this->updateIndexIdentity();
+}
+
+SyncEnginePrivate::~SyncEnginePrivate() {
+    // The walker is deleted with the SyncEngine, and must not report back while it is being destroyed
+    m_walker->disconnect(q_ptr);
+    this->abortRequests();
+}
+
+QString SyncEnginePrivate::volumePath() const {
+    return m_volumePath;
+}
+
+void SyncEnginePrivate::setVolumePath(const QString &path) {
+    if (path != this->volumePath()) {
+        this->stop();
+        m_volumePath = path;
+        this->updateIndexIdentity();
+    }
+}
+
+int SyncEnginePrivate::generation() const {
+    return m_index->generation();
+}
+
+NodeIndex* SyncEnginePrivate::nodeIndex() const {
+    return m_index;
+}
+
+void SyncEnginePrivate::setNodeIndex(NodeIndex *index) {
+    Q_Q(SyncEngine);
+
+    if ((index) && (index == this->nodeIndex())) {
+        return;
+    }
+
+    this->cancel();
+
+    if (m_index->parent() == q) {
+        delete m_index;
+    }
+
+    m_index = index ? index : new NodeIndex(q);
+    this->updateIndexIdentity();
+}
+
+int SyncEnginePrivate::count() const {
+    return m_index->count();
+}
+
+int SyncEnginePrivate::maximumConcurrentRequests() const {
+    return m_walker->maximumConcurrentRequests();
+}
+
+void SyncEnginePrivate::setMaximumConcurrentRequests(int maximum) {
+    m_walker->setMaximumConcurrentRequests(maximum);
+}
+
+Session* SyncEnginePrivate::session() const {
+    return m_session;
+}
+
+void SyncEnginePrivate::setSession(Session *session) {
+    if (session != this->session()) {
+        this->stop();
+        m_session = session;
+        this->updateIndexIdentity();
+    }
+}
+
+SyncEngine::Status SyncEnginePrivate::status() const {
+    return m_status;
+}
+
+void SyncEnginePrivate::setStatus(SyncEngine::Status status) {
+    Q_Q(SyncEngine);
+
+    if (status != this->status()) {
+        m_status = status;
+        emit q->statusChanged(status);
+    }
+}
+
+QString SyncEnginePrivate::errorString() const {
+    return m_errorString;
+}
+
+void SyncEnginePrivate::setErrorString(const QString &errorString) {
+    m_errorString = errorString;
+}
+
+void SyncEnginePrivate::sync() {
+    Q_Q(SyncEngine);
+
+    if (this->status() == SyncEngine::Syncing) {
+        return;
+    }
+
+    // The token key of the session may have changed since it was set
+    this->updateIndexIdentity();
+    m_seen.clear();
+    this->setErrorString(QString());
+    this->setStatus(SyncEngine::Syncing);
+
+    m_volume = Files::getVolume(this->volumePath(), this->session(), NetworkSettings::BackgroundPriority);
+    q->connect(m_volume, SIGNAL(ready(Node*)), q, SLOT(_q_onVolumeReady(Node*)));
+}
+
+void SyncEnginePrivate::cancel() {
+    if (this->status() == SyncEngine::Syncing) {
+        this->abortRequests();
+        m_seen.clear();
+        this->setStatus(SyncEngine::Cancelled);
+    }
+}
+
+void SyncEnginePrivate::reset() {
+    this->stop();
+    m_index->clear();
+}
+
+void SyncEnginePrivate::stop() {
+    this->abortRequests();
+    m_seen.clear();
+    m_volumeGeneration = 0;
+    this->setErrorString(QString());
+    this->setStatus(SyncEngine::Idle);
+}
+
+void SyncEnginePrivate::updateIndexIdentity() {
+    // The index discards its nodes only if they were indexed for another volume or account
+    if (!this->volumePath().isEmpty()) {
+        m_index->setVolumePath(this->volumePath());
+    }
+
+    const QString tokenKey = effectiveSession(this->session())->tokenKey();
+
+    if (!tokenKey.isEmpty()) {
+        m_index->setTokenKey(tokenKey);
+    }
+}
+
+void SyncEnginePrivate::abortRequests() {
+    Q_Q(SyncEngine);
+
+    if (m_volume) {
+        m_volume->disconnect(q);
+        m_volume->cancel();
+        m_volume->deleteLater();
+    }
+
+    m_walker->cancel();
+}
+
+void SyncEnginePrivate::finish() {
+    Q_Q(SyncEngine);
+
+    // Indexed nodes that were not listed have been removed from the volume
+    foreach (const QString &resourcePath, m_index->resourcePaths()) {
+        if (!m_seen.contains(resourcePath)) {
+            m_index->remove(resourcePath);
+            emit q->nodeRemoved(resourcePath);
+        }
+    }
+
+    m_seen.clear();
+    m_index->setGeneration(m_volumeGeneration);
+    this->setStatus(SyncEngine::Completed);
+}
+
+void SyncEnginePrivate::fail(const QString &errorString) {
+    this->abortRequests();
+    m_seen.clear();
+    this->setErrorString(errorString);
+    this->setStatus(SyncEngine::Failed);
+}
+
+void SyncEnginePrivate::_q_onVolumeReady(Node *node) {
+    m_volume = 0;
+    node->deleteLater();
+
+    if (node->error() != Node::NoError) {
+        this->fail(node->errorString());
+        return;
+    }
+
+    m_volumeGeneration = node->generation();
+
+    // The volume generation is increased by every change to the volume
+    if ((this->generation() > 0) && (m_volumeGeneration == this->generation())) {
+        this->setStatus(SyncEngine::Completed);
+        return;
+    }
+
+    QString rootPath = node->nodePath();
+
+    if (rootPath.isEmpty()) {
+        // Nodes in the volume have the volume path without the /volumes prefix
+        rootPath = this->volumePath().mid(this->volumePath().indexOf('/', 1));
+    }
+
+    m_walker->setRootPath(rootPath);
+    m_walker->setSession(this->session());
+    m_walker->start();
+}
+
+void SyncEnginePrivate::_q_onNodeFound(Node *node) {
+    Q_Q(SyncEngine);
+
+    const QString resourcePath = node->resourcePath();
+
+    m_seen.insert(resourcePath);
+
+    if (!m_index->contains(resourcePath)) {
+        m_index->insert(node);
+        emit q->nodeAdded(node);
+    }
+    else if ((node->generation() > m_index->generation(resourcePath))
+             || (node->nodeType() != m_index->nodeType(resourcePath))) {
+        m_index->insert(node);
+        emit q->nodeChanged(node);
+    }
+}
+
+void SyncEnginePrivate::_q_onWalkerStatusChanged() {
+    switch (m_walker->status()) {
+    case DirectoryWalker::Completed:
+        this->finish();
+        break;
+    case DirectoryWalker::Failed:
+        this->fail(m_walker->errorString());
+        break;
+    default:
+        break;
+    }
+}
+
+}
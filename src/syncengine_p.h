@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2014 Stuart Howarth <showarth@marxoft.co.uk>
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 3, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef SYNCENGINE_P_H
+#define SYNCENGINE_P_H
+
+#include "syncengine.h"
+#include "directorywalker.h"
+#include <QSet>
+#include <QPointer>
+
+namespace QtUbuntuOne {
+
+class SyncEnginePrivate
+{
+
+public:
+    SyncEnginePrivate(SyncEngine *parent);
+    SyncEnginePrivate(const QString &volumePath, SyncEngine *parent);
+    virtual ~SyncEnginePrivate();
+
+    QString volumePath() const;
+    void setVolumePath(const QString &path);
+
+    int generation() const;
+
+    NodeIndex* nodeIndex() const;
+    void setNodeIndex(NodeIndex *index);
+
+    int count() const;
+
+    int maximumConcurrentRequests() const;
+    void setMaximumConcurrentRequests(int maximum);
+
+    Session* session() const;
+    void setSession(Session *session);
+
+    SyncEngine::Status status() const;
+
+    QString errorString() const;
+
+    void sync();
+    void cancel();
+    void reset();
+
+private:
+    void setStatus(SyncEngine::Status status);
+
+    void setErrorString(const QString &errorString);
+
+    void stop();
+
+    void updateIndexIdentity();
+
+    void abortRequests();
+
+    void finish();
+    void fail(const QString &errorString);
+
+    void _q_onVolumeReady(Node *node);
+
+    void _q_onNodeFound(Node *node);
+    void _q_onWalkerStatusChanged();
+
+    SyncEngine *q_ptr;
+
+    QString m_volumePath;
+
+    int m_volumeGeneration;
+
+    Session *m_session;
+
+    SyncEngine::Status m_status;
+
+    QString m_errorString;
+
+    NodeIndex *m_index;
+
+    QSet<QString> m_seen;
+
+    QPointer<Node> m_volume;
+
+    DirectoryWalker *m_walker;
+
+    Q_DECLARE_PUBLIC(SyncEngine)
+};
+
+}
+
+#endif // SYNCENGINE_P_H
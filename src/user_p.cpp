@@ -152,7 +152,7 @@ void UserPrivate::_q_onReplyFinished() {
             return;
         }
 
-        QString response(m_reply->readAll());
+        QByteArray response(m_reply->readAll());
         QVariantMap result = QtJson::Json::parse(response).toMap();
 
         if (!result.isEmpty()) {
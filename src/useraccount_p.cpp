@@ -16,7 +16,6 @@
  */
 
 #include "useraccount_p.h"
-#include "json.h"
 
 namespace QtUbuntuOne {
 
@@ -40,7 +39,7 @@ UserAccountPrivate::~UserAccountPrivate() {
     }
 }
 
-void UserAccountPrivate::loadAccount(const QVariantMap &account) {
+void UserAccountPrivate::loadAccount(const QtJson::JsonValue &account) {
     Q_Q(UserAccount);
 
     this->setId(account.value("id").toString());
@@ -52,9 +51,9 @@ void UserAccountPrivate::loadAccount(const QVariantMap &account) {
     this->setOpenId(account.value("openid").toString());
     this->setTotalStorage(account.value("total_storage").toLongLong());
     this->setCurrentPlan(account.value("current_plan").toString());
-    this->setDetailedPlans(account.value("detailed_plans").toList());
-    this->setFeatures(account.value("features").toStringList());
-    this->setSubscription(account.value("subscription").toMap());
+    this->setDetailedPlans(account.value("detailed_plans"));
+    this->setFeatures(account.value("features").toVariant().toStringList());
+    this->setSubscription(account.value("subscription"));
 
     emit q->ready(q);
 }
@@ -132,11 +131,16 @@ void UserAccountPrivate::setCurrentPlan(const QString &plan) {
 }
 
 QVariantList UserAccountPrivate::detailedPlans() const {
-    return m_detailedPlans;
+    if ((!m_detailedPlansVariant.isValid()) && (!m_detailedPlans.isUndefined())) {
+        m_detailedPlansVariant = m_detailedPlans.toVariant();
+    }
+
+    return m_detailedPlansVariant.toList();
 }
 
-void UserAccountPrivate::setDetailedPlans(const QVariantList &plans) {
+void UserAccountPrivate::setDetailedPlans(const QtJson::JsonValue &plans) {
     m_detailedPlans = plans;
+    m_detailedPlansVariant = QVariant();
 }
 
 QStringList UserAccountPrivate::features() const {
@@ -148,11 +152,16 @@ void UserAccountPrivate::setFeatures(const QStringList &features) {
 }
 
 QVariantMap UserAccountPrivate::subscription() const {
-    return m_subscription;
+    if ((!m_subscriptionVariant.isValid()) && (!m_subscription.isUndefined())) {
+        m_subscriptionVariant = m_subscription.toVariant();
+    }
+
+    return m_subscriptionVariant.toMap();
 }
 
-void UserAccountPrivate::setSubscription(const QVariantMap &subscription) {
+void UserAccountPrivate::setSubscription(const QtJson::JsonValue &subscription) {
     m_subscription = subscription;
+    m_subscriptionVariant = QVariant();
 }
 
 UserAccount::Error UserAccountPrivate::error() const {
@@ -194,10 +203,10 @@ void UserAccountPrivate::_q_onReplyFinished() {
             return;
         }
 
-        QString response(m_reply->readAll());
-        QVariantMap result = QtJson::Json::parse(response).toMap();
+        QByteArray response(m_reply->readAll());
+        QtJson::JsonValue result = QtJson::JsonDocument::fromJson(response).root();
 
-        if (!result.isEmpty()) {
+        if ((result.isObject()) && (result.size() > 0)) {
             this->loadAccount(result);
         }
         else {
@@ -19,6 +19,7 @@
 #define USERACCOUNT_P_H
 
 #include "useraccount.h"
+#include "json.h"
 #include <QStringList>
 
 namespace QtUbuntuOne {
@@ -30,7 +31,7 @@ public:
     UserAccountPrivate(QNetworkReply *reply, UserAccount *parent);
     virtual ~UserAccountPrivate();
 
-    void loadAccount(const QVariantMap &account);
+    void loadAccount(const QtJson::JsonValue &account);
 
     QString id() const;
 
@@ -80,11 +81,11 @@ private:
 
     void setCurrentPlan(const QString &plan);
 
-    void setDetailedPlans(const QVariantList &plans);
+    void setDetailedPlans(const QtJson::JsonValue &plans);
 
     void setFeatures(const QStringList &features);
 
-    void setSubscription(const QVariantMap &subscription);
+    void setSubscription(const QtJson::JsonValue &subscription);
 
     void setError(UserAccount::Error error);
     void setErrorString(const QString &errorString);
@@ -113,11 +114,13 @@ private:
 
     QString m_currentPlan;
 
-    QVariantList m_detailedPlans;
+    QtJson::JsonValue m_detailedPlans;
+    mutable QVariant m_detailedPlansVariant;
 
     QStringList m_features;
 
-    QVariantMap m_subscription;
+    QtJson::JsonValue m_subscription;
+    mutable QVariant m_subscriptionVariant;
 
     UserAccount::Error m_error;
     QString m_errorString;